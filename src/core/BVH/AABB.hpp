@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <cstdint>
+#include <limits>
 
 namespace dk {
 
@@ -95,6 +96,14 @@ inline AABB merge_aabbs(const AABB& a, const AABB& b)
     return merged;
 }
 
+// 辅助函数：两个 AABB 是否相交（含贴边）
+inline bool overlap_aabbs(const AABB& a, const AABB& b)
+{
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
 // 预处理步骤：为每个三角形计算 AABB 和中心点
 inline void preprocess_triangles(
     const std::vector<glm::vec3>& vertices,
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include "AABB.hpp"
+
+namespace dk {
+
+/**
+ * 通用的 AABB 层次包围盒.
+ * 自顶向下按质心包围盒的最长轴做中位数划分；节点连续存放，
+ * 内部节点的两个孩子相邻且下标总大于父节点，所以 refit 只需倒序扫一遍节点。
+ * 图元位置变化但拓扑不变时（布料、移动的碰撞体）用 refit 代替重建。
+ */
+class BVH
+{
+public:
+    struct Node
+    {
+        AABB aabb;
+        int  first = 0; // 叶子：图元在 primitives() 中的起点；内部节点：左孩子下标，右孩子为 first + 1
+        int  count = 0; // 叶子的图元数，0 表示内部节点
+
+        bool leaf() const { return count > 0; }
+    };
+
+    void build(std::span<const AABB> boxes, int leaf_size = 4)
+    {
+        nodes_.clear();
+        prims_.resize(boxes.size());
+        leaf_boxes_.resize(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) prims_[i] = static_cast<int>(i);
+        if (boxes.empty()) return;
+
+        std::vector<glm::vec3> centroid(boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) centroid[i] = boxes[i].center();
+
+        nodes_.reserve(2 * boxes.size() / std::max(leaf_size, 1) + 1);
+        nodes_.push_back({});
+
+        struct Task
+        {
+            int node, begin, end;
+        };
+        std::vector<Task> stack{{0, 0, static_cast<int>(boxes.size())}};
+        while (!stack.empty())
+        {
+            const Task t = stack.back();
+            stack.pop_back();
+
+            AABB box, cbox;
+            for (int i = t.begin; i < t.end; ++i)
+            {
+                box.expand(boxes[prims_[i]]);
+                cbox.expand(centroid[prims_[i]]);
+            }
+            nodes_[t.node].aabb = box;
+
+            const glm::vec3 ext = cbox.max - cbox.min;
+            if (t.end - t.begin <= leaf_size || (ext.x <= 0.0f && ext.y <= 0.0f && ext.z <= 0.0f))
+            {
+                nodes_[t.node].first = t.begin;
+                nodes_[t.node].count = t.end - t.begin;
+                for (int i = t.begin; i < t.end; ++i) leaf_boxes_[i] = boxes[prims_[i]];
+                continue;
+            }
+
+            const int axis = ext.x >= ext.y && ext.x >= ext.z ? 0 : (ext.y >= ext.z ? 1 : 2);
+            const int mid  = (t.begin + t.end) / 2;
+            std::nth_element(prims_.begin() + t.begin, prims_.begin() + mid, prims_.begin() + t.end,
+                             [&](int a, int b) { return centroid[a][axis] < centroid[b][axis]; });
+
+            const int left       = static_cast<int>(nodes_.size());
+            nodes_[t.node].first = left;
+            nodes_[t.node].count = 0;
+            nodes_.push_back({});
+            nodes_.push_back({});
+            stack.push_back({left, t.begin, mid});
+            stack.push_back({left + 1, mid, t.end});
+        }
+    }
+
+    // 图元包围盒更新后自底向上重算节点包围盒，树的拓扑不变
+    void refit(std::span<const AABB> boxes)
+    {
+        for (int n = static_cast<int>(nodes_.size()) - 1; n >= 0; --n)
+        {
+            Node& node = nodes_[n];
+            AABB  box;
+            if (node.leaf())
+            {
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    leaf_boxes_[i] = boxes[prims_[i]];
+                    box.expand(leaf_boxes_[i]);
+                }
+            }
+            else
+            {
+                box = merge_aabbs(nodes_[node.first].aabb, nodes_[node.first + 1].aabb);
+            }
+            node.aabb = box;
+        }
+    }
+
+    // 对每个包围盒与 box 相交的图元调用 fn(prim)
+    template <class Fn>
+    void query(const AABB& box, Fn&& fn) const
+    {
+        if (nodes_.empty()) return;
+        int stack[64];
+        int top      = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const Node& node = nodes_[stack[--top]];
+            if (!overlap_aabbs(node.aabb, box)) continue;
+            if (node.leaf())
+            {
+                for (int i = node.first; i < node.first + node.count; ++i)
+                {
+                    if (overlap_aabbs(leaf_boxes_[i], box)) fn(prims_[i]);
+                }
+            }
+            else
+            {
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+            }
+        }
+    }
+
+    bool                     empty() const { return nodes_.empty(); }
+    AABB                     bounds() const { return nodes_.empty() ? AABB{} : nodes_[0].aabb; }
+    const std::vector<Node>& nodes() const { return nodes_; }
+    const std::vector<int>&  primitives() const { return prims_; }
+
+private:
+    std::vector<Node> nodes_;
+    std::vector<int>  prims_;      // 叶子引用的图元下标，按叶子顺序排列
+    std::vector<AABB> leaf_boxes_; // 与 prims_ 对齐的图元包围盒副本，查询时不再回头访问调用方的数组
+};
+}
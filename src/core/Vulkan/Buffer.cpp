@@ -41,13 +41,7 @@ void BufferResource::update(const void* src_data, vk::DeviceSize size, vk::Devic
     uint8_t* dst = static_cast<uint8_t*>(map()) + offset;
 
     std::memcpy(dst, src_data, size);
-
-    if (!_host_coherent)
-    {
-        VkDeviceSize start = offset & ~(_atom_size - 1);
-        VkDeviceSize end   = (offset + size + _atom_size - 1) & ~(_atom_size - 1);
-        vmaFlushAllocation(_context->getVmaAllocator(), _allocation, start, end - start);
-    }
+    flush(size, offset);
 }
 
 BufferResource::~BufferResource()
@@ -82,6 +82,17 @@ public:
     // CPU→GPU 写入（会自动 flush 非 coherent）
     void update(const void* src_data, vk::DeviceSize size, vk::DeviceSize offset = 0);
 
+    // 直接写映射内存（map()/data()）之后调用，非 coherent 内存需要 flush 才对 GPU 可见
+    void flush(VkDeviceSize size, VkDeviceSize offset = 0)
+    {
+        if (!_host_coherent)
+        {
+            VkDeviceSize start = offset & ~(_atom_size - 1);
+            VkDeviceSize end   = (offset + size + _atom_size - 1) & ~(_atom_size - 1);
+            vmaFlushAllocation(_context->getVmaAllocator(), _allocation, start, end - start);
+        }
+    }
+
     // GPU→CPU 读前的 invalidate 同步GPU的修改
     void invalidate(VkDeviceSize size, VkDeviceSize offset = 0)
     {
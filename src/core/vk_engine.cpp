@@ -11,6 +11,7 @@
 #include "imgui_impl_sdl3.h"
 #include "imgui_impl_vulkan.h"
 #include "imgui_freetype.h"
+#include <implot.h>
 
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -25,9 +26,11 @@
 #include "force/SpringForce.h"
 #include "solver/EulerSolver.h"
 #include "World.h"
+#include "PhysicsStats.h"
 #include "color/UniformColorizer.h"
 #include "data/MACInit.h"
 #include "fluid/FluidSystem.h"
+#include "collider/SdfCollider.h"
 #include "force/DampingForce.h"
 #include "render graph/RenderGraph.h"
 #include "render graph/Resource.h"
@@ -184,9 +187,10 @@ void VulkanEngine::init()
     //);
 
     //point_cloud_renderer->getPointData() = makeRandomPointCloudSphere(10000, {0, 0, 0}, 100, false);
-    physic_world->getSystemAs<SpringMassSystem>("spring")->getRenderData(point_cloud_renderer->getPointData());
-    point_cloud_renderer->updatePoints();
+    point_cloud_renderer->commitPoints(static_cast<uint32_t>(
+        physic_world->getSystemAs<SpringMassSystem>("spring")->writeRenderData(point_cloud_renderer->mappedPoints())));
     m_spring_renderer->updateSprings(sm_sys->getParticleData(), sm_sys->getTopology_mut());
+    update_fluid_surface();
     fmt::print("build render data\n");
 
     init_imgui();
@@ -462,12 +466,12 @@ void VulkanEngine::draw_main(VkCommandBuffer cmd)
     renderInfo.pColorAttachments    = &color_attachment;
     renderInfo.pDepthAttachment     = &depth_attachment;
 
-    physic_world->getSystemAs<SpringMassSystem>("spring")->getRenderData(point_cloud_renderer->getPointData());
     auto sm_sys = physic_world->getSystemAs<SpringMassSystem>("spring");
     auto fluid  = physic_world->getSystemAs<FluidSystem>("fluid");
 
     //translate_points(point_cloud_renderer->getPointData(), { 0.1, 0, 0, 0 });
-    point_cloud_renderer->updatePoints();
+    // 位置和颜色直接写进点云的映射 SSBO，不经过 CPU 端的中间数组
+    point_cloud_renderer->commitPoints(static_cast<uint32_t>(sm_sys->writeRenderData(point_cloud_renderer->mappedPoints())));
 
     m_spring_renderer->updateSprings(sm_sys->getParticleData(), sm_sys->getTopology_mut());
 
@@ -825,6 +829,8 @@ void VulkanEngine::run()
         ImGui::End();
         // 资源树
         hierarchy_panel.onGui();
+        // 物理统计
+        physics_stats_panel.onGui(PhysicsStats::instance());
         // 顶部工具栏
         if (ImGui::BeginMainMenuBar())
         {
@@ -876,9 +882,24 @@ void VulkanEngine::run()
         {
             queued += std::max(0, static_cast<int>(std::round(secs / h)));
         }
+
+        if (auto* fluid = physic_world->getSystemAs<FluidSystem>("fluid"))
+        {
+            auto params = fluid->solver().params();
+            if (ImGui::Checkbox("Fluid active tiles", &params.track_active_tiles)) fluid->solver().setParams(params);
+            const auto& fs = fluid->solver().stats();
+            ImGui::Text("active %lld / %lld tiles (%.1f%%)", static_cast<long long>(fs.active_tiles),
+                        static_cast<long long>(fs.total_tiles), fs.active_fraction * 100.0f);
+            if (ImGui::SliderFloat("Fluid surface iso", &_fluid_surface_iso, 0.05f, 0.95f)) update_fluid_surface();
+        }
+        if (auto* selected = hierarchy_panel.selectedNode(); selected && selected->getComponent<MeshInstanceComponent>())
+        {
+            if (ImGui::Button("Add mesh collider")) add_mesh_collider(*selected);
+        }
         ImGui::End();
 
         // --- 每帧更新 ---
+        bool stepped = false;
         if (sim_run)
         {
             // 正常实时推进
@@ -886,6 +907,7 @@ void VulkanEngine::run()
             {
                 physic_world->tick(physic_world->settings().fixed_dt);  // 你的帧间隔
             }
+            stepped = step_N > 0;
         }
         else
         {
@@ -894,8 +916,10 @@ void VulkanEngine::run()
             {
                 physic_world->tick(h);     // 每次推进正好一个 fixed step
                 queued--;
+                stepped = true;
             }
         }
+        if (stepped) update_fluid_surface();
 
         ImGui::Render();
 
@@ -912,6 +936,59 @@ void VulkanEngine::run()
     }
 }
 
+void VulkanEngine::update_fluid_surface()
+{
+    auto* fluid = physic_world->getSystemAs<FluidSystem>("fluid");
+    if (!fluid || !_render_system)
+    {
+        return;
+    }
+    fluid->extractSurface(_fluid_surface_iso, _fluid_surface);
+    _render_system->setFluidSurface(_fluid_surface);
+}
+
+void VulkanEngine::add_mesh_collider(const SceneNode& node)
+{
+    auto* mesh_component = node.getComponent<MeshInstanceComponent>();
+    if (!mesh_component || !_cpu_loader || !_render_system)
+    {
+        return;
+    }
+    auto cpu_mesh = _cpu_loader->load<MeshData>(mesh_component->mesh_asset);
+    if (!cpu_mesh || cpu_mesh->indices.size() < 3)
+    {
+        return;
+    }
+
+    // SDF 建在网格局部空间，缓存只随网格内容变化；节点的世界变换交给 SdfCollider 在查询时应用
+    glm::mat4   world = glm::mat4(1.0f);
+    const auto& render_world = _render_system->getRenderWorld();
+    if (const auto index = render_world.findProxyIndex(node.id))
+    {
+        world = render_world.proxies()[*index].world_transform;
+    }
+    AABB bounds;
+    for (const auto& p : cpu_mesh->positions)
+    {
+        bounds.expand(p);
+    }
+
+    // 最长边约 64 格
+    SdfParams params;
+    const glm::vec3 extent = bounds.max - bounds.min;
+    params.h               = std::max(std::max({extent.x, extent.y, extent.z}) / 64.0f, 1e-4f);
+
+    bool       cached   = false;
+    const auto raw_path = _cpu_loader->rawPath(mesh_component->mesh_asset);
+    auto       sdf      = raw_path.empty() ? buildSignedDistanceField(cpu_mesh->positions, cpu_mesh->indices, params)
+                                           : loadOrBuildMeshSdf(*cpu_mesh, raw_path, params, &cached);
+
+    const std::string name = "mesh:" + node.name;
+    physic_world->removeCollider(name);
+    physic_world->addCollider<SdfCollider>(name, std::move(sdf), world);
+    fmt::print("mesh collider '{}' ({})\n", name, cached ? "cached" : "built");
+}
+
 void VulkanEngine::update_scene()
 {
     mainCamera.update();
@@ -1146,6 +1223,7 @@ void VulkanEngine::init_imgui()
 
     // this initializes the core structures of imgui
     ImGui::CreateContext();
+    ImPlot::CreateContext();
 
     ImGuiIO& io = ImGui::GetIO();
     //io.FontGlobalScale = _context->getWindow()->get_dpi_factor(); // 放大字体
@@ -1189,6 +1267,7 @@ void VulkanEngine::init_imgui()
     _mainDeletionQueue.push_function([=]()
     {
         ImGui_ImplVulkan_Shutdown();
+        ImPlot::DestroyContext();
         vkDestroyDescriptorPool(_context->getDevice(), imguiPool, nullptr);
     });
 }
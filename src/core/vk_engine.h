@@ -15,6 +15,7 @@
 #include "Scene/Node.h"
 #include "Vulkan/Context.h"
 #include "HierarchyPanel.h"
+#include "PhysicsStatsPanel.h"
 #include "input/InputBackend.h"
 #include "input/InputContext.h"
 #include "input/InputRouter.h"
@@ -30,6 +31,7 @@
 #include "render graph/Resource.h"
 #include "Vulkan/CommandPool.h"
 #include "Vulkan/CommandBuffer.h"
+#include "resource/cpu/MeshLoader.h"
 #include "resource/cpu/ResourceCache.h"
 
 namespace dk {
@@ -124,6 +126,7 @@ public:
     bool        _rotate_gizmo_enabled{true};
 
     HierarchyPanel hierarchy_panel;
+    PhysicsStatsPanel physics_stats_panel;
 
     std::shared_ptr<PointCloudRenderer> point_cloud_renderer;
     std::shared_ptr<SpringRenderer> m_spring_renderer;
@@ -136,6 +139,8 @@ public:
     std::shared_ptr<SceneSystem> m_scene_system;
 
     std::unique_ptr<World> physic_world;
+    MeshData               _fluid_surface; // 流体染料等值面，缓冲在帧间复用
+    float                  _fluid_surface_iso{0.5f};
 
     std::unique_ptr<render::RenderSystem> _render_system;
     std::unique_ptr<ResourceLoader>       _cpu_loader;
@@ -162,6 +167,12 @@ public:
 
     void update_scene();
 
+    // 物理推进之后重新提取流体表面并交给 RenderSystem
+    void update_fluid_surface();
+
+    // 用节点的网格（按世界变换烘焙）建 SDF 碰撞体并注册到物理世界，SDF 缓存在 raw 网格旁边
+    void add_mesh_collider(const SceneNode& node);
+
     FrameData& get_current_frame();
     FrameData& get_frame(const int id);
     FrameData& get_last_frame();
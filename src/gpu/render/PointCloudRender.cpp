@@ -26,6 +26,24 @@ void PointCloudRenderer::updatePoints()
     }
 }
 
+std::span<PointData> PointCloudRenderer::mappedPoints()
+{
+    return {static_cast<PointData*>(_point_cloud_ssbo->map()), _max_point_count};
+}
+
+void PointCloudRenderer::commitPoints(uint32_t count)
+{
+    if (count > _max_point_count)
+    {
+        throw std::runtime_error("Exceeded maximum point cloud capacity.");
+    }
+    _point_count = count;
+    if (_point_count > 0)
+    {
+        _point_cloud_ssbo->flush(sizeof(PointData) * _point_count);
+    }
+}
+
 
 // --- 初始化和绘制逻辑的核心变化在这里 ---
 
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <memory>
+#include <span>
 #include <execution>
 #include "glm/glm.hpp"
 
@@ -115,6 +116,11 @@ public:
 
     std::vector<PointData>& getPointData() { return _point_data; }
 
+    // 零拷贝路径：物理系统把点直接写进持久映射的 SSBO（ISystem::writeRenderData），
+    // 再用 commitPoints 提交写入的点数；不经过 _point_data。draw 前会等设备空闲，所以单缓冲即可
+    std::span<PointData> mappedPoints();
+    void                 commitPoints(uint32_t count);
+
     // 清理所有资源
     void cleanup();
 
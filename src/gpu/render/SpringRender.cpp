@@ -3,6 +3,7 @@
 #include <stdexcept>
 #include <filesystem>
 
+#include "Parallel.h"
 #include "Vulkan/ShaderModule.h"
 
 namespace dk {
@@ -35,16 +36,19 @@ void SpringRenderer::updateSprings(const ParticleData& particle_data, const Spri
     // 1. 更新粒子数据 SSBO
     if (_particle_count > 0)
     {
-        // 从物理系统的 SoA (vec3) 格式转换为渲染器需要的 AoS (vec4) 格式
-        _cpu_particle_buffer.resize(_particle_count);
-        for (uint32_t i = 0; i < _particle_count; ++i)
+        // 从物理系统的 SoA (vec3) 格式转换为渲染器需要的 AoS (vec4) 格式，直接写进映射的 SSBO
+        auto* dst = static_cast<GPUParticle*>(_particle_data_ssbo->map());
+        parallelForSlabs(0, _particle_count, [&](i64 b, i64 e)
         {
-            _cpu_particle_buffer[i] = {
-                glm::vec4(particle_data.position[i], 1.0f),
-                particle_data.color[i]
-            };
-        }
-        _particle_data_ssbo->update(_cpu_particle_buffer.data(), sizeof(GPUParticle) * _particle_count);
+            for (i64 i = b; i < e; ++i)
+            {
+                dst[i] = {
+                    glm::vec4(particle_data.position[i], 1.0f),
+                    particle_data.color[i]
+                };
+            }
+        });
+        _particle_data_ssbo->flush(sizeof(GPUParticle) * _particle_count);
     }
 
     // 2. 更新弹簧索引 SSBO
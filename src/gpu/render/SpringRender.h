@@ -74,7 +74,6 @@ namespace dk {
         uint32_t _max_spring_count = 0;
 
         // CPU 端的临时转换缓冲区
-        std::vector<GPUParticle> _cpu_particle_buffer;
         std::vector<SpringIndex> _cpu_index_buffer;
 
         // GPU 资源
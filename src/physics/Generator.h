@@ -2,6 +2,7 @@
 #pragma once
 
 #include "MassSpring.h"
+#include "Parallel.h"
 
 namespace dk {
 // 使用属性结构体 (Properties Struct) 来传递参数，这比长长的函数参数列表更清晰
@@ -48,19 +49,23 @@ inline void create_cloth(SpringMassSystem& system, const ClothProperties& props)
     const int    grid_width  = props.width_segments + 1;
     const int    grid_height = props.height_segments + 1;
 
-    // 1. 添加粒子
-    for (int y = 0; y < grid_height; ++y)
+    // 1. 添加粒子：所有数组一次扩容，按行并行填写
+    const ParticleBuilder batch = particles.addParticles(static_cast<size_t>(grid_width) * grid_height, props.mass_per_particle);
+    parallelForSlabs(0, grid_height, [&](i64 y0, i64 y1)
     {
-        for (int x = 0; x < grid_width; ++x)
+        for (int y = static_cast<int>(y0); y < static_cast<int>(y1); ++y)
         {
-            vec3 pos = props.start_position + vec3(
-                           static_cast<float>(x) / static_cast<float>(props.width_segments) * props.width,
-                           0.0f,
-                           static_cast<float>(y) / static_cast<float>(props.height_segments) * -props.height // Z轴负方向
-                       );
-            particles.addParticle(pos, props.mass_per_particle);
+            for (int x = 0; x < grid_width; ++x)
+            {
+                vec3 pos = props.start_position + vec3(
+                               static_cast<float>(x) / static_cast<float>(props.width_segments) * props.width,
+                               0.0f,
+                               static_cast<float>(y) / static_cast<float>(props.height_segments) * -props.height // Z轴负方向
+                           );
+                batch.place(static_cast<size_t>(grid_width) * y + x, pos);
+            }
         }
-    }
+    });
 
     // 用于根据网格坐标获取粒子索引的辅助函数
     auto get_index = [&](const int x, const int y)
@@ -69,46 +74,73 @@ inline void create_cloth(SpringMassSystem& system, const ClothProperties& props)
     };
 
     // 2. 添加弹簧
-    for (int y = 0; y < grid_height; ++y)
+    // 结构弹簧 (Structural)：每行 width_segments 根水平弹簧，除最后一行外再加 grid_width 根垂直弹簧。
+    // 顺序与逐个添加时相同（按格点先水平后垂直），所以每行的起始位置是固定的，各行可以并行写
+    const float       rest_x         = props.width / static_cast<float>(props.width_segments);
+    const float       rest_y         = props.height / static_cast<float>(props.height_segments);
+    const size_t      springs_in_row = static_cast<size_t>(props.width_segments) + grid_width;
+    const SpringBuilder springs = topology.addSprings(springs_in_row * props.height_segments + props.width_segments);
+    parallelForSlabs(0, grid_height, [&](i64 y0, i64 y1)
     {
-        for (int x = 0; x < grid_width; ++x)
+        for (int y = static_cast<int>(y0); y < static_cast<int>(y1); ++y)
         {
-            // 结构弹簧 (Structural)
-            if (x < props.width_segments)
-            { // 水平
-                topology.addSpring(get_index(x, y), get_index(x + 1, y), props.stiffness_structural,
-                                   props.width / static_cast<float>(props.width_segments));
+            size_t k = springs_in_row * y;
+            for (int x = 0; x < grid_width; ++x)
+            {
+                if (x < props.width_segments) // 水平
+                    springs.set(k++, get_index(x, y), get_index(x + 1, y), props.stiffness_structural, rest_x);
+                if (y < props.height_segments) // 垂直
+                    springs.set(k++, get_index(x, y), get_index(x, y + 1), props.stiffness_structural, rest_y);
             }
-            if (y < props.height_segments)
-            { // 垂直
-                topology.addSpring(get_index(x, y), get_index(x, y + 1), props.stiffness_structural,
-                                   props.height / static_cast<float>(props.height_segments));
+        }
+    });
+    //for (int y = 0; y < grid_height; ++y)
+    //{
+    //    for (int x = 0; x < grid_width; ++x)
+    //    {
+    //        //// 剪切弹簧 (Shear)
+    //        //if (x < props.width_segments && y < props.height_segments)
+    //        //{
+    //        //    const float diag_length = length(vec2(props.width / static_cast<float>(props.width_segments),
+    //        //                                          props.height / static_cast<float>(props.height_segments)));
+    //        //    topology.addSpring(get_index(x, y), get_index(x + 1, y + 1), props.stiffness_shear, diag_length);
+    //        //    topology.addSpring(get_index(x + 1, y), get_index(x, y + 1), props.stiffness_shear, diag_length);
+    //        //}
+
+    //        //// 弯曲弹簧 (Bend) - 这是让布料抗弯曲的关键
+    //        //if (x < props.width_segments - 1)
+    //        //{
+    //        //    topology.addSpring(get_index(x, y), get_index(x + 2, y), props.stiffness_bend,
+    //        //                       2.0f * props.width / static_cast<float>(props.width_segments));
+    //        //}
+    //        //if (y < props.height_segments - 1)
+    //        //{
+    //        //    topology.addSpring(get_index(x, y), get_index(x, y + 2), props.stiffness_bend,
+    //        //                       2.0f * props.height / static_cast<float>(props.height_segments));
+    //        //}
+    //    }
+    //}
+
+    // 3. 三角面片（每个格子两片），供自碰撞使用
+    const std::span<uint32_t> triangles = system.getTriangles_mut().addTriangles(2 * static_cast<size_t>(props.width_segments) * props.height_segments);
+    parallelForSlabs(0, props.height_segments, [&](i64 y0, i64 y1)
+    {
+        for (int y = static_cast<int>(y0); y < static_cast<int>(y1); ++y)
+        {
+            for (int x = 0; x < props.width_segments; ++x)
+            {
+                uint32_t* t = &triangles[6 * (static_cast<size_t>(props.width_segments) * y + x)];
+                t[0]        = static_cast<uint32_t>(get_index(x, y));
+                t[1]        = static_cast<uint32_t>(get_index(x + 1, y));
+                t[2]        = static_cast<uint32_t>(get_index(x, y + 1));
+                t[3]        = static_cast<uint32_t>(get_index(x + 1, y));
+                t[4]        = static_cast<uint32_t>(get_index(x + 1, y + 1));
+                t[5]        = static_cast<uint32_t>(get_index(x, y + 1));
             }
-
-            //// 剪切弹簧 (Shear)
-            //if (x < props.width_segments && y < props.height_segments)
-            //{
-            //    const float diag_length = length(vec2(props.width / static_cast<float>(props.width_segments),
-            //                                          props.height / static_cast<float>(props.height_segments)));
-            //    topology.addSpring(get_index(x, y), get_index(x + 1, y + 1), props.stiffness_shear, diag_length);
-            //    topology.addSpring(get_index(x + 1, y), get_index(x, y + 1), props.stiffness_shear, diag_length);
-            //}
-
-            //// 弯曲弹簧 (Bend) - 这是让布料抗弯曲的关键
-            //if (x < props.width_segments - 1)
-            //{
-            //    topology.addSpring(get_index(x, y), get_index(x + 2, y), props.stiffness_bend,
-            //                       2.0f * props.width / static_cast<float>(props.width_segments));
-            //}
-            //if (y < props.height_segments - 1)
-            //{
-            //    topology.addSpring(get_index(x, y), get_index(x, y + 2), props.stiffness_bend,
-            //                       2.0f * props.height / static_cast<float>(props.height_segments));
-            //}
         }
-    }
+    });
 
-    // 3. 固定点 (Pinning)
+    // 4. 固定点 (Pinning)
     if (props.pin_top_corners)
     {
         //for (int i = 0; i <=  props.width_segments; ++i)
@@ -143,18 +175,20 @@ inline void create_rope(SpringMassSystem& system, const RopeProperties& props)
     const float segment_length = total_length / static_cast<float>(props.num_segments);
 
     // 1. 添加粒子
-    for (int i = 0; i < num_particles; ++i)
+    const ParticleBuilder batch = particles.addParticles(num_particles, props.mass_per_particle);
+    parallelForSlabs(0, num_particles, [&](i64 b, i64 e)
     {
-        vec3 pos = props.start_position + (direction / total_length) * (segment_length * i);
-
-        particles.addParticle(pos, props.mass_per_particle);
-    }
+        for (i64 i = b; i < e; ++i)
+            batch.place(i, props.start_position + (direction / total_length) * (segment_length * static_cast<float>(i)));
+    });
 
     // 2. 添加弹簧
-    for (int i = 0; i < props.num_segments; ++i)
+    const SpringBuilder springs = topology.addSprings(props.num_segments);
+    parallelForSlabs(0, props.num_segments, [&](i64 b, i64 e)
     {
-        topology.addSpring(base_index + i, base_index + i + 1, props.stiffness, segment_length);
-    }
+        for (i64 i = b; i < e; ++i)
+            springs.set(i, base_index + i, base_index + i + 1, props.stiffness, segment_length);
+    });
 
     // 3. 固定点
     if (props.pin_start)
@@ -1,11 +1,21 @@
 #include "MassSpring.h"
+#include <algorithm>
+#include <cstddef>
 #include <execution>
 #include <tracy/Tracy.hpp>
 
+#include "Parallel.h"
+
 void dk::SpringMassSystem::step(float dt)
 {
     ZoneScopedN("spring mass system one step");
 
+    // 0. 发射新粒子
+    for (auto& emitter : _emitters)
+    {
+        emitter->emit(_pool, *_data, dt);
+    }
+
     // 1. 清除旧力
     std::fill(std::execution::par_unseq, _data->force.begin(), _data->force.end(), glm::vec3(0.0f));
 
@@ -15,8 +25,58 @@ void dk::SpringMassSystem::step(float dt)
         forceGen->applyForce(*_data);
     }
 
+    // 受到外力或被移动过的休眠岛先唤醒（内置力跳过休眠质点）；粒子生灭只影响池报告的那些岛
+    _sleep.wakeDisturbed(*_data, _topology, _pool.changes());
+    _pool.clearChanges();
+
     // 3. 使用自己的求解器进行积分
-    auto state = ParticleSystemState(*_data, _topology);
+    auto state = ParticleSystemState(*_data, _topology, &_triangles);
     _solver->solve(state, dt);
+
+    // 4. 动能持续很低的岛进入休眠
+    _sleep.update(*_data);
+
+    // 5. 回收粒子，删除连着死质点的弹簧，死槽位多时压实
+    if (!_emitters.empty() || !_killers.empty() || _pool.deadCount() > 0)
+    {
+        _pool.advanceAges(dt);
+        for (auto& killer : _killers)
+        {
+            killer->kill(_pool, *_data, dt);
+        }
+        _pool.maintain(*_data, &_topology, &_triangles);
+    }
 }
 
+
+size_t dk::SpringMassSystem::writeRenderData(std::span<PointData> out) const
+{
+    ZoneScopedN("spring mass system render extraction");
+
+    const size_t        count = std::min(out.size(), _data->size());
+    const ParticleData& data  = *_data;
+    if (_colorizer && count > 0)
+    {
+        // 着色按块直接写进 out 的 color 字段，同一块随即补上位置并把颜色写回 ParticleData
+        static_assert(sizeof(PointData) % sizeof(vec4) == 0 && offsetof(PointData, color) % sizeof(vec4) == 0);
+        const ColorOut colors{&out.data()->color, sizeof(PointData) / sizeof(vec4)};
+        _colorizer->run(data, count, colors, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                out[i].position = vec4(data.position[i], 1.0f);
+                _data->color[i] = out[i].color;
+            }
+        });
+        return count;
+    }
+
+    parallelForSlabs(0, static_cast<i64>(count), [&](i64 b, i64 e)
+    {
+        for (i64 i = b; i < e; ++i)
+        {
+            out[i] = {vec4(data.position[i], 1.0f), data.color[i]};
+        }
+    });
+    return count;
+}
@@ -10,6 +10,10 @@
 #include "force/IForce.h"
 #include "solver/ISolver.h"
 #include "data/Particle.h"
+#include "data/ParticlePool.h"
+#include "data/SleepIslands.h"
+#include "emit/Emitter.h"
+#include "emit/Killer.h"
 
 namespace dk {
 class SpringMassSystem : public ISystem
@@ -28,6 +32,17 @@ public:
         _force.push_back(std::move(force));
     }
 
+    // 粒子的生成与回收都经过 _pool，槽位复用、定期压实
+    void addEmitter(std::unique_ptr<IEmitter> emitter)
+    {
+        _emitters.push_back(std::move(emitter));
+    }
+
+    void addKiller(std::unique_ptr<IKiller> killer)
+    {
+        _killers.push_back(std::move(killer));
+    }
+
     void setColorizer(std::unique_ptr<IParticleColorizer> colorizer)
     {
         _colorizer = std::move(colorizer);
@@ -39,33 +54,34 @@ public:
     // 提供对数据的访问
     ParticleData&       getParticles_mut() { return *_data; }
     Spring&             getTopology_mut() { return _topology; }
+    TriangleTopology&   getTriangles_mut() { return _triangles; }
+    SleepIslands&       getSleepIslands_mut() { return _sleep; }
+    ParticlePool&       getPool_mut() { return _pool; }
     const ParticleData& getParticleData() const { return *_data; }
+    ParticleData*       particleData() override { return _data.get(); }
 
     void getRenderData(std::vector<PointData>& out_data) const override
     {
-        if (_colorizer)
-        {
-            _colorizer->colorize(*_data);
-        }
-
-        const size_t count = _data->size();
-
         // 清空并预留空间，确保只有在需要时才发生一次内存分配
         out_data.clear();
-        out_data.resize(count);
-
-        for (size_t i = 0; i < count; ++i)
-        {
-            out_data[i].position = vec4(_data->position[i], 1.0f);
-            out_data[i].color    = _data->color[i];
-        }
+        out_data.resize(renderPointCount());
+        writeRenderData(out_data);
     }
 
+    size_t renderPointCount() const override { return _data->size(); }
+    // 位置和颜色一遍并行写完；颜色同时写回 ParticleData::color，供弹簧渲染等其他使用者读取
+    size_t writeRenderData(std::span<PointData> out) const override;
+
 private:
-    std::unique_ptr<ParticleData>        _data;
-    Spring                               _topology;
-    std::vector<std::unique_ptr<IForce>> _force;
-    std::unique_ptr<ISolver>             _solver;
-    std::unique_ptr<IParticleColorizer>  _colorizer;
+    std::unique_ptr<ParticleData>          _data;
+    Spring                                 _topology;
+    TriangleTopology                       _triangles;
+    SleepIslands                           _sleep;
+    ParticlePool                           _pool;
+    std::vector<std::unique_ptr<IEmitter>> _emitters;
+    std::vector<std::unique_ptr<IKiller>>  _killers;
+    std::vector<std::unique_ptr<IForce>>   _force;
+    std::unique_ptr<ISolver>               _solver;
+    std::unique_ptr<IParticleColorizer>    _colorizer;
 };
 }
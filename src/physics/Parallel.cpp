@@ -0,0 +1,92 @@
+#include "Parallel.h"
+#include <algorithm>
+
+namespace dk {
+namespace {
+// 标记当前线程是否正在执行某个 slab（用于把嵌套调用降级为串行）
+thread_local bool t_in_slab = false;
+}
+
+SlabPool& SlabPool::instance()
+{
+    static SlabPool pool;
+    return pool;
+}
+
+SlabPool::SlabPool(unsigned threads)
+{
+    const unsigned n = std::max(1u, threads);
+    _workers.reserve(n - 1);
+    for (unsigned t = 1; t < n; ++t)
+    {
+        _workers.emplace_back([this, t] { workerLoop(static_cast<int>(t)); });
+    }
+}
+
+SlabPool::~SlabPool()
+{
+    {
+        std::lock_guard lock(_mutex);
+        _stop = true;
+    }
+    _start_cv.notify_all();
+    for (auto& w : _workers) w.join();
+}
+
+void SlabPool::run(i64 begin, i64 end, const std::function<void(i64, i64)>& fn)
+{
+    if (end <= begin) return;
+
+    // 嵌套、单线程或已有其它线程在用池：直接在当前线程完成
+    std::unique_lock run_lock(_run_mutex, std::defer_lock);
+    if (t_in_slab || _workers.empty() || !run_lock.try_lock())
+    {
+        fn(begin, end);
+        return;
+    }
+
+    {
+        std::lock_guard lock(_mutex);
+        _job     = &fn;
+        _begin   = begin;
+        _end     = end;
+        _pending = static_cast<int>(_workers.size());
+        ++_generation;
+    }
+    _start_cv.notify_all();
+
+    // 调用线程负责第 0 段
+    i64 b, e;
+    segment(begin, end, 0, b, e);
+    t_in_slab = true;
+    if (b < e) fn(b, e);
+    t_in_slab = false;
+
+    std::unique_lock lock(_mutex);
+    _done_cv.wait(lock, [this] { return _pending == 0; });
+    _job = nullptr;
+}
+
+void SlabPool::workerLoop(int t)
+{
+    t_in_slab          = true;
+    std::uint64_t seen = 0;
+    for (;;)
+    {
+        std::unique_lock lock(_mutex);
+        _start_cv.wait(lock, [&] { return _stop || _generation != seen; });
+        if (_stop) return;
+        seen = _generation;
+
+        const auto* job = _job;
+        i64         b, e;
+        segment(_begin, _end, t, b, e);
+        lock.unlock();
+
+        if (b < e) (*job)(b, e);
+
+        lock.lock();
+        if (--_pending == 0) _done_cv.notify_one();
+    }
+}
+} // namespace dk
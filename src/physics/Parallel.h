@@ -0,0 +1,99 @@
+// Parallel.h
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Base.h"
+
+namespace dk {
+/**
+ * 常驻的 slab 线程池.
+ * 区间按线程数静态均分，第 t 段总是由第 t 个线程执行（t = 0 为调用线程）。
+ * 网格字段用同样的切分做并行首次触碰（first touch），于是每个 slab 的内存页
+ * 落在之后处理它的线程所在的 NUMA 节点上。
+ * 嵌套调用或并发调用时退化为在当前线程串行执行。
+ */
+class SlabPool
+{
+public:
+    static SlabPool& instance();
+
+    explicit SlabPool(unsigned threads = std::thread::hardware_concurrency());
+    ~SlabPool();
+
+    SlabPool(const SlabPool&)            = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    int threadCount() const { return static_cast<int>(_workers.size()) + 1; }
+
+    // 对 [begin, end) 的每个静态分段调用 fn(seg_begin, seg_end)，返回时全部完成
+    void run(i64 begin, i64 end, const std::function<void(i64, i64)>& fn);
+
+private:
+    void workerLoop(int t);
+
+    // 第 t 段的范围
+    void segment(i64 begin, i64 end, int t, i64& seg_begin, i64& seg_end) const
+    {
+        const i64 n = end - begin;
+        const i64 T = threadCount();
+        seg_begin   = begin + n * t / T;
+        seg_end     = begin + n * (t + 1) / T;
+    }
+
+    std::vector<std::thread> _workers;
+
+    std::mutex                              _run_mutex; // 同一时刻只允许一个 run
+    std::mutex                              _mutex;
+    std::condition_variable                 _start_cv;
+    std::condition_variable                 _done_cv;
+    const std::function<void(i64, i64)>*    _job{nullptr};
+    i64                                     _begin{0}, _end{0};
+    std::uint64_t                           _generation{0};
+    int                                     _pending{0};
+    bool                                    _stop{false};
+};
+
+template <class Fn>
+void parallelForSlabs(i64 begin, i64 end, Fn&& fn)
+{
+    if (end <= begin) return;
+    SlabPool::instance().run(begin, end, std::function<void(i64, i64)>(std::forward<Fn>(fn)));
+}
+
+/**
+ * 在 [lo, hi) 的网格区间上并行调用 fn(i, j, k).
+ * 3D 按 k 切 slab，2D（单层网格）按 j 切 slab，与字段的首次触碰切分一致。
+ */
+template <int Dim, class Fn>
+void parallelForGrid(const glm::ivec3& lo, const glm::ivec3& hi, Fn&& fn)
+{
+    if constexpr (Dim == 3)
+    {
+        parallelForSlabs(lo.z, hi.z, [&](i64 k0, i64 k1)
+        {
+            for (int k = static_cast<int>(k0); k < static_cast<int>(k1); ++k)
+                for (int j = lo.y; j < hi.y; ++j)
+                    for (int i = lo.x; i < hi.x; ++i) fn(i, j, k);
+        });
+    }
+    else
+    {
+        parallelForSlabs(lo.y, hi.y, [&](i64 j0, i64 j1)
+        {
+            for (int k = lo.z; k < hi.z; ++k)
+                for (int j = static_cast<int>(j0); j < static_cast<int>(j1); ++j)
+                    for (int i = lo.x; i < hi.x; ++i) fn(i, j, k);
+        });
+    }
+}
+
+template <int Dim, class Fn>
+void parallelForGrid(const glm::ivec3& dims, Fn&& fn)
+{
+    parallelForGrid<Dim>(glm::ivec3(0), dims, std::forward<Fn>(fn));
+}
+}
@@ -0,0 +1,121 @@
+// PhysicsStats.cpp
+#include "PhysicsStats.h"
+
+namespace dk {
+PhysicsStats& PhysicsStats::instance()
+{
+    static PhysicsStats stats;
+    return stats;
+}
+
+PhysicsStats::SystemScope::SystemScope(std::string_view name)
+{
+    std::string& prefix = instance().prefix_;
+    prev_length_        = prefix.size();
+    prefix.append(name);
+    prefix.push_back('/');
+}
+
+PhysicsStats::SystemScope::~SystemScope()
+{
+    instance().prefix_.resize(prev_length_);
+}
+
+void PhysicsStats::record(std::string_view stage, Kind kind, double v)
+{
+    if (!enabled_) return;
+
+    key_.assign(prefix_);
+    key_.append(stage);
+    size_t id;
+    auto   it = index_.find(key_);
+    if (it != index_.end())
+    {
+        id = it->second;
+    }
+    else
+    {
+        id = channels_.size();
+        channels_.emplace_back();
+        channels_.back().name      = key_;
+        channels_.back().plot_name = intern(key_);
+        channels_.back().kind      = kind;
+        index_.emplace(key_, id);
+    }
+
+    Channel& c = channels_[id];
+    if (c.kind == Kind::Value) c.current = v;
+    else c.current += v;
+    c.touched = true;
+}
+
+const char* PhysicsStats::intern(std::string_view name)
+{
+    auto it = interned_.find(name);
+    if (it != interned_.end()) return it->data();
+    const std::string& stored = interned_names_.emplace_back(name);
+    interned_.insert(stored);
+    return stored.c_str();
+}
+
+void PhysicsStats::beginFrame()
+{
+    for (Channel& c : channels_)
+    {
+        if (c.kind != Kind::Value) c.current = 0.0;
+        c.touched = false;
+    }
+}
+
+void PhysicsStats::endFrame()
+{
+    if (!enabled_) return;
+    for (Channel& c : channels_)
+    {
+        // 本帧没记录：计时、计数为 0（系统没有步进），数值沿用上一帧
+        const float v = c.touched || c.kind == Kind::Value ? static_cast<float>(c.current) : 0.0f;
+        c.history[c.head] = v;
+        c.head            = (c.head + 1) % kHistory;
+        c.size            = std::min(c.size + 1, kHistory);
+    }
+    ++frames_;
+}
+
+const PhysicsStats::Channel* PhysicsStats::find(std::string_view name) const
+{
+    auto it = index_.find(name);
+    return it != index_.end() ? &channels_[it->second] : nullptr;
+}
+
+float PhysicsStats::latest(std::string_view name) const
+{
+    const Channel* c = find(name);
+    return c ? c->latest() : 0.0f;
+}
+
+float PhysicsStats::average(std::string_view name, size_t frames) const
+{
+    const Channel* c = find(name);
+    if (!c || c->size == 0) return 0.0f;
+    frames       = std::min(frames, c->size);
+    double total = 0.0;
+    for (size_t k = 0; k < frames; ++k) total += c->at(k);
+    return static_cast<float>(total / static_cast<double>(frames));
+}
+
+void PhysicsStats::history(std::string_view name, std::vector<float>& out) const
+{
+    out.clear();
+    const Channel* c = find(name);
+    if (!c) return;
+    out.resize(c->size);
+    for (size_t k = 0; k < c->size; ++k) out[c->size - 1 - k] = c->at(k);
+}
+
+void PhysicsStats::reset()
+{
+    channels_.clear();
+    index_.clear();
+    frames_ = 0;
+}
+}
@@ -0,0 +1,120 @@
+// PhysicsStats.h
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+
+namespace dk {
+/**
+ * 物理统计：按通道记录每帧的计时与计数，保留最近 kHistory 帧.
+ * 通道名是 "系统/阶段"（例如 "smoke/projection"、"cloth/pbd iterations"），系统前缀来自当前的
+ * SystemScope，不在任何系统里记录时没有前缀。同一帧内同一通道的多次记录：
+ * - Time（毫秒）与 Count 累加，例如 10 个子步的 projection 时间加起来
+ * - Value 取最后一次，例如残差
+ * World::tick 开始时 beginFrame、结束时 endFrame，把本帧的值推进环形缓冲。
+ * 只在仿真线程调用；enabled = false 时记录直接返回。
+ */
+class PhysicsStats
+{
+public:
+    enum class Kind { Time, Count, Value };
+
+    static constexpr size_t kHistory = 240;
+
+    struct Channel
+    {
+        std::string                 name;
+        const char*                 plot_name = nullptr; // 驻留的同名字符串，reset 之后仍有效，可以交给 Tracy 这类只存指针的接口
+        Kind                        kind    = Kind::Time;
+        double                      current = 0.0; // 本帧累计
+        bool                        touched = false;
+        std::array<float, kHistory> history{};
+        size_t                      head = 0, size = 0; // history[head] 是下一帧要写的位置
+
+        float latest() const { return size ? history[(head + kHistory - 1) % kHistory] : 0.0f; }
+        // 第 k 帧前的值，k = 0 为最新
+        float at(size_t k) const { return history[(head + kHistory - 1 - k) % kHistory]; }
+    };
+
+    static PhysicsStats& instance();
+
+    void setEnabled(bool e) { enabled_ = e; }
+    bool enabled() const { return enabled_; }
+
+    // 记录；stage 会加上当前系统前缀
+    void addTime(std::string_view stage, double ms) { record(stage, Kind::Time, ms); }
+    void addCount(std::string_view stage, double n) { record(stage, Kind::Count, n); }
+    void setValue(std::string_view stage, double v) { record(stage, Kind::Value, v); }
+
+    void beginFrame();
+    void endFrame();
+
+    // 查询；通道按首次记录的顺序排列，地址在 PhysicsStats 生命周期内不变
+    const std::deque<Channel>& channels() const { return channels_; }
+    const Channel*             find(std::string_view name) const;
+    float                      latest(std::string_view name) const;
+    // 最近 frames 帧的平均值
+    float average(std::string_view name, size_t frames) const;
+    // 从旧到新的历史
+    void   history(std::string_view name, std::vector<float>& out) const;
+    size_t frameCount() const { return frames_; }
+
+    // 清空所有通道（驻留的名字保留）
+    void reset();
+
+    // 在作用域内把记录归到系统 name 下
+    class SystemScope
+    {
+    public:
+        explicit SystemScope(std::string_view name);
+        ~SystemScope();
+
+    private:
+        size_t prev_length_;
+    };
+
+    // 作用域结束时把经过的毫秒数记到 stage
+    class StageTimer
+    {
+    public:
+        explicit StageTimer(std::string_view stage) : stage_(stage), start_(std::chrono::steady_clock::now()) {}
+        ~StageTimer()
+        {
+            const std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start_;
+            instance().addTime(stage_, ms.count());
+        }
+
+    private:
+        std::string_view                      stage_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+private:
+    // 让 index_ 能直接用 string_view 查找
+    struct NameHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+
+    void        record(std::string_view stage, Kind kind, double v);
+    const char* intern(std::string_view name);
+
+    bool                                                            enabled_ = true;
+    size_t                                                          frames_  = 0;
+    std::string                                                     prefix_; // 当前系统前缀，形如 "smoke/"
+    std::string                                                     key_;    // 拼接通道名的复用缓冲
+    std::deque<Channel>                                             channels_;
+    tsl::robin_map<std::string, size_t, NameHash, std::equal_to<>> index_;
+    // 出现过的通道名，只增不删：deque 里的字符串地址不变，interned_ 的键指向它们
+    std::deque<std::string>                                         interned_names_;
+    tsl::robin_set<std::string_view, NameHash>                      interned_;
+};
+}
@@ -0,0 +1,53 @@
+// Timeline.cpp
+#include "Timeline.h"
+
+namespace dk {
+void Timeline::advance(const double real_dt, const std::function<void(int)>& step, const std::function<void(int, double)>& sync)
+{
+    const double horizon = time_ + real_dt + kEps;
+    while (true)
+    {
+        // 最早结束的一步
+        int    next_clock = -1;
+        double step_end   = 0.0;
+        for (int c = 0; c < static_cast<int>(clocks_.size()); ++c)
+        {
+            const Clock& clock = clocks_[c];
+            if (clock.dt <= 0.0) continue;
+            const double end = clock.time + clock.dt;
+            if (end <= horizon && (next_clock < 0 || end < step_end - kEps))
+            {
+                next_clock = c;
+                step_end   = end;
+            }
+        }
+
+        // 最早的同步点；与步同时到期时让步先走
+        int next_sync = -1;
+        for (int s = 0; s < static_cast<int>(syncs_.size()); ++s)
+        {
+            const Sync& sp = syncs_[s];
+            if (sp.period <= 0.0 || sp.next > horizon) continue;
+            if (next_clock >= 0 && sp.next >= step_end - kEps) continue;
+            if (next_sync < 0 || sp.next < syncs_[next_sync].next) next_sync = s;
+        }
+
+        if (next_sync >= 0)
+        {
+            Sync& sp = syncs_[next_sync];
+            sync(next_sync, sp.next);
+            sp.next += sp.period;
+        }
+        else if (next_clock >= 0)
+        {
+            step(next_clock);
+            clocks_[next_clock].time = step_end;
+        }
+        else
+        {
+            break;
+        }
+    }
+    time_ += real_dt;
+}
+}
@@ -0,0 +1,56 @@
+// Timeline.h
+#pragma once
+#include <functional>
+#include <vector>
+
+#include "Base.h"
+
+namespace dk {
+/**
+ * 多速率调度的公共时间轴.
+ * 每个时钟有自己的步长和已推进到的时刻（相当于各自的累加器），同步点按固定周期触发。
+ * advance() 把时间轴推进 real_dt，期间所有到期的步和同步点按结束时刻从早到晚执行：
+ * 同一时刻先执行步，再执行同步点，所以同步点回调看到的是所有已推进到该时刻的系统；
+ * 时刻相同的步按时钟注册顺序执行，结果可复现。
+ */
+class Timeline
+{
+public:
+    // 返回时钟编号；新时钟从当前时刻开始
+    int addClock(double dt)
+    {
+        clocks_.push_back({dt, time_});
+        return static_cast<int>(clocks_.size()) - 1;
+    }
+    void   setClockDt(int id, double dt) { clocks_[id].dt = dt; }
+    double clockDt(int id) const { return clocks_[id].dt; }
+    double clockTime(int id) const { return clocks_[id].time; }
+
+    // 第一次在当前时刻之后一个周期触发
+    int addSync(double period)
+    {
+        syncs_.push_back({period, time_ + period});
+        return static_cast<int>(syncs_.size()) - 1;
+    }
+
+    // step(clock) 推进该时钟一步；sync(id, time) 在同步时刻调用
+    void advance(double real_dt, const std::function<void(int)>& step, const std::function<void(int, double)>& sync);
+
+    double time() const { return time_; }
+
+private:
+    struct Clock
+    {
+        double dt, time;
+    };
+
+    struct Sync
+    {
+        double period, next;
+    };
+
+    std::vector<Clock> clocks_;
+    std::vector<Sync>  syncs_;
+    double             time_ = 0.0;
+};
+}
@@ -1,6 +1,8 @@
 #include "Base.h"
 #include "World.h"
+#include "PhysicsStats.h"
 
+#include <cmath>
 #include <ranges>
 #include <tracy/Tracy.hpp>
 
@@ -15,15 +17,103 @@ void World::tick(float real_dt)
 {
     ZoneScopedN("total physic simulation");
 
-    acc_ += real_dt;
-    const float h = settings_.fixed_dt;
-    while (acc_ + kEps >= h)
+    PhysicsStats& stats = PhysicsStats::instance();
+    stats.beginFrame();
+    updateColliders();
+    timeline_.advance(real_dt, [&](int clock) { stepSystem(clocked_[clock]); },
+                      [&](int sync, double time) { couplings_[sync](time); });
+    stats.endFrame();
+
+    // Tracy 只保存名字指针，用驻留的 plot_name：PhysicsStats::reset 之后它仍然有效
+    if (stats.enabled())
+        for (const PhysicsStats::Channel& c : stats.channels()) TracyPlot(c.plot_name, c.latest());
+}
+
+const World::ClockedSystem* World::findClocked(const std::string_view& name) const
+{
+    for (const ClockedSystem& entry : clocked_)
+        if (entry.name == name) return &entry;
+    return nullptr;
+}
+
+bool World::setSystemRate(const std::string_view& name, const SystemRate& rate)
+{
+    for (ClockedSystem& entry : clocked_)
+    {
+        if (entry.name != name) continue;
+        entry.rate = rate;
+        timeline_.setClockDt(entry.clock, systemRate(name).fixed_dt);
+        return true;
+    }
+    fmt::print(stderr, "Error: System with name '{}' does not exist.\n", name);
+    return false;
+}
+
+SystemRate World::systemRate(const std::string_view& name) const
+{
+    const ClockedSystem* entry = findClocked(name);
+    if (!entry) return SystemRate{};
+    return SystemRate{entry->rate.fixed_dt > 0.0f ? entry->rate.fixed_dt : settings_.fixed_dt,
+                      entry->rate.substeps > 0 ? entry->rate.substeps : settings_.substeps};
+}
+
+double World::systemTime(const std::string_view& name) const
+{
+    const ClockedSystem* entry = findClocked(name);
+    return entry ? timeline_.clockTime(entry->clock) : -1.0;
+}
+
+void World::addCoupling(const std::vector<std::string>& systems, float period, std::function<void(double)> fn)
+{
+    for (const std::string& name : systems)
     {
-        for (int s = 0; s < settings_.substeps; ++s)
-        {
-            for (const auto& val : systems_ | std::views::values) val->step(h / static_cast<float>(settings_.substeps));
-        }
-        acc_ -= h;
+        const double dt    = systemRate(name).fixed_dt;
+        const double ratio = period / dt;
+        if (!findClocked(name) || std::abs(ratio - std::round(ratio)) > 1e-4 || ratio < 1.0 - 1e-4)
+            fmt::print(stderr, "Warning: coupling period {} is not a multiple of system '{}' step {}.\n", period, name, dt);
     }
+    couplings_.push_back(std::move(fn));
+    timeline_.addSync(period);
+}
+
+void World::stepSystem(const ClockedSystem& entry)
+{
+    ZoneScoped;
+    ZoneName(entry.name.data(), entry.name.size());
+    PhysicsStats::SystemScope scope(entry.name);
+    PhysicsStats::StageTimer  timer("total");
+
+    const SystemRate rate = systemRate(entry.name);
+    const float      h    = rate.fixed_dt / static_cast<float>(rate.substeps);
+    for (int s = 0; s < rate.substeps; ++s)
+    {
+        entry.system->step(h);
+        collideSystem(*entry.system);
+    }
+}
+
+void World::updateColliders()
+{
+    if (colliders_dirty_)
+    {
+        std::vector<const ICollider*> colliders;
+        colliders.reserve(_colliders.size());
+        for (const auto& c : _colliders | std::views::values) colliders.push_back(c.get());
+        collision_.setColliders(std::move(colliders));
+        colliders_dirty_ = false;
+    }
+    else
+    {
+        collision_.refit();
+    }
+}
+
+void World::collideSystem(ISystem& system)
+{
+    ZoneScopedN("collision");
+
+    if (collision_.colliderCount() == 0) return;
+    PhysicsStats::StageTimer timer("collision");
+    if (ParticleData* data = system.particleData()) collision_.collide(*data, settings_.collision_radius);
 }
 } // namespace dk
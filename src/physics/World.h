@@ -1,17 +1,29 @@
 #pragma once
+#include <functional>
+#include <span>
 #include <vector>
 #include <memory>
 #include <tsl/robin_map.h>
 #include <fmt/format.h>
 
+#include "collider/CollisionPipeline.h"
 #include "collider/ICollider.h"
 #include "data/Particle.h"
+#include "Timeline.h"
 
 namespace dk {
 struct WorldSettings
 {
     float fixed_dt{1.0f / 100.0f}; // 时间步长
     int   substeps{10}; // 每帧的子步数
+    float collision_radius{0.0f}; // 与碰撞体求交时粒子的半径
+};
+
+// 单个系统的步进频率；0 表示沿用 WorldSettings 的 fixed_dt / substeps
+struct SystemRate
+{
+    float fixed_dt{0.0f};
+    int   substeps{0};
 };
 
 
@@ -27,6 +39,19 @@ public:
  * @param out_data 要被填充的目标向量. 函数内部会清空并重新填充它.
  */
     virtual void getRenderData(std::vector<PointData>& out_data) const = 0;
+
+    // 渲染导出的点数，调用方据此检查或准备缓冲；不导出点的系统为 0
+    virtual size_t renderPointCount() const { return 0; }
+/**
+ * @brief 把渲染点直接写进调用方提供的缓冲（例如持久映射的上传缓冲），不经过中间的 std::vector.
+ * 着色在同一遍并行写入里完成。
+ * @param out 目标缓冲，最多写 out.size() 个点.
+ * @return 实际写入的点数.
+ */
+    virtual size_t writeRenderData(std::span<PointData>) const { return 0; }
+
+    // 参与 World 碰撞阶段的粒子；不用 ParticleData 存粒子的系统返回 nullptr，不参与
+    virtual ParticleData* particleData() { return nullptr; }
 };
 
 
@@ -48,9 +73,27 @@ public:
         auto ptr = std::make_unique<T>(std::forward<Args>(args)...);
         T*   raw = ptr.get();
         systems_.insert_or_assign(name, std::move(ptr));
+        clocked_.push_back({name, raw, SystemRate{}, timeline_.addClock(settings_.fixed_dt)});
         return raw;
     }
 
+    // 每个系统按自己的频率在公共时间轴上推进，各有各的累加器。
+    // 例如烟雾网格 30 Hz、刚性布料 600 Hz，不必都跟着最快的那个跑
+    bool setSystemRate(const std::string_view& name, const SystemRate& rate);
+    // 实际生效的频率（0 已替换为默认值）
+    SystemRate systemRate(const std::string_view& name) const;
+    // 系统已推进到的时刻，找不到时为 -1
+    double systemTime(const std::string_view& name) const;
+
+    /**
+     * 耦合同步点：每隔 period 调用一次 fn(time)，此时所有步进到 time 为止的步都已执行、
+     * 之后的步都还没开始，耦合的系统可以在这里交换数据（例如流体把阻力交给布料）。
+     * systems 里每个系统的步长都应整除 period，否则它停在 time 之前最近的一步，这种情况会打印警告。
+     */
+    void addCoupling(const std::vector<std::string>& systems, float period, std::function<void(double)> fn);
+
+    double time() const { return timeline_.time(); }
+
     ISystem* getSystem(const std::string_view& name)
     {
         auto it = systems_.find(std::string(name));
@@ -84,64 +127,69 @@ public:
         }
         return nullptr;
     }
-    void                 tick(float real_dt); // accumulate and run fixed steps
-    const WorldSettings& settings() const { return settings_; }
-
-private:
-    void handleCollisions()
+    // 碰撞体：按名字注册，与 systems 一样不允许重名
+    template <class T, class... Args>
+        requires std::is_base_of_v<ICollider, T>
+    T* addCollider(const std::string& name, Args&&... args)
     {
-        // 对每个系统的每个粒子进行碰撞检测和响应
-        //for (auto& system : systems_) {
-        //    ParticleData& data = system.second();
-        //    const size_t particleCount = data.size();
-
-        //    for (size_t i = 0; i < particleCount; ++i) {
-        //        if (data.is_fixed[i]) continue;
-
-        //        // 与世界中的所有碰撞体进行检测
-        //        for (const auto& collider : colliders) {
-        //            CollisionInfo info = collider->testCollision(data.position[i], 0.0f); // 假设粒子半径为0
-
-        //            if (info.hasCollided) {
-        //                // 如果碰撞，进行响应
-        //                resolveCollision(data, i, info);
-        //            }
-        //        }
-        //    }
-        //}
+        if (_colliders.count(name))
+        {
+            fmt::print(stderr, "Error: Collider with name '{}' already exists.\n", name);
+            return nullptr;
+        }
+        auto ptr = std::make_unique<T>(std::forward<Args>(args)...);
+        T*   raw = ptr.get();
+        _colliders.insert_or_assign(name, std::move(ptr));
+        colliders_dirty_ = true;
+        return raw;
     }
 
-    void resolveCollision(ParticleData& data, size_t particleIndex, const CollisionInfo& info)
+    bool removeCollider(const std::string_view& name)
     {
-        // 1. 位置修正 (投影)
-        // 将粒子沿法线方向推出碰撞体
-        data.position[particleIndex] += info.normal * info.penetrationDepth;
-
-        // 2. 速度修正 (响应)
-        // 计算沿法线方向的速度分量
-        float velocityAlongNormal = dot(data.velocity[particleIndex], info.normal);
-
-        // 如果速度是朝向碰撞体内部的，才需要响应
-        if (velocityAlongNormal < 0)
-        {
-            // 定义恢复系数 (弹性)，0=完全非弹性, 1=完全弹性
-            constexpr float restitution = 0.5f;
-
-            // 计算需要施加的冲量，以反转法线方向的速度
-            float j       = -(1.0f + restitution) * velocityAlongNormal;
-            vec3  impulse = j * info.normal;
+        auto it = _colliders.find(std::string(name));
+        if (it == _colliders.end()) return false;
+        _colliders.erase(it);
+        colliders_dirty_ = true;
+        return true;
+    }
 
-            // 应用冲量 (由于我们直接操作速度，所以是 impulse / mass，但这里简化为直接改变速度)
-            data.velocity[particleIndex] += impulse;
-        }
+    ICollider* getCollider(const std::string_view& name)
+    {
+        auto it = _colliders.find(std::string(name));
+        return (it == _colliders.end()) ? nullptr : it->second.get();
     }
 
+    size_t colliderCount() const { return _colliders.size(); }
+
+    void                 tick(float real_dt); // accumulate and run fixed steps
+    const WorldSettings& settings() const { return settings_; }
 
+private:
 
+    // 系统在时间轴上的时钟，下标与注册顺序一致；时刻相同的步按这个顺序执行
+    struct ClockedSystem
+    {
+        std::string name;
+        ISystem*    system;
+        SystemRate  rate;
+        int         clock;
+    };
+
+    const ClockedSystem* findClocked(const std::string_view& name) const;
+    // 推进一个系统的一步（substeps 个子步），每个子步后做它的碰撞
+    void stepSystem(const ClockedSystem& entry);
+    // 只处理一个系统的粒子
+    void collideSystem(ISystem& system);
+    // 每个 tick 开始时：碰撞体集合变了就重建 broadphase，否则 refit
+    void updateColliders();
 
     WorldSettings                                           settings_{};
     tsl::robin_map<std::string, std::unique_ptr<ISystem>>   systems_;
     tsl::robin_map<std::string, std::unique_ptr<ICollider>> _colliders;
-    float                                                   acc_{0.f};
+    std::vector<ClockedSystem>                              clocked_;
+    std::vector<std::function<void(double)>>                couplings_; // 下标与时间轴的同步点一致
+    Timeline                                                timeline_;
+    CollisionPipeline                                       collision_;
+    bool                                                    colliders_dirty_{false};
 };
 }
@@ -0,0 +1,72 @@
+// AABBCollider.h
+#pragma once
+#include <algorithm>
+
+#include "ICollider.h"
+
+namespace dk {
+// 轴对齐的实心盒子，粒子被推到最近的面外
+class AABBCollider : public ICollider
+{
+public:
+    AABBCollider(const vec3& min, const vec3& max)
+        : box_min(glm::min(min, max)), box_max(glm::max(min, max))
+    {
+    }
+
+    CollisionInfo testCollision(const vec3& particlePosition, float particleRadius) const override
+    {
+        CollisionInfo info;
+
+        const vec3  closest = glm::clamp(particlePosition, box_min, box_max);
+        const vec3  d       = particlePosition - closest;
+        const float dist2   = dot(d, d);
+
+        if (dist2 > 0.0f)
+        {
+            // 粒子中心在盒外：按到盒子的距离判断
+            const float dist = std::sqrt(dist2);
+            if (dist < particleRadius)
+            {
+                info.hasCollided      = true;
+                info.normal           = d / dist;
+                info.penetrationDepth = particleRadius - dist;
+            }
+            return info;
+        }
+
+        // 粒子中心在盒内：从离得最近的面推出去
+        const vec3 to_min = particlePosition - box_min;
+        const vec3 to_max = box_max - particlePosition;
+        float      depth  = to_min.x;
+        info.normal       = vec3(-1, 0, 0);
+        for (int a = 0; a < 3; ++a)
+        {
+            if (to_min[a] < depth)
+            {
+                depth       = to_min[a];
+                info.normal = vec3(0.0f);
+                info.normal[a] = -1.0f;
+            }
+            if (to_max[a] < depth)
+            {
+                depth       = to_max[a];
+                info.normal = vec3(0.0f);
+                info.normal[a] = 1.0f;
+            }
+        }
+        info.hasCollided      = true;
+        info.penetrationDepth = depth + particleRadius;
+        return info;
+    }
+
+    // 与 testCollision 的结果逐位一致：盒外、盒内两种情况都算出来再按 lane 选择
+    void testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const override;
+
+    AABB bounds() const override { return AABB{box_min, box_max}; }
+
+private:
+    vec3 box_min;
+    vec3 box_max;
+};
+}
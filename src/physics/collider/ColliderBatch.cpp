@@ -0,0 +1,87 @@
+// collider/ColliderBatch.cpp
+// 各解析碰撞体的批量碰撞核。放在单独的编译单元里，src/CMakeLists.txt 只对这里和 SdfCollider.cpp
+// 打开 -fno-math-errno -fno-trapping-math，带 sqrt 和 select 的逐 lane 循环才能自动向量化
+#include <algorithm>
+#include <cmath>
+
+#include "collider/AABBCollider.h"
+#include "collider/PlaneCollider.h"
+#include "collider/SphereCollider.h"
+
+namespace dk {
+void PlaneCollider::testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const
+{
+    BatchScratch s;
+    for (int k = 0; k < batch.count; ++k)
+    {
+        const float signedDist = batch.x[k] * normal.x + batch.y[k] * normal.y + batch.z[k] * normal.z - distance;
+        s.depth[k]             = particleRadius - signedDist;
+        s.hit[k]               = signedDist < particleRadius;
+    }
+    out.clear();
+    for (int k = 0; k < batch.count; ++k)
+    {
+        if (s.hit[k]) out.push(k, normal, s.depth[k]);
+    }
+}
+
+void AABBCollider::testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const
+{
+    BatchScratch s;
+    for (int k = 0; k < batch.count; ++k)
+    {
+        const float px = batch.x[k], py = batch.y[k], pz = batch.z[k];
+        const float dx = px - std::clamp(px, box_min.x, box_max.x);
+        const float dy = py - std::clamp(py, box_min.y, box_max.y);
+        const float dz = pz - std::clamp(pz, box_min.z, box_max.z);
+        const float dist2 = dx * dx + dy * dy + dz * dz;
+        const bool  outside = dist2 > 0.0f;
+        const float dist    = std::sqrt(dist2);
+        const float safe    = outside ? dist : 1.0f;
+
+        // 盒内：六个面里最近的一个，比较顺序与 testCollision 相同
+        float depth = px - box_min.x, nx = -1.0f, ny = 0.0f, nz = 0.0f;
+        auto  face  = [&](float d, float fx, float fy, float fz)
+        {
+            const bool closer = d < depth;
+            depth             = closer ? d : depth;
+            nx                = closer ? fx : nx;
+            ny                = closer ? fy : ny;
+            nz                = closer ? fz : nz;
+        };
+        face(box_max.x - px, 1.0f, 0.0f, 0.0f);
+        face(py - box_min.y, 0.0f, -1.0f, 0.0f);
+        face(box_max.y - py, 0.0f, 1.0f, 0.0f);
+        face(pz - box_min.z, 0.0f, 0.0f, -1.0f);
+        face(box_max.z - pz, 0.0f, 0.0f, 1.0f);
+
+        s.nx[k]    = outside ? dx / safe : nx;
+        s.ny[k]    = outside ? dy / safe : ny;
+        s.nz[k]    = outside ? dz / safe : nz;
+        s.depth[k] = outside ? particleRadius - dist : depth + particleRadius;
+        s.hit[k]   = !outside || dist < particleRadius;
+    }
+    s.compact(batch.count, out);
+}
+
+void SphereCollider::testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const
+{
+    BatchScratch s;
+    const float  reach = radius + particleRadius;
+    for (int k = 0; k < batch.count; ++k)
+    {
+        const float dx   = batch.x[k] - center.x;
+        const float dy   = batch.y[k] - center.y;
+        const float dz   = batch.z[k] - center.z;
+        const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const bool  off  = dist > 0.0f;
+        const float safe = off ? dist : 1.0f;
+        s.nx[k]          = off ? dx / safe : 0.0f;
+        s.ny[k]          = off ? dy / safe : 1.0f;
+        s.nz[k]          = off ? dz / safe : 0.0f;
+        s.depth[k]       = reach - dist;
+        s.hit[k]         = dist < reach;
+    }
+    s.compact(batch.count, out);
+}
+}
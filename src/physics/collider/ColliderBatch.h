@@ -0,0 +1,72 @@
+// collider/ColliderBatch.h
+#pragma once
+#include <cstdint>
+
+#include "Base.h"
+
+namespace dk {
+// 一块粒子的 SoA 位置，批量碰撞核的输入；index 为粒子在 ParticleData 中的下标
+struct ParticleBatch
+{
+    static constexpr int kCapacity = 64;
+
+    alignas(32) float x[kCapacity];
+    alignas(32) float y[kCapacity];
+    alignas(32) float z[kCapacity];
+    std::uint32_t     index[kCapacity];
+    int               count = 0;
+
+    vec3 position(int lane) const { return vec3(x[lane], y[lane], z[lane]); }
+
+    void setPosition(int lane, const vec3& p)
+    {
+        x[lane] = p.x;
+        y[lane] = p.y;
+        z[lane] = p.z;
+    }
+};
+
+// 一个碰撞体对一块粒子的紧凑接触列表（SoA）；lane 为粒子在 ParticleBatch 中的位置
+struct ContactList
+{
+    std::uint8_t lane[ParticleBatch::kCapacity];
+    float        nx[ParticleBatch::kCapacity];
+    float        ny[ParticleBatch::kCapacity];
+    float        nz[ParticleBatch::kCapacity];
+    float        depth[ParticleBatch::kCapacity];
+    int          count = 0;
+
+    void clear() { count = 0; }
+
+    void push(int l, const vec3& n, float d)
+    {
+        lane[count]  = static_cast<std::uint8_t>(l);
+        nx[count]    = n.x;
+        ny[count]    = n.y;
+        nz[count]    = n.z;
+        depth[count] = d;
+        ++count;
+    }
+
+    vec3 normal(int c) const { return vec3(nx[c], ny[c], nz[c]); }
+};
+
+// 批量核的逐 lane 中间结果；核先用无分支循环写满这些数组（可自动向量化），再按 hit 压缩成 ContactList
+struct BatchScratch
+{
+    alignas(32) float        nx[ParticleBatch::kCapacity];
+    alignas(32) float        ny[ParticleBatch::kCapacity];
+    alignas(32) float        nz[ParticleBatch::kCapacity];
+    alignas(32) float        depth[ParticleBatch::kCapacity];
+    alignas(32) std::int32_t hit[ParticleBatch::kCapacity];
+
+    void compact(int count, ContactList& out) const
+    {
+        out.clear();
+        for (int k = 0; k < count; ++k)
+        {
+            if (hit[k]) out.push(k, vec3(nx[k], ny[k], nz[k]), depth[k]);
+        }
+    }
+};
+}
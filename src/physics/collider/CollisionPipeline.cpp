@@ -0,0 +1,107 @@
+// collider/CollisionPipeline.cpp
+#include "collider/CollisionPipeline.h"
+
+#include "Parallel.h"
+
+namespace dk {
+void CollisionPipeline::setColliders(std::vector<const ICollider*> colliders)
+{
+    bounded_.clear();
+    unbounded_.clear();
+    for (const ICollider* c : colliders)
+    {
+        (c->bounded() ? bounded_ : unbounded_).push_back(c);
+    }
+
+    boxes_.resize(bounded_.size());
+    for (size_t i = 0; i < bounded_.size(); ++i) boxes_[i] = bounded_[i]->bounds();
+    bvh_.build(boxes_, 2);
+}
+
+void CollisionPipeline::refit()
+{
+    for (size_t i = 0; i < bounded_.size(); ++i) boxes_[i] = bounded_[i]->bounds();
+    bvh_.refit(boxes_);
+}
+
+void CollisionPipeline::collide(ParticleData& data, float radius) const
+{
+    const size_t n = data.size();
+    if (n == 0 || colliderCount() == 0) return;
+
+    const i64  blocks = static_cast<i64>((n + kBlockSize - 1) / kBlockSize);
+    const vec3 r(radius);
+    parallelForSlabs(0, blocks, [&](i64 b0, i64 b1)
+    {
+        std::vector<int> candidates;
+        ParticleBatch    batch;
+        ContactList      contacts;
+        for (i64 b = b0; b < b1; ++b)
+        {
+            const size_t begin = static_cast<size_t>(b) * kBlockSize;
+            const size_t end   = std::min(begin + kBlockSize, n);
+
+            // 把块内活动粒子收集成 SoA，顺便求包围盒，遍历一次 BVH
+            AABB block;
+            batch.count = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (data.is_fixed[i] || data.is_dead[i]) continue;
+                batch.index[batch.count] = static_cast<std::uint32_t>(i);
+                batch.setPosition(batch.count++, data.position[i]);
+                block.expand(data.position[i]);
+            }
+            if (batch.count == 0) continue;
+            block.min -= r;
+            block.max += r;
+
+            candidates.clear();
+            bvh_.query(block, [&](int c) { candidates.push_back(c); });
+
+            // 每个碰撞体一次虚调用处理整块；响应后把新位置写回块里，后面的碰撞体看到的是推出后的位置
+            auto apply = [&](const ICollider* collider)
+            {
+                collider->testBatch(batch, radius, contacts);
+                for (int c = 0; c < contacts.count; ++c)
+                {
+                    const int     lane = contacts.lane[c];
+                    const size_t  i    = batch.index[lane];
+                    CollisionInfo info;
+                    info.hasCollided      = true;
+                    info.normal           = contacts.normal(c);
+                    info.penetrationDepth = contacts.depth[c];
+                    resolveCollision(data, i, info);
+                    batch.setPosition(lane, data.position[i]);
+                }
+            };
+            for (const ICollider* collider : unbounded_) apply(collider);
+            for (int c : candidates) apply(bounded_[c]);
+        }
+    });
+}
+
+void CollisionPipeline::resolveCollision(ParticleData& data, size_t particleIndex, const CollisionInfo& info)
+{
+    // 1. 位置修正 (投影)
+    // 将粒子沿法线方向推出碰撞体
+    data.position[particleIndex] += info.normal * info.penetrationDepth;
+
+    // 2. 速度修正 (响应)
+    // 计算沿法线方向的速度分量
+    float velocityAlongNormal = dot(data.velocity[particleIndex], info.normal);
+
+    // 如果速度是朝向碰撞体内部的，才需要响应
+    if (velocityAlongNormal < 0)
+    {
+        // 定义恢复系数 (弹性)，0=完全非弹性, 1=完全弹性
+        constexpr float restitution = 0.5f;
+
+        // 计算需要施加的冲量，以反转法线方向的速度
+        float j       = -(1.0f + restitution) * velocityAlongNormal;
+        vec3  impulse = j * info.normal;
+
+        // 应用冲量 (由于我们直接操作速度，所以是 impulse / mass，但这里简化为直接改变速度)
+        data.velocity[particleIndex] += impulse;
+    }
+}
+}
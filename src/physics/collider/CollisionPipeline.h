@@ -0,0 +1,44 @@
+// collider/CollisionPipeline.h
+#pragma once
+#include <vector>
+
+#include "BVH/BVH.hpp"
+#include "collider/ICollider.h"
+#include "data/Particle.h"
+
+namespace dk {
+/**
+ * 粒子与静态/运动碰撞体的碰撞阶段.
+ * 有界碰撞体的包围盒组织成 BVH（碰撞体集合变化时重建，每次碰撞前按当前包围盒 refit），
+ * 无界碰撞体（平面）数量很少，对每个粒子都测。
+ * 粒子按连续的小块剔除：块内活动粒子收集成 SoA（ParticleBatch），块的包围盒只遍历一次 BVH，
+ * 每个候选碰撞体对整块只做一次虚调用 testBatch，得到紧凑的接触列表后逐个响应。
+ * 块按 slab 并行，块之间不共享写入。
+ * 碰撞体之间的顺序是“逐碰撞体处理整块”，同一粒子同时碰到多个碰撞体时与逐粒子遍历的结果可能略有不同。
+ */
+class CollisionPipeline
+{
+public:
+    // 每个剔除块的粒子数，即批量核一次处理的粒子数
+    static constexpr size_t kBlockSize = ParticleBatch::kCapacity;
+
+    void setColliders(std::vector<const ICollider*> colliders);
+    // 碰撞体移动后按 bounds() 更新 BVH，拓扑不变
+    void refit();
+
+    // 对 data 中所有非固定粒子做求交与响应；radius 为粒子半径
+    void collide(ParticleData& data, float radius) const;
+
+    // 沿法线推出穿透并反弹法向速度
+    static void resolveCollision(ParticleData& data, size_t particleIndex, const CollisionInfo& info);
+
+    size_t     colliderCount() const { return bounded_.size() + unbounded_.size(); }
+    const BVH& bvh() const { return bvh_; }
+
+private:
+    std::vector<const ICollider*> bounded_;   // BVH 图元 i 对应 bounded_[i]
+    std::vector<const ICollider*> unbounded_;
+    std::vector<AABB>             boxes_;
+    BVH                           bvh_;
+};
+}
@@ -0,0 +1,88 @@
+// collider/Distance.h
+#pragma once
+#include <algorithm>
+
+#include "Base.h"
+
+namespace dk {
+// 点到三角形的最近点（Ericson, Real-Time Collision Detection 5.1.5）
+inline vec3 closestPointOnTriangle(const vec3& p, const vec3& a, const vec3& b, const vec3& c)
+{
+    const vec3  ab = b - a, ac = c - a, ap = p - a;
+    const float d1 = dot(ab, ap), d2 = dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+
+    const vec3  bp = p - b;
+    const float d3 = dot(ab, bp), d4 = dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+
+    const vec3  cp = p - c;
+    const float d5 = dot(ab, cp), d6 = dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    const float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// p 在三角形平面上投影的重心坐标（退化三角形返回 (1, 0, 0)）
+inline vec3 triangleBarycentric(const vec3& p, const vec3& a, const vec3& b, const vec3& c)
+{
+    const vec3  v0 = b - a, v1 = c - a, v2 = p - a;
+    const float d00 = dot(v0, v0), d01 = dot(v0, v1), d11 = dot(v1, v1);
+    const float d20 = dot(v2, v0), d21 = dot(v2, v1);
+    const float den = d00 * d11 - d01 * d01;
+    if (den <= 0.0f) return vec3(1.0f, 0.0f, 0.0f);
+    const float v = (d11 * d20 - d01 * d21) / den;
+    const float w = (d00 * d21 - d01 * d20) / den;
+    return vec3(1.0f - v - w, v, w);
+}
+
+// 两条线段 p1p2、q1q2 之间的最近点参数 s、t ∈ [0, 1]（Ericson 5.1.9）
+inline void closestPointsOnSegments(const vec3& p1, const vec3& p2, const vec3& q1, const vec3& q2, float& s, float& t)
+{
+    constexpr float eps = 1e-12f;
+    const vec3      d1 = p2 - p1, d2 = q2 - q1, r = p1 - q1;
+    const float     a = dot(d1, d1), e = dot(d2, d2), f = dot(d2, r);
+    if (a <= eps && e <= eps)
+    {
+        s = t = 0.0f;
+        return;
+    }
+    if (a <= eps)
+    {
+        s = 0.0f;
+        t = std::clamp(f / e, 0.0f, 1.0f);
+        return;
+    }
+    const float c = dot(d1, r);
+    if (e <= eps)
+    {
+        t = 0.0f;
+        s = std::clamp(-c / a, 0.0f, 1.0f);
+        return;
+    }
+    const float b     = dot(d1, d2);
+    const float denom = a * e - b * b;
+    s                 = denom > 0.0f ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+    t                 = (b * s + f) / e;
+    if (t < 0.0f)
+    {
+        t = 0.0f;
+        s = std::clamp(-c / a, 0.0f, 1.0f);
+    }
+    else if (t > 1.0f)
+    {
+        t = 1.0f;
+        s = std::clamp((b - c) / a, 0.0f, 1.0f);
+    }
+}
+}
@@ -1,6 +1,10 @@
 // Collision.h
 #pragma once
+#include <cmath>
+
 #include "Base.h"
+#include "BVH/AABB.hpp"
+#include "collider/ColliderBatch.h"
 
 namespace dk {
 // 存储一次碰撞检测的结果
@@ -20,5 +24,30 @@ public:
     // 检测一个粒子是否与该碰撞体发生碰撞
     // particleRadius 允许我们将粒子视为小球体，增加鲁棒性
     virtual CollisionInfo testCollision(const vec3& particlePosition, float particleRadius) const = 0;
+
+    // 批量测试：一次虚调用处理一块粒子，发生碰撞的粒子写进 out（先清空）。
+    // 默认逐粒子调用 testCollision；常用的碰撞体重写成可向量化的核
+    virtual void testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const
+    {
+        out.clear();
+        for (int k = 0; k < batch.count; ++k)
+        {
+            const CollisionInfo info = testCollision(batch.position(k), particleRadius);
+            if (info.hasCollided) out.push(k, info.normal, info.penetrationDepth);
+        }
+    }
+
+    // 世界空间包围盒，供 broadphase 使用；无界的碰撞体（如平面）返回各分量为 ±inf 的盒子
+    virtual AABB bounds() const = 0;
+
+    bool bounded() const
+    {
+        const AABB b = bounds();
+        for (int a = 0; a < 3; ++a)
+        {
+            if (std::isinf(b.min[a]) || std::isinf(b.max[a])) return false;
+        }
+        return true;
+    }
 };
 }
@@ -1,5 +1,7 @@
 // PlaneCollider.h
 #pragma once
+#include <limits>
+
 #include "ICollider.h"
 
 namespace dk {
@@ -32,6 +34,14 @@ public:
         return info;
     }
 
+    void testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const override;
+
+    AABB bounds() const override
+    {
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        return AABB{vec3(-inf), vec3(inf)};
+    }
+
 private:
     vec3  normal; // 平面的法线
     float distance; // 从原点沿法线到平面的距离 d
@@ -0,0 +1,95 @@
+// collider/SdfCollider.h
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "ICollider.h"
+
+namespace dk {
+// SDF 构建参数
+struct SdfParams
+{
+    float h    = 0.02f; // 采样间距（世界单位）
+    int   band = 4;     // 窄带半宽（格子数，至少 2）：带内为精确距离，带外截断为 ±band * h；网格四周也按这个宽度留边
+};
+
+/**
+ * 网格结点上采样的有符号距离场，内部为负.
+ * 采样点外（带外、网格外）的值被截断，碰撞只关心表面附近，所以只有窄带里的距离是准确的。
+ */
+struct SignedDistanceField
+{
+    glm::ivec3         dims{0};     // 结点数
+    vec3               origin{0.0f}; // 结点 (0,0,0) 的世界坐标
+    float              h     = 0.0f;
+    float              band  = 0.0f; // 截断距离（世界单位）
+    std::vector<float> phi;          // x 最快
+
+    size_t index(int i, int j, int k) const
+    {
+        return (static_cast<size_t>(k) * dims.y + j) * dims.x + i;
+    }
+    float at(int i, int j, int k) const { return phi[index(i, j, k)]; }
+
+    // 三线性插值；grad 非空时同时给出插值函数的梯度。网格外返回 band（一定在物体外）
+    float sample(const vec3& p, vec3* grad = nullptr) const;
+
+    AABB bounds() const { return AABB{origin, origin + vec3(dims - 1) * h}; }
+};
+
+// 从三角网格并行构建：BVH 求最近点得到窄带内的距离，带内符号由 BVH 加速的广义绕数（winding number）决定，
+// 网格不必严格封闭；带外结点不算绕数，符号从窄带沿网格边传播过去。indices 每三个一组
+std::shared_ptr<SignedDistanceField> buildSignedDistanceField(std::span<const vec3> positions,
+                                                              std::span<const std::uint32_t> indices,
+                                                              const SdfParams& params = SdfParams{});
+
+// 带磁盘缓存的构建：cache_path 存在且网格内容、参数都没变时直接读取，否则重新构建并写回。
+// from_cache 非空时写入是否命中缓存
+std::shared_ptr<SignedDistanceField> loadOrBuildSignedDistanceField(std::span<const vec3> positions,
+                                                                    std::span<const std::uint32_t> indices,
+                                                                    const std::filesystem::path& cache_path,
+                                                                    const SdfParams& params = SdfParams{},
+                                                                    bool* from_cache = nullptr);
+
+// 缓存文件与 raw 网格放在一起：<raw_path>.sdf。raw_path 用 ResourceLoader::rawPath 取得，
+// Mesh 需要 positions、indices 两个成员（MeshData）；编辑器里选中网格节点“Add mesh collider”走这里
+template <class Mesh>
+std::shared_ptr<SignedDistanceField> loadOrBuildMeshSdf(const Mesh& mesh, const std::filesystem::path& raw_path,
+                                                        const SdfParams& params = SdfParams{}, bool* from_cache = nullptr)
+{
+    std::filesystem::path cache = raw_path;
+    cache += ".sdf";
+    return loadOrBuildSignedDistanceField(std::span<const vec3>(mesh.positions.data(), mesh.positions.size()),
+                                          std::span<const std::uint32_t>(mesh.indices.data(), mesh.indices.size()),
+                                          cache, params, from_cache);
+}
+
+/**
+ * 任意网格形状的碰撞体：查询为一次三线性插值加梯度，代价与三角形数无关.
+ * SDF 建在网格的局部空间里，可以在多个碰撞体间共享；transform 把它放到世界中，查询时把粒子变换回局部空间。
+ * 距离按变换的平均缩放换算，只对刚体变换和等比缩放是精确的
+ */
+class SdfCollider : public ICollider
+{
+public:
+    explicit SdfCollider(std::shared_ptr<const SignedDistanceField> sdf, const vec3& translation = vec3(0.0f));
+    SdfCollider(std::shared_ptr<const SignedDistanceField> sdf, const glm::mat4& transform);
+
+    CollisionInfo testCollision(const vec3& particlePosition, float particleRadius) const override;
+    void          testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const override;
+
+    AABB bounds() const override;
+
+    const SignedDistanceField& field() const { return *sdf; }
+
+private:
+    std::shared_ptr<const SignedDistanceField> sdf;
+    glm::mat4                                  to_world;
+    glm::mat4                                  to_local;
+    glm::mat3                                  normal_to_world; // 局部梯度变回世界：线性部分的逆转置
+    float                                      scale;           // 局部距离乘上它得到世界距离
+};
+}
@@ -0,0 +1,41 @@
+// SphereCollider.h
+#pragma once
+#include <cmath>
+
+#include "ICollider.h"
+
+namespace dk {
+// 实心球，粒子沿球心指向粒子的方向被推出
+class SphereCollider : public ICollider
+{
+public:
+    SphereCollider(const vec3& center, float radius)
+        : center(center), radius(radius)
+    {
+    }
+
+    CollisionInfo testCollision(const vec3& particlePosition, float particleRadius) const override
+    {
+        CollisionInfo info;
+
+        const vec3  d    = particlePosition - center;
+        const float dist = std::sqrt(dot(d, d));
+        if (dist < radius + particleRadius)
+        {
+            info.hasCollided = true;
+            // 粒子正好在球心时法线取 +y
+            info.normal           = dist > 0.0f ? d / dist : vec3(0, 1, 0);
+            info.penetrationDepth = radius + particleRadius - dist;
+        }
+        return info;
+    }
+
+    void testBatch(const ParticleBatch& batch, float particleRadius, ContactList& out) const override;
+
+    AABB bounds() const override { return AABB{center - vec3(radius), center + vec3(radius)}; }
+
+private:
+    vec3  center;
+    float radius;
+};
+}
@@ -10,9 +10,9 @@ public:
     {
     }
 
-    void colorize(ParticleData& data) override
+    void shadeBlock(const ParticleData&, size_t begin, size_t end, ColorOut out) override
     {
-        std::fill(data.colors.begin(), data.colors.end(), m_color);
+        for (size_t k = 0; k < end - begin; ++k) out[k] = m_color;
     }
 
 private:
@@ -1,17 +1,81 @@
 // IParticleColorizer.h
 #pragma once
+#include <algorithm>
+
+#include "Parallel.h"
 #include "data/Particle.h"
 
 namespace dk {
+// 着色结果的去处：第 k 个颜色写到 first[k * stride]。
+// 可以直接指向 ParticleData::color（stride 1），也可以指向渲染点数组里的 color 字段（stride 为点的 vec4 数）
+struct ColorOut
+{
+    vec4*  first  = nullptr;
+    size_t stride = 1;
+
+    vec4&    operator[](size_t k) const { return first[k * stride]; }
+    ColorOut offset(size_t k) const { return {first + k * stride, stride}; }
+};
+
+/**
+ * 质点着色器.
+ * 着色按 kBlock 个质点一块并行进行：shadeBlock 把一块的颜色直接写进调用方给的 ColorOut
+ * （ParticleData::color，或渲染缓冲里的 color 字段），不经过中间数组；
+ * 需要统计量（例如速度范围）的着色器在 beginPass / endPass 里准备与合并。
+ */
 class IParticleColorizer
 {
 public:
+    static constexpr size_t kBlock = 1024;
+
     virtual ~IParticleColorizer() = default;
 
+    /**
+     * @brief 一遍着色开始前调用（单线程），count 为本遍要着色的质点数.
+     */
+    virtual void beginPass(const ParticleData&, size_t) {}
+
+    /**
+     * @brief 给 [begin, end) 的质点着色，结果写到 out[0, end - begin).
+     * begin 是 kBlock 的整数倍，块号为 begin / kBlock；不同块会被并行调用.
+     */
+    virtual void shadeBlock(const ParticleData& data, size_t begin, size_t end, ColorOut out) = 0;
+
+    /**
+     * @brief 所有块完成后调用（单线程）.
+     */
+    virtual void endPass() {}
+
+    // 融合遍历：按块并行把颜色写进 out，每块写完后调用 block(begin, end)，调用方趁这段还在缓存里写其他字段
+    template <class Block>
+    void run(const ParticleData& data, size_t count, ColorOut out, Block&& block)
+    {
+        beginPass(data, count);
+        parallelForSlabs(0, static_cast<i64>((count + kBlock - 1) / kBlock), [&](i64 b0, i64 b1)
+        {
+            for (i64 b = b0; b < b1; ++b)
+            {
+                const size_t begin = static_cast<size_t>(b) * kBlock;
+                const size_t end   = std::min(count, begin + kBlock);
+                shadeBlock(data, begin, end, out.offset(begin));
+                block(begin, end);
+            }
+        });
+        endPass();
+    }
+
+    void run(const ParticleData& data, size_t count, ColorOut out)
+    {
+        run(data, count, out, [](size_t, size_t) {});
+    }
+
     /**
      * @brief 根据内部逻辑更新 ParticleData 中的颜色.
      * @param data 要被着色的粒子数据.
      */
-    virtual void colorize(ParticleData& data) = 0;
+    void colorize(ParticleData& data)
+    {
+        run(data, data.size(), {data.color.data()});
+    }
 };
 }
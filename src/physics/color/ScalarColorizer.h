@@ -0,0 +1,180 @@
+// ScalarColorizer.h
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "IParticleColorizer.h"
+
+namespace dk {
+/**
+ * 按一个标量在两种颜色间插值的通用着色核.
+ * Scalar 是无状态的函数对象，Scalar{}(data, i) 给出第 i 个质点的标量。
+ * 范围的三种来源：
+ * - auto_range = false：固定用 [range_min, range_max]
+ * - hysteresis = 0：每遍先并行归约出当前的 min/max，再着色（标量算两次）
+ * - hysteresis > 0：用上一遍的范围着色，同一遍里顺带按块统计新范围；新范围越界时立即扩张，
+ *   收缩超过 hysteresis 比例时才收缩，避免颜色逐帧抖动。第一遍没有旧范围时先归约一次
+ * 块内统计写在按块号分配的数组里，合并顺序固定，结果与线程数无关。
+ */
+template <class Scalar>
+class ScalarColorizer : public IParticleColorizer
+{
+public:
+    struct Params
+    {
+        vec4  min_color  = vec4(0, 0, 1, 1); // 标量最小时的颜色
+        vec4  max_color  = vec4(1, 0, 0, 1); // 标量最大时的颜色
+        bool  auto_range = true;
+        float range_min  = 0.0f;
+        float range_max  = 1.0f;
+        float hysteresis = 0.0f;
+    };
+
+    explicit ScalarColorizer(const Params& p = Params{}) : params_(p) {}
+
+    void          setParams(const Params& p) { params_ = p; have_range_ = false; }
+    const Params& params() const { return params_; }
+
+    // 当前用于着色的范围
+    float rangeMin() const { return lo_; }
+    float rangeMax() const { return hi_; }
+
+    void beginPass(const ParticleData& data, size_t count) override
+    {
+        const size_t blocks = (count + kBlock - 1) / kBlock;
+        block_lo_.resize(blocks);
+        block_hi_.resize(blocks);
+        fused_ = false;
+
+        if (!params_.auto_range)
+        {
+            lo_ = params_.range_min;
+            hi_ = params_.range_max;
+        }
+        else if (params_.hysteresis <= 0.0f || !have_range_)
+        {
+            parallelForSlabs(0, static_cast<i64>(blocks), [&](i64 b0, i64 b1)
+            {
+                for (i64 block = b0; block < b1; ++block)
+                {
+                    const size_t begin = static_cast<size_t>(block) * kBlock;
+                    const size_t end   = std::min(count, begin + kBlock);
+                    float        lo = std::numeric_limits<float>::max(), hi = std::numeric_limits<float>::lowest();
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        const float s = Scalar{}(data, i);
+                        lo            = std::min(lo, s);
+                        hi            = std::max(hi, s);
+                    }
+                    block_lo_[block] = lo;
+                    block_hi_[block] = hi;
+                }
+            });
+            mergeBlocks(lo_, hi_);
+            have_range_ = count > 0;
+        }
+        else
+        {
+            fused_ = true;
+        }
+        inv_span_ = hi_ > lo_ ? 1.0f / (hi_ - lo_) : 0.0f;
+    }
+
+    void shadeBlock(const ParticleData& data, size_t begin, size_t end, ColorOut out) override
+    {
+        float lo = std::numeric_limits<float>::max(), hi = std::numeric_limits<float>::lowest();
+        for (size_t i = begin; i < end; ++i)
+        {
+            const float s  = Scalar{}(data, i);
+            lo             = std::min(lo, s);
+            hi             = std::max(hi, s);
+            out[i - begin] = mix(params_.min_color, params_.max_color, std::clamp((s - lo_) * inv_span_, 0.0f, 1.0f));
+        }
+        if (fused_)
+        {
+            block_lo_[begin / kBlock] = lo;
+            block_hi_[begin / kBlock] = hi;
+        }
+    }
+
+    void endPass() override
+    {
+        if (!fused_ || block_lo_.empty()) return;
+        float lo, hi;
+        mergeBlocks(lo, hi);
+        // 收缩超过 hysteresis 比例时换成新范围（新范围总是包含本遍的所有值）；否则越界时扩张
+        if (hi - lo < (1.0f - params_.hysteresis) * (hi_ - lo_))
+        {
+            lo_ = lo;
+            hi_ = hi;
+        }
+        else
+        {
+            lo_ = std::min(lo_, lo);
+            hi_ = std::max(hi_, hi);
+        }
+    }
+
+private:
+    void mergeBlocks(float& lo, float& hi) const
+    {
+        lo = std::numeric_limits<float>::max();
+        hi = std::numeric_limits<float>::lowest();
+        for (size_t b = 0; b < block_lo_.size(); ++b)
+        {
+            lo = std::min(lo, block_lo_[b]);
+            hi = std::max(hi, block_hi_[b]);
+        }
+        if (block_lo_.empty()) lo = hi = 0.0f;
+    }
+
+    Params             params_;
+    float              lo_ = 0.0f, hi_ = 0.0f, inv_span_ = 0.0f;
+    bool               have_range_ = false, fused_ = false;
+    std::vector<float> block_lo_, block_hi_;
+};
+
+struct SpeedScalar
+{
+    float operator()(const ParticleData& data, size_t i) const { return glm::length(data.velocity[i]); }
+};
+
+struct DensityScalar
+{
+    float operator()(const ParticleData& data, size_t i) const { return data.density[i]; }
+};
+
+struct PressureScalar
+{
+    float operator()(const ParticleData& data, size_t i) const { return data.pressure[i]; }
+};
+
+struct FixedMaskScalar
+{
+    float operator()(const ParticleData& data, size_t i) const { return data.is_fixed[i] ? 1.0f : 0.0f; }
+};
+
+using DensityColorizer  = ScalarColorizer<DensityScalar>;
+using PressureColorizer = ScalarColorizer<PressureScalar>;
+
+// 固定点一种颜色、其余一种颜色
+class FixedMaskColorizer : public ScalarColorizer<FixedMaskScalar>
+{
+public:
+    FixedMaskColorizer(const vec4& freeColor = vec4(0.8f, 0.8f, 0.8f, 1), const vec4& fixedColor = vec4(1, 0.2f, 0.2f, 1))
+        : ScalarColorizer(maskParams(freeColor, fixedColor))
+    {
+    }
+
+private:
+    static Params maskParams(const vec4& freeColor, const vec4& fixedColor)
+    {
+        Params p;
+        p.min_color  = freeColor;
+        p.max_color  = fixedColor;
+        p.auto_range = false;
+        return p;
+    }
+};
+}
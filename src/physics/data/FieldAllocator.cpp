@@ -0,0 +1,71 @@
+#include "FieldAllocator.h"
+
+#include <cstdlib>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace dk {
+namespace {
+constexpr std::size_t kCacheLine     = 64;
+constexpr std::size_t kHugePageBytes = std::size_t(2) << 20;
+
+std::size_t roundUp(std::size_t v, std::size_t a) { return (v + a - 1) / a * a; }
+}
+
+void* allocateFieldMemory(std::size_t bytes)
+{
+    if (bytes == 0) bytes = 1;
+    const bool huge = bytes >= kHugePageBytes;
+
+#if defined(_WIN32)
+    if (huge)
+    {
+        // large page 需要进程持有 SeLockMemoryPrivilege，没有时回退到普通对齐分配
+        const SIZE_T large = GetLargePageMinimum();
+        if (large != 0)
+        {
+            if (void* p = VirtualAlloc(nullptr, roundUp(bytes, large), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                       PAGE_READWRITE))
+            {
+                return p;
+            }
+        }
+    }
+    void* p = _aligned_malloc(roundUp(bytes, kCacheLine), huge ? kHugePageBytes : kCacheLine);
+    if (!p) throw std::bad_alloc();
+    return p;
+#else
+    const std::size_t align = huge ? kHugePageBytes : kCacheLine;
+    void*             p     = std::aligned_alloc(align, roundUp(bytes, align));
+    if (!p) throw std::bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (huge) madvise(p, roundUp(bytes, align), MADV_HUGEPAGE);
+#endif
+    return p;
+#endif
+}
+
+void freeFieldMemory(void* p, std::size_t bytes) noexcept
+{
+    if (!p) return;
+#if defined(_WIN32)
+    // _aligned_malloc 返回的指针前面总有管理头，不会是一次 VirtualAlloc 的起点；
+    // 因此 AllocationBase == p 只可能是上面的 large page 分配
+    MEMORY_BASIC_INFORMATION info{};
+    if (bytes >= kHugePageBytes && VirtualQuery(p, &info, sizeof(info)) && info.AllocationBase == p)
+    {
+        VirtualFree(p, 0, MEM_RELEASE);
+        return;
+    }
+    _aligned_free(p);
+#else
+    (void)bytes;
+    std::free(p);
+#endif
+}
+} // namespace dk
@@ -0,0 +1,61 @@
+// data/FieldAllocator.h
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dk {
+// 大块（>= 2MB）按 2MB 对齐并请求大页（Linux: THP madvise；Windows: 有 SeLockMemoryPrivilege 时用 large page），
+// 其余按 cache line 对齐。失败时抛 std::bad_alloc
+void* allocateFieldMemory(std::size_t bytes);
+void  freeFieldMemory(void* p, std::size_t bytes) noexcept;
+
+/**
+ * 网格字段分配器.
+ * - 对齐分配，大字段请求大页
+ * - 无参 construct 只做默认初始化（不清零），resize 不会触碰内存页，
+ *   由调用方用并行循环完成首次触碰，让页面落在处理该 slab 的线程的 NUMA 节点上
+ */
+template <class T>
+class FieldAllocator
+{
+public:
+    using value_type = T;
+
+    FieldAllocator() noexcept = default;
+
+    template <class U>
+    FieldAllocator(const FieldAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(allocateFieldMemory(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        freeFieldMemory(p, n * sizeof(T));
+    }
+
+    template <class U>
+    void construct(U* p) noexcept
+    {
+        ::new(static_cast<void*>(p)) U; // 默认初始化，不写内存
+    }
+
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class U>
+    bool operator==(const FieldAllocator<U>&) const noexcept { return true; }
+};
+
+// MacGrid 等网格字段的存储类型
+using Field = std::vector<float, FieldAllocator<float>>;
+}
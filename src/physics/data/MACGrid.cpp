@@ -20,150 +20,148 @@ namespace dk {
         return lerp(c0, c1, fz);
     }
 
-    // 将世界坐标映射到 cell index + frac（中心网格）
-    static inline void worldToCell(const vec3& origin, float h, const vec3& x,
-        int& i, int& j, int& k, float& fx, float& fy, float& fz)
+    // 将世界坐标映射到给定布局网格的 index + frac（offset 为该布局采样点相对 cell 角点的偏移）
+    // 先按全局网格求下标，再减去 block 的全局偏移得到本地下标
+    static inline void worldToField(const vec3& origin, float h, const vec3& offset, const glm::ivec3& block,
+        const vec3& x, int& i, int& j, int& k, float& fx, float& fy, float& fz)
     {
-        vec3 p = (x - origin) / h - vec3(0.5f);
+        vec3 p = (x - origin) / h - offset;
         float xi = glm::floor(p.x);
         float yj = glm::floor(p.y);
         float zk = glm::floor(p.z);
-        i = (int)xi; j = (int)yj; k = (int)zk;
+        i = (int)xi - block.x; j = (int)yj - block.y; k = (int)zk - block.z;
         fx = p.x - xi; fy = p.y - yj; fz = p.z - zk;
     }
 
-    // 将世界坐标映射到 U/V/W 网格 index + frac
-    static inline void worldToU(const vec3& origin, float h, const vec3& x,
-        int& i, int& j, int& k, float& fx, float& fy, float& fz)
+    template <int Dim>
+    float MacGrid::sampleField(const Field& f, FieldKind kind, const vec3& x,
+        float* lo, float* hi) const
     {
-        vec3 p = (x - origin) / h - vec3(0.0f, 0.5f, 0.5f);
-        float xi = glm::floor(p.x);
-        float yj = glm::floor(p.y);
-        float zk = glm::floor(p.z);
-        i = (int)xi; j = (int)yj; k = (int)zk;
-        fx = p.x - xi; fy = p.y - yj; fz = p.z - zk;
-    }
+        int i, j, k; float fx, fy, fz;
+        worldToField(origin_, h_, fieldOffset(kind), offset_, clampToDomain<Dim>(x), i, j, k, fx, fy, fz);
 
-    static inline void worldToV(const vec3& origin, float h, const vec3& x,
-        int& i, int& j, int& k, float& fx, float& fy, float& fz)
-    {
-        vec3 p = (x - origin) / h - vec3(0.5f, 0.0f, 0.5f);
-        float xi = glm::floor(p.x);
-        float yj = glm::floor(p.y);
-        float zk = glm::floor(p.z);
-        i = (int)xi; j = (int)yj; k = (int)zk;
-        fx = p.x - xi; fy = p.y - yj; fz = p.z - zk;
+        // U: (nx+1, ny, nz)  V: (nx, ny+1, nz)  W: (nx, ny, nz+1)  Center: (nx, ny, nz)
+        const glm::ivec3 d = fieldDims(kind);
+        auto C = [&](int ii, int jj, int kk) -> float {
+            ii = std::clamp(ii, 0, d.x - 1);
+            jj = std::clamp(jj, 0, d.y - 1);
+            kk = std::clamp(kk, 0, d.z - 1);
+            return f[(static_cast<size_t>(kk) * d.y + jj) * d.x + ii];
+            };
+
+        if constexpr (Dim == 2)
+        {
+            // 单层网格：只取 k = 0 层的 4 个角点做双线性
+            float c00 = C(i, j, 0);
+            float c10 = C(i + 1, j, 0);
+            float c01 = C(i, j + 1, 0);
+            float c11 = C(i + 1, j + 1, 0);
+
+            if (lo && hi)
+            {
+                *lo = std::min({c00, c10, c01, c11});
+                *hi = std::max({c00, c10, c01, c11});
+            }
+            return lerp(lerp(c00, c10, fx), lerp(c01, c11, fx), fy);
+        }
+        else
+        {
+            float c000 = C(i, j, k);
+            float c100 = C(i + 1, j, k);
+            float c010 = C(i, j + 1, k);
+            float c110 = C(i + 1, j + 1, k);
+            float c001 = C(i, j, k + 1);
+            float c101 = C(i + 1, j, k + 1);
+            float c011 = C(i, j + 1, k + 1);
+            float c111 = C(i + 1, j + 1, k + 1);
+
+            if (lo && hi)
+            {
+                *lo = std::min({c000, c100, c010, c110, c001, c101, c011, c111});
+                *hi = std::max({c000, c100, c010, c110, c001, c101, c011, c111});
+            }
+            return trilerp(c000, c100, c010, c110, c001, c101, c011, c111, fx, fy, fz);
+        }
     }
 
-    static inline void worldToW(const vec3& origin, float h, const vec3& x,
-        int& i, int& j, int& k, float& fx, float& fy, float& fz)
+    template <int Dim>
+    MacGrid::SampleStencil MacGrid::sampleStencil(FieldKind kind, const vec3& x) const
     {
-        vec3 p = (x - origin) / h - vec3(0.5f, 0.5f, 0.0f);
-        float xi = glm::floor(p.x);
-        float yj = glm::floor(p.y);
-        float zk = glm::floor(p.z);
-        i = (int)xi; j = (int)yj; k = (int)zk;
-        fx = p.x - xi; fy = p.y - yj; fz = p.z - zk;
+        int i, j, k; float fx, fy, fz;
+        worldToField(origin_, h_, fieldOffset(kind), offset_, clampToDomain<Dim>(x), i, j, k, fx, fy, fz);
+
+        const glm::ivec3 d  = fieldDims(kind);
+        const int        i0 = std::clamp(i, 0, d.x - 1), i1 = std::clamp(i + 1, 0, d.x - 1);
+        const int        j0 = std::clamp(j, 0, d.y - 1), j1 = std::clamp(j + 1, 0, d.y - 1);
+        auto             I  = [&](int ii, int jj, int kk) { return (static_cast<size_t>(kk) * d.y + jj) * d.x + ii; };
+
+        SampleStencil st{};
+        if constexpr (Dim == 2)
+        {
+            // 前 4 个角点：c00 c10 c01 c11（k = 0 层）
+            st.idx[0] = I(i0, j0, 0); st.w[0] = (1 - fx) * (1 - fy);
+            st.idx[1] = I(i1, j0, 0); st.w[1] = fx * (1 - fy);
+            st.idx[2] = I(i0, j1, 0); st.w[2] = (1 - fx) * fy;
+            st.idx[3] = I(i1, j1, 0); st.w[3] = fx * fy;
+        }
+        else
+        {
+            const int k0 = std::clamp(k, 0, d.z - 1), k1 = std::clamp(k + 1, 0, d.z - 1);
+
+            // 角点顺序与 trilerp 一致：c000 c100 c010 c110 c001 c101 c011 c111
+            st.idx[0] = I(i0, j0, k0); st.w[0] = (1 - fx) * (1 - fy) * (1 - fz);
+            st.idx[1] = I(i1, j0, k0); st.w[1] = fx * (1 - fy) * (1 - fz);
+            st.idx[2] = I(i0, j1, k0); st.w[2] = (1 - fx) * fy * (1 - fz);
+            st.idx[3] = I(i1, j1, k0); st.w[3] = fx * fy * (1 - fz);
+            st.idx[4] = I(i0, j0, k1); st.w[4] = (1 - fx) * (1 - fy) * fz;
+            st.idx[5] = I(i1, j0, k1); st.w[5] = fx * (1 - fy) * fz;
+            st.idx[6] = I(i0, j1, k1); st.w[6] = (1 - fx) * fy * fz;
+            st.idx[7] = I(i1, j1, k1); st.w[7] = fx * fy * fz;
+        }
+        return st;
     }
 
     float MacGrid::sampleU(const vec3& x) const
     {
-        int i, j, k; float fx, fy, fz;
-        worldToU(origin_, h_, clampToDomain(x), i, j, k, fx, fy, fz);
-
-        // U 网格尺寸：(nx+1, ny, nz)
-        auto C = [&](int ii, int jj, int kk) -> float {
-            ii = std::clamp(ii, 0, nx_);
-            jj = std::clamp(jj, 0, ny_ - 1);
-            kk = std::clamp(kk, 0, nz_ - 1);
-            return U(ii, jj, kk);
-            };
-
-        float c000 = C(i, j, k);
-        float c100 = C(i + 1, j, k);
-        float c010 = C(i, j + 1, k);
-        float c110 = C(i + 1, j + 1, k);
-        float c001 = C(i, j, k + 1);
-        float c101 = C(i + 1, j, k + 1);
-        float c011 = C(i, j + 1, k + 1);
-        float c111 = C(i + 1, j + 1, k + 1);
-        return trilerp(c000, c100, c010, c110, c001, c101, c011, c111, fx, fy, fz);
+        return sampleField(u_, FieldKind::U, x);
     }
 
     float MacGrid::sampleV(const vec3& x) const
     {
-        int i, j, k; float fx, fy, fz;
-        worldToV(origin_, h_, clampToDomain(x), i, j, k, fx, fy, fz);
-
-        auto C = [&](int ii, int jj, int kk) -> float {
-            ii = std::clamp(ii, 0, nx_ - 1);
-            jj = std::clamp(jj, 0, ny_);
-            kk = std::clamp(kk, 0, nz_ - 1);
-            return V(ii, jj, kk);
-            };
-
-        float c000 = C(i, j, k);
-        float c100 = C(i + 1, j, k);
-        float c010 = C(i, j + 1, k);
-        float c110 = C(i + 1, j + 1, k);
-        float c001 = C(i, j, k + 1);
-        float c101 = C(i + 1, j, k + 1);
-        float c011 = C(i, j + 1, k + 1);
-        float c111 = C(i + 1, j + 1, k + 1);
-        return trilerp(c000, c100, c010, c110, c001, c101, c011, c111, fx, fy, fz);
+        return sampleField(v_, FieldKind::V, x);
     }
 
     float MacGrid::sampleW(const vec3& x) const
     {
-        int i, j, k; float fx, fy, fz;
-        worldToW(origin_, h_, clampToDomain(x), i, j, k, fx, fy, fz);
-
-        auto C = [&](int ii, int jj, int kk) -> float {
-            ii = std::clamp(ii, 0, nx_ - 1);
-            jj = std::clamp(jj, 0, ny_ - 1);
-            kk = std::clamp(kk, 0, nz_);
-            return W(ii, jj, kk);
-            };
-
-        float c000 = C(i, j, k);
-        float c100 = C(i + 1, j, k);
-        float c010 = C(i, j + 1, k);
-        float c110 = C(i + 1, j + 1, k);
-        float c001 = C(i, j, k + 1);
-        float c101 = C(i + 1, j, k + 1);
-        float c011 = C(i, j + 1, k + 1);
-        float c111 = C(i + 1, j + 1, k + 1);
-        return trilerp(c000, c100, c010, c110, c001, c101, c011, c111, fx, fy, fz);
+        return sampleField(w_, FieldKind::W, x);
     }
 
+    template <int Dim>
     vec3 MacGrid::sampleVelocity(const vec3& x) const
     {
-        float ux = sampleU(x);
-        float vy = sampleV(x);
-        float wz = sampleW(x);
-        return vec3(ux, vy, wz);
+        if constexpr (Dim == 2)
+        {
+            return vec3(sampleField<2>(u_, FieldKind::U, x), sampleField<2>(v_, FieldKind::V, x), 0.0f);
+        }
+        else
+        {
+            float ux = sampleU(x);
+            float vy = sampleV(x);
+            float wz = sampleW(x);
+            return vec3(ux, vy, wz);
+        }
     }
 
-    float MacGrid::sampleCellScalar(const std::vector<float>& s, const vec3& x) const
+    float MacGrid::sampleCellScalar(const Field& s, const vec3& x) const
     {
-        int i, j, k; float fx, fy, fz;
-        worldToCell(origin_, h_, clampToDomain(x), i, j, k, fx, fy, fz);
-        auto C = [&](int ii, int jj, int kk) -> float {
-            ii = std::clamp(ii, 0, nx_ - 1);
-            jj = std::clamp(jj, 0, ny_ - 1);
-            kk = std::clamp(kk, 0, nz_ - 1);
-            return s[idxP(ii, jj, kk)];
-            };
-
-        float c000 = C(i, j, k);
-        float c100 = C(i + 1, j, k);
-        float c010 = C(i, j + 1, k);
-        float c110 = C(i + 1, j + 1, k);
-        float c001 = C(i, j, k + 1);
-        float c101 = C(i + 1, j, k + 1);
-        float c011 = C(i, j + 1, k + 1);
-        float c111 = C(i + 1, j + 1, k + 1);
-        return trilerp(c000, c100, c010, c110, c001, c101, c011, c111, fx, fy, fz);
+        return sampleField(s, FieldKind::Center, x);
     }
 
+    template float MacGrid::sampleField<2>(const Field&, FieldKind, const vec3&, float*, float*) const;
+    template float MacGrid::sampleField<3>(const Field&, FieldKind, const vec3&, float*, float*) const;
+    template MacGrid::SampleStencil MacGrid::sampleStencil<2>(FieldKind, const vec3&) const;
+    template MacGrid::SampleStencil MacGrid::sampleStencil<3>(FieldKind, const vec3&) const;
+    template vec3 MacGrid::sampleVelocity<2>(const vec3&) const;
+    template vec3 MacGrid::sampleVelocity<3>(const vec3&) const;
+
 } // namespace dk
@@ -1,8 +1,12 @@
 // data/MacGrid.h
 #pragma once
 #include "Base.h"
+#include "Parallel.h"
+#include "data/FieldAllocator.h"
 #include <algorithm>
 #include <cassert>
+#include <string>
+#include <string_view>
 
 namespace dk {
 /**
@@ -12,27 +16,35 @@ namespace dk {
  *  - v: nx     * (ny+1) * nz     存 y-向量分量，位于 y-法向面中心
  *  - w: nx     * ny     * (nz+1) 存 z-向量分量，位于 z-法向面中心
  *  - p, div, dye: nx * ny * nz   存标量（中心）
+ *  - 额外的 cell-centred 标量通道（温度、密度、示踪剂等）按名字注册，与 dye 同布局
+ * nz == 1 视为 2D 网格：采样/钳制的 Dim = 2 版本只在 k = 0 层做双线性，忽略 z
+ * 下标一律 64 位；字段用 FieldAllocator 对齐分配（大字段请求大页），并按 slab 并行首次触碰
+ * 域分解时本网格只是全局网格的一块（见 setSubdomain）：位置、采样和钳制都按全局坐标，
+ * 求解器只更新 owned 区间，两端幽灵层由 HaloExchange 从邻居复制
  */
 class MacGrid : public ISimulationState
 {
 public:
+    // 字段布局：决定数组尺寸与采样点相对 cell 的偏移
+    enum class FieldKind { U, V, W, Center };
+
     MacGrid(int nx, int ny, int nz, float h, const vec3& origin = vec3(0))
-        : nx_(nx), ny_(ny), nz_(nz), h_(h), origin_(origin)
+        : nx_(nx), ny_(ny), nz_(nz), h_(h), origin_(origin), global_n_(nx, ny, nz)
     {
         assert(nx_ > 0 && ny_ > 0 && nz_ > 0 && h_ > 0);
-        u_.assign((nx_ + 1) * ny_ * nz_, 0.0f);
-        v_.assign(nx_ * (ny_ + 1) * nz_, 0.0f);
-        w_.assign(nx_ * ny_ * (nz_ + 1), 0.0f);
+        initField(u_, FieldKind::U);
+        initField(v_, FieldKind::V);
+        initField(w_, FieldKind::W);
 
-        p_.assign(nx_ * ny_ * nz_, 0.0f);
-        div_.assign(nx_ * ny_ * nz_, 0.0f);
-        dye_.assign(nx_ * ny_ * nz_, 0.0f);
+        initField(p_, FieldKind::Center);
+        initField(div_, FieldKind::Center);
+        initField(dye_, FieldKind::Center);
 
         // scratch
-        u_tmp_.assign(u_.size(), 0.0f);
-        v_tmp_.assign(v_.size(), 0.0f);
-        w_tmp_.assign(w_.size(), 0.0f);
-        p_tmp_.assign(p_.size(), 0.0f);
+        initField(u_tmp_, FieldKind::U);
+        initField(v_tmp_, FieldKind::V);
+        initField(w_tmp_, FieldKind::W);
+        initField(p_tmp_, FieldKind::Center);
     }
 
     // 尺寸/步长/原点
@@ -42,31 +54,138 @@ public:
     float h() const { return h_; }
     vec3  origin() const { return origin_; }
 
-    // --- 索引工具（行优先: x 最快） ---
-    int idxP(int i, int j, int k) const { return (k * ny_ + j) * nx_ + i; }
-    int idxU(int i, int j, int k) const { return (k * ny_ + j) * (nx_ + 1) + i; }
-    int idxV(int i, int j, int k) const { return (k * (ny_ + 1) + j) * nx_ + i; }
-    int idxW(int i, int j, int k) const { return ((k) * ny_ + j) * nx_ + i; }
+    // --- 域分解 ---
+    // global_dims：全局 cell 数；offset：本地下标 0 对应的全局下标；ghost_lo/hi：两端幽灵层厚度（cell 数）
+    // origin 仍是全局网格的原点。未调用时本网格就是整个域
+    void setSubdomain(const glm::ivec3& global_dims, const glm::ivec3& offset,
+                      const glm::ivec3& ghost_lo, const glm::ivec3& ghost_hi)
+    {
+        assert(glm::all(glm::greaterThanEqual(offset, glm::ivec3(0))));
+        assert(glm::all(glm::lessThanEqual(offset + glm::ivec3(nx_, ny_, nz_), global_dims)));
+        global_n_ = global_dims;
+        offset_   = offset;
+        ghost_lo_ = ghost_lo;
+        ghost_hi_ = ghost_hi;
+    }
+
+    const glm::ivec3& globalDims() const { return global_n_; }
+    const glm::ivec3& globalOffset() const { return offset_; }
+    const glm::ivec3& ghostLo() const { return ghost_lo_; }
+    const glm::ivec3& ghostHi() const { return ghost_hi_; }
+
+    // --- 索引工具（行优先: x 最快；64 位，支持超过 2^31 个采样点） ---
+    size_t idxP(int i, int j, int k) const { return (static_cast<size_t>(k) * ny_ + j) * nx_ + i; }
+    size_t idxU(int i, int j, int k) const { return (static_cast<size_t>(k) * ny_ + j) * (nx_ + 1) + i; }
+    size_t idxV(int i, int j, int k) const { return (static_cast<size_t>(k) * (ny_ + 1) + j) * nx_ + i; }
+    size_t idxW(int i, int j, int k) const { return (static_cast<size_t>(k) * ny_ + j) * nx_ + i; }
 
     // --- 位置（世界坐标） ---
+    // 下标先换算成全局下标，分块网格上的位置与整块网格逐位相同
     vec3 cellCenter(int i, int j, int k) const
     {
-        return origin_ + h_ * vec3(i + 0.5f, j + 0.5f, k + 0.5f);
+        return origin_ + h_ * vec3(i + offset_.x + 0.5f, j + offset_.y + 0.5f, k + offset_.z + 0.5f);
     }
 
     vec3 uFacePos(int i, int j, int k) const
     {
-        return origin_ + h_ * vec3(i, j + 0.5f, k + 0.5f);
+        return origin_ + h_ * vec3(i + offset_.x, j + offset_.y + 0.5f, k + offset_.z + 0.5f);
     }
 
     vec3 vFacePos(int i, int j, int k) const
     {
-        return origin_ + h_ * vec3(i + 0.5f, j, k + 0.5f);
+        return origin_ + h_ * vec3(i + offset_.x + 0.5f, j + offset_.y, k + offset_.z + 0.5f);
     }
 
     vec3 wFacePos(int i, int j, int k) const
     {
-        return origin_ + h_ * vec3(i + 0.5f, j + 0.5f, k);
+        return origin_ + h_ * vec3(i + offset_.x + 0.5f, j + offset_.y + 0.5f, k + offset_.z);
+    }
+
+    // --- 按布局的通用工具（高阶对流等需要对任意同布局数组操作） ---
+    glm::ivec3 fieldDims(FieldKind kind) const
+    {
+        switch (kind)
+        {
+        case FieldKind::U: return {nx_ + 1, ny_, nz_};
+        case FieldKind::V: return {nx_, ny_ + 1, nz_};
+        case FieldKind::W: return {nx_, ny_, nz_ + 1};
+        default: return {nx_, ny_, nz_};
+        }
+    }
+
+    // 面心布局在哪个轴上多一层（Center 返回 -1）
+    static int staggeredAxis(FieldKind kind)
+    {
+        switch (kind)
+        {
+        case FieldKind::U: return 0;
+        case FieldKind::V: return 1;
+        case FieldKind::W: return 2;
+        default: return -1;
+        }
+    }
+
+    glm::ivec3 globalFieldDims(FieldKind kind) const
+    {
+        glm::ivec3 d = global_n_;
+        if (const int a = staggeredAxis(kind); a >= 0) d[a] += 1;
+        return d;
+    }
+
+    // 本网格负责更新的下标区间 [ownedBegin, ownedEnd)，不含幽灵层；
+    // 两块之间的共享面归上面一块所有
+    glm::ivec3 ownedBegin(FieldKind) const { return ghost_lo_; }
+
+    glm::ivec3 ownedEnd(FieldKind kind) const
+    {
+        glm::ivec3 e = fieldDims(kind) - ghost_hi_;
+        if (const int a = staggeredAxis(kind); a >= 0 && ghost_hi_[a] > 0) e[a] -= 1;
+        return e;
+    }
+
+    size_t fieldIdx(FieldKind kind, int i, int j, int k) const
+    {
+        const glm::ivec3 d = fieldDims(kind);
+        return (static_cast<size_t>(k) * d.y + j) * d.x + i;
+    }
+
+    size_t fieldSize(FieldKind kind) const
+    {
+        const glm::ivec3 d = fieldDims(kind);
+        return static_cast<size_t>(d.x) * d.y * d.z;
+    }
+
+    // 按求解器的 slab 切分并行写入初值（首次触碰），见 parallelForGrid
+    void initField(Field& f, FieldKind kind, float value = 0.0f) const
+    {
+        f.resize(fieldSize(kind)); // FieldAllocator 不清零，这里不会碰到页面
+        const glm::ivec3 d = fieldDims(kind);
+        auto fill = [&](int i, int j, int k) { f[(static_cast<size_t>(k) * d.y + j) * d.x + i] = value; };
+        if (nz_ == 1)
+        {
+            parallelForGrid<2>(d, fill);
+        }
+        else
+        {
+            parallelForGrid<3>(d, fill);
+        }
+    }
+
+    // 采样点相对 origin 的偏移（单位：h）
+    static vec3 fieldOffset(FieldKind kind)
+    {
+        switch (kind)
+        {
+        case FieldKind::U: return {0.0f, 0.5f, 0.5f};
+        case FieldKind::V: return {0.5f, 0.0f, 0.5f};
+        case FieldKind::W: return {0.5f, 0.5f, 0.0f};
+        default: return vec3(0.5f);
+        }
+    }
+
+    vec3 fieldPos(FieldKind kind, int i, int j, int k) const
+    {
+        return origin_ + h_ * (vec3(glm::ivec3(i, j, k) + offset_) + fieldOffset(kind));
     }
 
     // --- clamp index 到合法范围 ---
@@ -92,43 +211,119 @@ public:
     float& Dye(int i, int j, int k) { return dye_[idxP(i, j, k)]; }
     float  Dye(int i, int j, int k) const { return dye_[idxP(i, j, k)]; }
 
+    // --- 通用标量通道（cell center，与 dye 同布局） ---
+    // 返回通道 id；同名通道已存在时直接返回其 id。注册新通道会使之前取得的 scalar() 引用失效
+    int addScalarChannel(std::string_view name, float init = 0.0f)
+    {
+        if (int id = scalarChannelId(name); id >= 0) return id;
+        scalar_names_.emplace_back(name);
+        initField(scalars_.emplace_back(), FieldKind::Center, init);
+        return static_cast<int>(scalars_.size()) - 1;
+    }
+
+    // 不存在时返回 -1
+    int scalarChannelId(std::string_view name) const
+    {
+        for (size_t c = 0; c < scalar_names_.size(); ++c)
+        {
+            if (scalar_names_[c] == name) return static_cast<int>(c);
+        }
+        return -1;
+    }
+
+    int                scalarChannelCount() const { return static_cast<int>(scalars_.size()); }
+    const std::string& scalarChannelName(int id) const { return scalar_names_[id]; }
+
+    Field&       scalar(int id) { return scalars_[id]; }
+    const Field& scalar(int id) const { return scalars_[id]; }
+
+    float& Scalar(int id, int i, int j, int k) { return scalars_[id][idxP(i, j, k)]; }
+    float  Scalar(int id, int i, int j, int k) const { return scalars_[id][idxP(i, j, k)]; }
+
     // --- 速度采样（半拉格朗日用） ---
-    // 注意：各分量在各自网格上做三线性插值
+    // 注意：各分量在各自网格上做三线性插值（Dim = 2 时为双线性，z 分量恒为 0）
+    template <int Dim = 3>
     vec3 sampleVelocity(const vec3& x) const;
 
     // --- 标量在 cell center 上的三线性采样（用于染料、压力等可选） ---
-    float sampleCellScalar(const std::vector<float>& s, const vec3& x) const;
+    float sampleCellScalar(const Field& s, const vec3& x) const;
+
+    // 三线性采样模板：8 个角点的线性下标与权重，对同布局的多个数组复用一次回溯
+    struct SampleStencil
+    {
+        size_t idx[8];
+        float  w[8];
+    };
+
+    template <int Dim = 3>
+    SampleStencil sampleStencil(FieldKind kind, const vec3& x) const;
+
+    template <int Dim = 3>
+    static float applyStencil(const SampleStencil& st, const Field& f,
+                              float* lo = nullptr, float* hi = nullptr)
+    {
+        // 2D 模板只有前 4 个角点有效
+        constexpr int corners = Dim == 3 ? 8 : 4;
 
-    // --- clamp 物理坐标到可采样域 ---
+        float sum = 0.0f;
+        float mn  = f[st.idx[0]];
+        float mx  = mn;
+        for (int c = 0; c < corners; ++c)
+        {
+            const float val = f[st.idx[c]];
+            sum += st.w[c] * val;
+            mn = std::min(mn, val);
+            mx = std::max(mx, val);
+        }
+        if (lo && hi)
+        {
+            *lo = mn;
+            *hi = mx;
+        }
+        return sum;
+    }
+
+    // --- 任意布局数组的三线性采样；lo/hi 非空时顺带返回 8 个角点的最小/最大值（限制器用） ---
+    template <int Dim = 3>
+    float sampleField(const Field& f, FieldKind kind, const vec3& x,
+                      float* lo = nullptr, float* hi = nullptr) const;
+
+    // --- clamp 物理坐标到可采样域（全局域） ---
+    template <int Dim = 3>
     vec3 clampToDomain(const vec3& x) const
     {
         // 留 1.5h 的 margin，避免越界插值
         const float eps  = 1.5f * h_;
         vec3        minp = origin_ + vec3(eps);
-        vec3        maxp = origin_ + vec3(nx_ * h_ - eps, ny_ * h_ - eps, nz_ * h_ - eps);
-        return clamp(x, minp, maxp);
+        vec3        maxp = origin_ + vec3(global_n_.x * h_ - eps, global_n_.y * h_ - eps, global_n_.z * h_ - eps);
+        vec3        c    = clamp(x, minp, maxp);
+        if constexpr (Dim == 2)
+        {
+            c.z = x.z; // 单层网格不在 z 上插值
+        }
+        return c;
     }
 
     // --- 对外暴露数据（给 solver 用） ---
-    std::vector<float>& u() { return u_; }
-    std::vector<float>& v() { return v_; }
-    std::vector<float>& w() { return w_; }
-    std::vector<float>& p() { return p_; }
-    std::vector<float>& div() { return div_; }
-    std::vector<float>& dye() { return dye_; }
-
-    const std::vector<float>& u() const { return u_; }
-    const std::vector<float>& v() const { return v_; }
-    const std::vector<float>& w() const { return w_; }
-    const std::vector<float>& p() const { return p_; }
-    const std::vector<float>& div() const { return div_; }
-    const std::vector<float>& dye() const { return dye_; }
+    Field& u() { return u_; }
+    Field& v() { return v_; }
+    Field& w() { return w_; }
+    Field& p() { return p_; }
+    Field& div() { return div_; }
+    Field& dye() { return dye_; }
+
+    const Field& u() const { return u_; }
+    const Field& v() const { return v_; }
+    const Field& w() const { return w_; }
+    const Field& p() const { return p_; }
+    const Field& div() const { return div_; }
+    const Field& dye() const { return dye_; }
 
     // scratch
-    std::vector<float>& u_tmp() { return u_tmp_; }
-    std::vector<float>& v_tmp() { return v_tmp_; }
-    std::vector<float>& w_tmp() { return w_tmp_; }
-    std::vector<float>& p_tmp() { return p_tmp_; }
+    Field& u_tmp() { return u_tmp_; }
+    Field& v_tmp() { return v_tmp_; }
+    Field& w_tmp() { return w_tmp_; }
+    Field& p_tmp() { return p_tmp_; }
 
     // 分量三线性（内部工具）
     float sampleU(const vec3& x) const;
@@ -141,12 +336,20 @@ private:
     float h_;
     vec3  origin_;
 
+    // 域分解信息；整块网格时 global_n_ = (nx, ny, nz)，其余为 0
+    glm::ivec3 global_n_;
+    glm::ivec3 offset_{0}, ghost_lo_{0}, ghost_hi_{0};
+
     // 主字段
-    std::vector<float> u_, v_, w_;
-    std::vector<float> p_, div_;
-    std::vector<float> dye_;
+    Field u_, v_, w_;
+    Field p_, div_;
+    Field dye_;
+
+    // 额外标量通道
+    std::vector<Field>       scalars_;
+    std::vector<std::string> scalar_names_;
 
     // 临时缓存
-    std::vector<float> u_tmp_, v_tmp_, w_tmp_, p_tmp_;
+    Field u_tmp_, v_tmp_, w_tmp_, p_tmp_;
 };
 } // namespace dk
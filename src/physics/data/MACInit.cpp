@@ -18,6 +18,10 @@ void ClearAll(MacGrid& g)
     std::fill(g.p().begin(), g.p().end(), 0.0f);
     std::fill(g.div().begin(), g.div().end(), 0.0f);
     std::fill(g.dye().begin(), g.dye().end(), 0.0f);
+    for (int c = 0; c < g.scalarChannelCount(); ++c)
+    {
+        std::fill(g.scalar(c).begin(), g.scalar(c).end(), 0.0f);
+    }
 }
 
 void FillDyeBox_World(MacGrid& g, const vec3& minW, const vec3& maxW, float value)
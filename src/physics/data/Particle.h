@@ -1,8 +1,18 @@
 #pragma once
 #include "Base.h"
+#include <atomic>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 namespace dk {
+// 数据版本号：全局递增，不同对象之间、同一对象改动前后都不会重号。
+// 求解器的缓存记下建立时的版本号，之后比较版本号而不是逐项比较数组
+inline std::uint64_t nextDataVersion()
+{
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+}
 struct PointData
 {
     glm::vec4 position;
@@ -10,6 +20,34 @@ struct PointData
 };
 
 
+// ParticleData::addParticles 返回的批量写入视图，覆盖新加入的 [base, base + size()) 区间.
+// 速度、力、颜色、SPH 属性等已经按默认值填好；位置由调用方写入，不同下标可以并行写。
+struct ParticleBuilder
+{
+    size_t               base = 0;
+    std::span<glm::vec3> position;
+    std::span<glm::vec3> previous_position;
+    std::span<float>     mass;
+    std::span<float>     inv_mass;
+
+    size_t size() const { return position.size(); }
+    size_t index(size_t k) const { return base + k; }
+
+    // 同时写位置和上一步位置（与 addParticle 一致）
+    void place(size_t k, const glm::vec3& pos) const
+    {
+        position[k]          = pos;
+        previous_position[k] = pos;
+    }
+
+    // 单独设置质量；is_fixed 是位向量，固定点要回到 ParticleData 上串行设置
+    void setMass(size_t k, float m) const
+    {
+        mass[k]     = m;
+        inv_mass[k] = 1.0f / m;
+    }
+};
+
 // 使用SoA (Struct of Arrays) 存储质点数据
 // 优点: 内存访问连续，缓存命中率高，非常适合SIMD优化
 struct ParticleData
@@ -23,6 +61,16 @@ struct ParticleData
     std::vector<float>     inv_mass; // 质量的倒数，方便计算加速度
     std::vector<vec4>      color; // 质量的倒数，方便计算加速度
     std::vector<bool>      is_fixed; // 是否固定
+    std::vector<bool>      is_sleeping; // 所在的弹簧连通块已休眠（见 SleepIslands），力、积分和约束都跳过它
+    std::vector<bool>      is_dead;     // 槽位已被 ParticlePool 回收，等待复用；求解器、宽相网格和休眠岛都跳过它
+
+    // 版本号（见 nextDataVersion）。增删质点、改 mass / inv_mass / is_fixed / is_dead 后调用 markChanged，
+    // 改 is_sleeping 后调用 markSleepChanged；add* 会自动递增
+    std::uint64_t version       = nextDataVersion();
+    std::uint64_t sleep_version = nextDataVersion();
+
+    void markChanged() { version = nextDataVersion(); }
+    void markSleepChanged() { sleep_version = nextDataVersion(); }
 
     // --- SPH 新增核心属性 ---
     std::vector<float> density;     // 密度 (ρ)
@@ -44,15 +92,67 @@ struct ParticleData
         inv_mass.push_back(1.0f / m);
         color.emplace_back(0, 0, 0, 1);
         is_fixed.push_back(fixed);
+        is_sleeping.push_back(false);
+        is_dead.push_back(false);
 
         // 初始化SPH属性
         density.push_back(0.0f);
         pressure.push_back(0.0f);
         neighbors.emplace_back(); // 添加一个空的邻居列表
 
+        markChanged();
+        markSleepChanged();
         return position.size() - 1;
     }
 
+    // 为之后的 addParticle 预留容量
+    void reserve(size_t n)
+    {
+        position.reserve(n);
+        previous_position.reserve(n);
+        velocity.reserve(n);
+        acceleration.reserve(n);
+        force.reserve(n);
+        mass.reserve(n);
+        inv_mass.reserve(n);
+        color.reserve(n);
+        is_fixed.reserve(n);
+        is_sleeping.reserve(n);
+        is_dead.reserve(n);
+        density.reserve(n);
+        pressure.reserve(n);
+        neighbors.reserve(n);
+    }
+
+    // 一次添加 count 个质量为 m 的质点，每个数组只扩容一次；位置为零，由返回的视图填写
+    ParticleBuilder addParticles(size_t count, const float m, const bool fixed = false)
+    {
+        const size_t base = size();
+        const size_t n    = base + count;
+        position.resize(n, glm::vec3(0.0f));
+        previous_position.resize(n, glm::vec3(0.0f));
+        velocity.resize(n, glm::vec3(0.0f));
+        acceleration.resize(n, glm::vec3(0.0f));
+        force.resize(n, glm::vec3(0.0f));
+        mass.resize(n, m);
+        inv_mass.resize(n, 1.0f / m);
+        color.resize(n, vec4(0, 0, 0, 1));
+        is_fixed.resize(n, fixed);
+        is_sleeping.resize(n, false);
+        is_dead.resize(n, false);
+        density.resize(n, 0.0f);
+        pressure.resize(n, 0.0f);
+        neighbors.resize(n);
+        markChanged();
+        markSleepChanged();
+
+        return {base,
+                std::span(position).subspan(base),
+                std::span(previous_position).subspan(base),
+                std::span(mass).subspan(base),
+                std::span(inv_mass).subspan(base)};
+    }
+
     size_t size() const
     {
         return position.size();
@@ -62,6 +162,32 @@ struct ParticleData
     {
         return position.empty();
     }
+
+    // 既没有固定、休眠，也不是死槽位，需要受力和积分
+    bool isActive(size_t i) const
+    {
+        return !is_fixed[i] && !is_sleeping[i] && !is_dead[i];
+    }
+};
+
+// Spring::addSprings 返回的批量写入视图，不同下标可以并行写
+struct SpringBuilder
+{
+    size_t            base = 0;
+    std::span<size_t> index_a;
+    std::span<size_t> index_b;
+    std::span<float>  stiffness;
+    std::span<float>  rest_length;
+
+    size_t size() const { return index_a.size(); }
+
+    void set(size_t k, size_t idxA, size_t idxB, float ks, float l) const
+    {
+        index_a[k]     = idxA;
+        index_b[k]     = idxB;
+        stiffness[k]   = ks;
+        rest_length[k] = l;
+    }
 };
 
 // 弹簧的拓扑结构数据
@@ -71,6 +197,10 @@ struct Spring
     std::vector<size_t> index_b; // 连接的质点索引B
     std::vector<float>  stiffness; // 弹性系数
     std::vector<float>  rest_length; // 自然长度
+    // 版本号（见 nextDataVersion）：直接改了上面任何一个数组后调用 markChanged，addSpring / addSprings 会自动递增
+    std::uint64_t version = nextDataVersion();
+
+    void markChanged() { version = nextDataVersion(); }
 
     size_t size() const
     {
@@ -83,6 +213,62 @@ struct Spring
         index_b.push_back(idxB);
         stiffness.push_back(k);
         rest_length.push_back(l);
+        markChanged();
+    }
+
+    void reserve(size_t n)
+    {
+        index_a.reserve(n);
+        index_b.reserve(n);
+        stiffness.reserve(n);
+        rest_length.reserve(n);
+    }
+
+    // 一次追加 count 根弹簧，内容由返回的视图填写
+    SpringBuilder addSprings(size_t count)
+    {
+        const size_t base = size();
+        const size_t n    = base + count;
+        index_a.resize(n);
+        index_b.resize(n);
+        stiffness.resize(n);
+        rest_length.resize(n);
+        markChanged();
+        return {base,
+                std::span(index_a).subspan(base),
+                std::span(index_b).subspan(base),
+                std::span(stiffness).subspan(base),
+                std::span(rest_length).subspan(base)};
+    }
+};
+
+// 布料等表面的三角形拓扑（每三个下标一组），用于三角形级别的自碰撞
+struct TriangleTopology
+{
+    std::vector<uint32_t> indices;
+    // 版本号（见 nextDataVersion）：直接改了 indices 后调用 markChanged，addTriangle / addTriangles 会自动递增
+    std::uint64_t version = nextDataVersion();
+
+    void markChanged() { version = nextDataVersion(); }
+
+    size_t size() const { return indices.size() / 3; }
+    bool   empty() const { return indices.empty(); }
+
+    void addTriangle(size_t a, size_t b, size_t c)
+    {
+        indices.push_back(static_cast<uint32_t>(a));
+        indices.push_back(static_cast<uint32_t>(b));
+        indices.push_back(static_cast<uint32_t>(c));
+        markChanged();
+    }
+
+    // 一次追加 count 个三角形，返回新三角形的 3·count 个下标，不同三角形可以并行写
+    std::span<uint32_t> addTriangles(size_t count)
+    {
+        const size_t base = indices.size();
+        indices.resize(base + 3 * count);
+        markChanged();
+        return std::span(indices).subspan(base);
     }
 };
 
@@ -90,10 +276,11 @@ struct Spring
 class ParticleSystemState : public ISimulationState
 {
 public:
-    ParticleData& particles;
-    Spring&       springs;
+    ParticleData&           particles;
+    Spring&                 springs;
+    const TriangleTopology* triangles; // 没有三角形拓扑时为 nullptr
 
-    ParticleSystemState(ParticleData& p, Spring& s) : particles(p), springs(s)
+    ParticleSystemState(ParticleData& p, Spring& s, const TriangleTopology* t = nullptr) : particles(p), springs(s), triangles(t)
     {
     }
 };
@@ -0,0 +1,366 @@
+// data/ParticlePool.cpp
+#include "data/ParticlePool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Parallel.h"
+
+namespace dk {
+namespace {
+template <class Fn>
+void forEachIndex(size_t n, Fn&& fn)
+{
+    parallelForSlabs(0, static_cast<i64>(n), [&](i64 b, i64 e)
+    {
+        for (i64 i = b; i < e; ++i) fn(static_cast<size_t>(i));
+    });
+}
+
+// 按 map 改写下标，map 返回 kNone 的端点所在的弹簧/三角形被删除；保留下来的顺序不变。
+// 被删弹簧仍存活的一端（新下标）追加到 lost。有删除时递增版本号；只改写下标（压实）时由调用方递增
+template <class Map>
+void remapSprings(Spring& springs, std::vector<uint8_t>& drop, std::vector<size_t>& lost, Map&& map)
+{
+    const size_t count = springs.size();
+    drop.resize(count);
+    forEachIndex(count, [&](size_t s)
+    {
+        const size_t a = map(springs.index_a[s]), b = map(springs.index_b[s]);
+        drop[s]        = a == ParticlePool::kNone || b == ParticlePool::kNone;
+        if (!drop[s])
+        {
+            springs.index_a[s] = a;
+            springs.index_b[s] = b;
+        }
+    });
+    if (std::find(drop.begin(), drop.end(), 1) == drop.end()) return;
+
+    size_t kept = 0;
+    for (size_t s = 0; s < count; ++s)
+    {
+        if (drop[s])
+        {
+            for (size_t end : {springs.index_a[s], springs.index_b[s]})
+                if (const size_t m = map(end); m != ParticlePool::kNone) lost.push_back(m);
+            continue;
+        }
+        springs.index_a[kept]     = springs.index_a[s];
+        springs.index_b[kept]     = springs.index_b[s];
+        springs.stiffness[kept]   = springs.stiffness[s];
+        springs.rest_length[kept] = springs.rest_length[s];
+        ++kept;
+    }
+    springs.index_a.resize(kept);
+    springs.index_b.resize(kept);
+    springs.stiffness.resize(kept);
+    springs.rest_length.resize(kept);
+    springs.markChanged();
+}
+
+template <class Map>
+void remapTriangles(TriangleTopology& triangles, std::vector<uint8_t>& drop, Map&& map)
+{
+    const size_t count = triangles.size();
+    drop.resize(count);
+    forEachIndex(count, [&](size_t t)
+    {
+        uint32_t* v = &triangles.indices[3 * t];
+        size_t    m[3];
+        for (int k = 0; k < 3; ++k) m[k] = map(v[k]);
+        drop[t] = m[0] == ParticlePool::kNone || m[1] == ParticlePool::kNone || m[2] == ParticlePool::kNone;
+        if (!drop[t])
+            for (int k = 0; k < 3; ++k) v[k] = static_cast<uint32_t>(m[k]);
+    });
+    if (std::find(drop.begin(), drop.end(), 1) == drop.end()) return;
+
+    size_t kept = 0;
+    for (size_t t = 0; t < count; ++t)
+    {
+        if (drop[t]) continue;
+        for (int k = 0; k < 3; ++k) triangles.indices[3 * kept + k] = triangles.indices[3 * t + k];
+        ++kept;
+    }
+    triangles.indices.resize(3 * kept);
+    triangles.markChanged();
+}
+
+// 缩短到 n 个质点；只缩不扩，不会重新分配
+void truncate(ParticleData& data, size_t n)
+{
+    data.position.resize(n);
+    data.previous_position.resize(n);
+    data.velocity.resize(n);
+    data.acceleration.resize(n);
+    data.force.resize(n);
+    data.mass.resize(n);
+    data.inv_mass.resize(n);
+    data.color.resize(n);
+    data.is_fixed.resize(n);
+    data.is_sleeping.resize(n);
+    data.is_dead.resize(n);
+    data.density.resize(n);
+    data.pressure.resize(n);
+    data.neighbors.resize(n);
+}
+}
+
+void ParticlePool::reserve(ParticleData& data, const size_t capacity)
+{
+    data.reserve(capacity);
+    alive_.reserve(capacity);
+    handle_of_slot_.reserve(capacity);
+    age_.reserve(capacity);
+    lifetime_.reserve(capacity);
+    free_.reserve(capacity);
+    slot_of_handle_.reserve(capacity);
+    generation_.reserve(capacity);
+    free_handles_.reserve(capacity);
+    remap_.reserve(capacity);
+    holes_.reserve(capacity);
+    movers_.reserve(capacity);
+    touched_.reserve(capacity);
+    touched_mask_.reserve(capacity);
+    lost_.reserve(capacity);
+    change_remap_.reserve(capacity);
+}
+
+uint32_t ParticlePool::newHandle(const size_t slot)
+{
+    uint32_t id;
+    if (!free_handles_.empty())
+    {
+        id = free_handles_.back();
+        free_handles_.pop_back();
+        slot_of_handle_[id] = slot;
+    }
+    else
+    {
+        id = static_cast<uint32_t>(slot_of_handle_.size());
+        slot_of_handle_.push_back(slot);
+        generation_.push_back(0);
+    }
+    return id;
+}
+
+void ParticlePool::touch(const size_t slot)
+{
+    if (touched_mask_.size() <= slot) touched_mask_.resize(alive_.size(), 0);
+    if (touched_mask_[slot]) return;
+    touched_mask_[slot] = 1;
+    touched_.push_back(slot);
+}
+
+void ParticlePool::clearChanges()
+{
+    for (size_t s : touched_) touched_mask_[s] = 0;
+    touched_.clear();
+    remapped_ = false;
+}
+
+void ParticlePool::adopt(const ParticleData& data)
+{
+    if (data.size() < alive_.size()) throw std::runtime_error("ParticlePool: particles were removed outside the pool");
+    for (size_t s = alive_.size(); s < data.size(); ++s)
+    {
+        alive_.push_back(1);
+        handle_of_slot_.push_back(newHandle(s));
+        age_.push_back(0.0f);
+        lifetime_.push_back(std::numeric_limits<float>::infinity());
+    }
+}
+
+ParticleHandle ParticlePool::spawn(ParticleData& data, const vec3& pos, const vec3& vel, const float mass, const float lifetime)
+{
+    adopt(data);
+
+    size_t slot;
+    if (!free_.empty())
+    {
+        slot = free_.back();
+        free_.pop_back();
+        data.position[slot]          = pos;
+        data.previous_position[slot] = pos;
+        data.acceleration[slot]      = vec3(0.0f);
+        data.force[slot]             = vec3(0.0f);
+        data.mass[slot]              = mass;
+        data.inv_mass[slot]          = 1.0f / mass;
+        data.color[slot]             = vec4(0, 0, 0, 1);
+        data.is_fixed[slot]          = false;
+        data.is_sleeping[slot]       = false;
+        data.is_dead[slot]           = false;
+        data.density[slot]           = 0.0f;
+        data.pressure[slot]          = 0.0f;
+        data.neighbors[slot].clear();
+        data.markChanged();
+        alive_[slot]          = 1;
+        handle_of_slot_[slot] = newHandle(slot);
+        age_[slot]            = 0.0f;
+        lifetime_[slot]       = lifetime;
+    }
+    else
+    {
+        slot = data.addParticle(pos, mass);
+        alive_.push_back(1);
+        handle_of_slot_.push_back(newHandle(slot));
+        age_.push_back(0.0f);
+        lifetime_.push_back(lifetime);
+    }
+    data.velocity[slot] = vel;
+    touch(slot);
+    return handle(slot);
+}
+
+size_t ParticlePool::slot(const ParticleHandle h) const
+{
+    if (h.id >= slot_of_handle_.size() || generation_[h.id] != h.generation) return kNone;
+    return slot_of_handle_[h.id];
+}
+
+bool ParticlePool::kill(ParticleData& data, const ParticleHandle h)
+{
+    const size_t s = slot(h);
+    if (s == kNone) return false;
+    killSlot(data, s);
+    return true;
+}
+
+void ParticlePool::killSlot(ParticleData& data, const size_t slot)
+{
+    adopt(data);
+    if (!alive_[slot]) return;
+
+    const uint32_t id = handle_of_slot_[slot];
+    ++generation_[id];
+    slot_of_handle_[id] = kNone;
+    free_handles_.push_back(id);
+    alive_[slot] = 0;
+    free_.push_back(slot);
+
+    data.position[slot]          = params_.graveyard;
+    data.previous_position[slot] = params_.graveyard;
+    data.velocity[slot]          = vec3(0.0f);
+    data.acceleration[slot]      = vec3(0.0f);
+    data.force[slot]             = vec3(0.0f);
+    data.inv_mass[slot]          = 0.0f; // 删边之前连着它的约束把它当成不可移动
+    if (data.is_sleeping[slot]) data.markSleepChanged();
+    data.is_sleeping[slot]       = false;
+    data.is_dead[slot]           = true;
+    data.markChanged();
+    killed_since_maintain_       = true;
+}
+
+void ParticlePool::advanceAges(const float dt)
+{
+    forEachIndex(alive_.size(), [&](size_t s)
+    {
+        if (alive_[s]) age_[s] += dt;
+    });
+}
+
+void ParticlePool::maintain(ParticleData& data, Spring* springs, TriangleTopology* triangles)
+{
+    adopt(data);
+    if (!free_.empty() && static_cast<float>(free_.size()) > params_.compact_ratio * static_cast<float>(alive_.size()))
+    {
+        compact(data, springs, triangles);
+        return;
+    }
+    if (!killed_since_maintain_) return;
+
+    // 不压实时下标不变，只删掉连着死质点的弹簧和三角形，免得活质点被拴在 graveyard 上
+    auto map = [&](size_t i) { return alive_[i] ? i : kNone; };
+    if (springs)
+    {
+        lost_.clear();
+        remapSprings(*springs, drop_, lost_, map);
+        for (size_t s : lost_) touch(s);
+    }
+    if (triangles) remapTriangles(*triangles, drop_, map);
+    killed_since_maintain_ = false;
+}
+
+void ParticlePool::compact(ParticleData& data, Spring* springs, TriangleTopology* triangles)
+{
+    adopt(data);
+    killed_since_maintain_ = false;
+    if (free_.empty()) return;
+
+    // 前部的空洞和尾部的存活质点一样多，一一配对；源都在 [m, n)、目标都在 [0, m)，互不重叠，可以并行搬
+    const size_t n = alive_.size();
+    const size_t m = aliveCount();
+    holes_.clear();
+    for (size_t s : free_)
+        if (s < m) holes_.push_back(s);
+    std::sort(holes_.begin(), holes_.end());
+    movers_.clear();
+    for (size_t s = m; s < n; ++s)
+        if (alive_[s]) movers_.push_back(s);
+
+    remap_.resize(n);
+    forEachIndex(n, [&](size_t s) { remap_[s] = alive_[s] ? s : kNone; });
+
+    forEachIndex(movers_.size(), [&](size_t k)
+    {
+        const size_t from = movers_[k], to = holes_[k];
+        remap_[from]               = to;
+        data.position[to]          = data.position[from];
+        data.previous_position[to] = data.previous_position[from];
+        data.velocity[to]          = data.velocity[from];
+        data.acceleration[to]      = data.acceleration[from];
+        data.force[to]             = data.force[from];
+        data.mass[to]              = data.mass[from];
+        data.inv_mass[to]          = data.inv_mass[from];
+        data.color[to]             = data.color[from];
+        data.density[to]           = data.density[from];
+        data.pressure[to]          = data.pressure[from];
+        data.neighbors[to].swap(data.neighbors[from]);
+        alive_[to]          = 1;
+        age_[to]            = age_[from];
+        lifetime_[to]       = lifetime_[from];
+        handle_of_slot_[to] = handle_of_slot_[from];
+        slot_of_handle_[handle_of_slot_[to]] = to;
+    });
+    // 位向量不能并行写
+    for (size_t k = 0; k < movers_.size(); ++k)
+    {
+        data.is_fixed[holes_[k]]    = data.is_fixed[movers_[k]];
+        data.is_sleeping[holes_[k]] = data.is_sleeping[movers_[k]];
+        data.is_dead[holes_[k]]     = false;
+    }
+
+    truncate(data, m);
+    data.markChanged();
+    data.markSleepChanged();
+    alive_.resize(m);
+    handle_of_slot_.resize(m);
+    age_.resize(m);
+    lifetime_.resize(m);
+    free_.clear();
+
+    // 未取走的变化改成新下标；连续压实时旧下标 -> 新下标的映射串起来
+    if (remapped_)
+        for (size_t& s : change_remap_) s = s == kNone ? kNone : remap_[s];
+    else change_remap_.assign(remap_.begin(), remap_.end());
+    remapped_ = true;
+    lost_.clear();
+    for (size_t s : touched_)
+        if (remap_[s] != kNone) lost_.push_back(remap_[s]);
+    touched_.clear();
+    touched_mask_.assign(m, 0);
+
+    auto map = [&](size_t i) { return remap_[i]; };
+    if (springs)
+    {
+        remapSprings(*springs, drop_, lost_, map);
+        springs->markChanged(); // 没有删边时下标也换成了新的
+    }
+    if (triangles)
+    {
+        remapTriangles(*triangles, drop_, map);
+        triangles->markChanged();
+    }
+    for (size_t s : lost_) touch(s);
+    ++compactions_;
+}
+}
@@ -0,0 +1,124 @@
+// data/ParticlePool.h
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "Particle.h"
+
+namespace dk {
+// 指向池中一个质点的稳定句柄；压实搬动质点后仍然有效，质点死亡后 generation 对不上即失效
+struct ParticleHandle
+{
+    uint32_t id         = ~0u;
+    uint32_t generation = 0;
+};
+
+// 池自上次 clearChanges 以来的槽位变化，给按下标缓存状态的结构（SleepIslands）增量更新用
+struct SlotChanges
+{
+    std::span<const size_t> touched; // 新生成的质点和因死质点被删掉弹簧的存活质点，当前下标，不重复
+    std::span<const size_t> remap;   // 期间压实过时为旧下标 -> 新下标（死槽位为 ParticlePool::kNone），否则为空
+};
+
+/**
+ * 建在 ParticleData 之上的槽位池，给喷溅、泡沫、碎屑这类高频生灭的粒子用.
+ * - spawn 优先从空闲链表取槽位，没有时追加：O(1)；reserve 过容量后不再分配内存
+ * - kill 把槽位放回空闲链表：O(1)。死槽位 is_dead 置位、inv_mass 和速度清零、停到 graveyard，
+ *   力、积分器、碰撞、宽相网格和休眠岛都跳过它；连着它的弹簧和三角形在下一次 maintain 时删除。
+ *   is_fixed 不动，生灭不会被当成固定点的变化
+ * - 生成的槽位和被删边的存活质点记在 changes() 里，SleepIslands 只唤醒受影响的岛
+ * - 死槽位比例超过 compact_ratio 时压实：尾部的存活质点并行搬进前部的空洞，数组缩回存活数，
+ *   不改变其余质点的顺序；弹簧、三角形下标随之重映射，句柄表同步更新
+ * - 改动质点、弹簧或三角形时递增它们的版本号，求解器的缓存据此失效
+ * 池外直接 addParticle / addParticles 加入的质点（例如生成器建的布料）在下次调用时自动登记为存活。
+ */
+class ParticlePool
+{
+public:
+    struct Params
+    {
+        float compact_ratio = 0.25f;                      // 死槽位占比超过它时压实
+        vec3  graveyard     = vec3(0.0f, -1.0e6f, 0.0f); // 死槽位停放的位置，远离场景避免参与碰撞
+    };
+
+    static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+    explicit ParticlePool(const Params& p = Params{}) : params_(p) {}
+
+    void          setParams(const Params& p) { params_ = p; }
+    const Params& params() const { return params_; }
+
+    // 质点数组和池内部的表一次预留到 capacity
+    void reserve(ParticleData& data, size_t capacity);
+
+    // 新质点从 lifetime 秒后由 LifetimeKiller 回收；默认不过期
+    ParticleHandle spawn(ParticleData& data, const vec3& pos, const vec3& vel, float mass,
+                         float lifetime = std::numeric_limits<float>::infinity());
+    // 句柄已失效时返回 false
+    bool kill(ParticleData& data, ParticleHandle h);
+    void killSlot(ParticleData& data, size_t slot);
+
+    // 句柄当前所在的槽位，失效时为 kNone
+    size_t         slot(ParticleHandle h) const;
+    ParticleHandle handle(size_t slot) const
+    {
+        return alive(slot) ? ParticleHandle{handle_of_slot_[slot], generation_[handle_of_slot_[slot]]} : ParticleHandle{};
+    }
+    bool           alive(size_t slot) const { return slot < alive_.size() && alive_[slot]; }
+    float          age(size_t slot) const { return age_[slot]; }
+    float          lifetime(size_t slot) const { return lifetime_[slot]; }
+
+    // 槽位总数（含死槽位）与存活数
+    size_t slotCount() const { return alive_.size(); }
+    size_t aliveCount() const { return alive_.size() - free_.size(); }
+    size_t deadCount() const { return free_.size(); }
+    size_t compactions() const { return compactions_; }
+
+    // 所有存活质点的年龄加 dt
+    void advanceAges(float dt);
+
+    // 每步调用一次：死槽位多时压实，否则只删除连着本步新死质点的弹簧和三角形
+    void maintain(ParticleData& data, Spring* springs = nullptr, TriangleTopology* triangles = nullptr);
+    // 立即压实：存活质点搬到 [0, aliveCount)，数组缩短，弹簧、三角形重映射
+    void compact(ParticleData& data, Spring* springs = nullptr, TriangleTopology* triangles = nullptr);
+
+    // 最近一次压实的搬动：remap()[old] 为新槽位，死槽位为 kNone；
+    // 只有保存了裸下标（而不是句柄）的外部结构需要它
+    const std::vector<size_t>& remap() const { return remap_; }
+
+    // 自上次 clearChanges 以来的变化；每步交给 SleepIslands::wakeDisturbed 后清空
+    SlotChanges changes() const
+    {
+        return {touched_, remapped_ ? std::span<const size_t>(change_remap_) : std::span<const size_t>()};
+    }
+    void clearChanges();
+
+private:
+    // 登记池外加入的质点
+    void     adopt(const ParticleData& data);
+    uint32_t newHandle(size_t slot);
+    void     touch(size_t slot);
+
+    Params params_;
+
+    std::vector<uint8_t>  alive_;
+    std::vector<uint32_t> handle_of_slot_;
+    std::vector<float>    age_, lifetime_;
+    std::vector<size_t>   free_; // 死槽位
+
+    std::vector<size_t>   slot_of_handle_;
+    std::vector<uint32_t> generation_;
+    std::vector<uint32_t> free_handles_;
+
+    bool                 killed_since_maintain_ = false;
+    size_t               compactions_           = 0;
+    std::vector<size_t>  remap_, holes_, movers_;
+    std::vector<uint8_t> drop_; // 弹簧/三角形的删除标记
+
+    std::vector<size_t>  touched_, lost_, change_remap_;
+    std::vector<uint8_t> touched_mask_;
+    bool                 remapped_ = false;
+};
+}
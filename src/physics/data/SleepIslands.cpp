@@ -0,0 +1,260 @@
+// data/SleepIslands.cpp
+#include "data/SleepIslands.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "Parallel.h"
+
+namespace dk {
+namespace {
+uint32_t findRoot(std::vector<uint32_t>& parent, uint32_t i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i         = parent[i];
+    }
+    return i;
+}
+}
+
+void SleepIslands::rebuild(const ParticleData& data, const Spring& springs)
+{
+    const size_t n = data.size();
+    particles_version_ = data.version;
+    springs_version_   = springs.version;
+
+    // 固定点和死槽位都不进岛；一端固定、另一端能动的弹簧把固定点挂到岛上
+    auto movable  = [&](size_t i) { return !data.is_fixed[i] && !data.is_dead[i]; };
+    auto anchored = [&](size_t a, size_t b) { return movable(a) != movable(b) && !data.is_dead[a] && !data.is_dead[b]; };
+
+    std::vector<uint32_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0u);
+    for (size_t s = 0; s < springs.size(); ++s)
+    {
+        const size_t a = springs.index_a[s], b = springs.index_b[s];
+        if (!movable(a) || !movable(b)) continue;
+        const uint32_t ra = findRoot(parent, static_cast<uint32_t>(a)), rb = findRoot(parent, static_cast<uint32_t>(b));
+        if (ra != rb) parent[std::max(ra, rb)] = std::min(ra, rb);
+    }
+
+    // 岛按最小质点下标编号
+    island_of_.assign(n, kNone);
+    uint32_t count = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!movable(i)) continue;
+        const uint32_t root = findRoot(parent, static_cast<uint32_t>(i));
+        island_of_[i]       = root == i ? count++ : island_of_[root];
+    }
+
+    island_first_.assign(count + 1, 0);
+    for (size_t i = 0; i < n; ++i)
+        if (island_of_[i] != kNone) ++island_first_[island_of_[i] + 1];
+    for (uint32_t k = 0; k < count; ++k) island_first_[k + 1] += island_first_[k];
+    island_particles_.resize(island_first_.back());
+    std::vector<uint32_t> cursor(island_first_.begin(), island_first_.end() - 1);
+    for (size_t i = 0; i < n; ++i)
+        if (island_of_[i] != kNone) island_particles_[cursor[island_of_[i]]++] = static_cast<uint32_t>(i);
+
+    anchor_first_.assign(count + 1, 0);
+    island_springs_.assign(count, 0);
+    for (size_t s = 0; s < springs.size(); ++s)
+    {
+        const size_t a = springs.index_a[s], b = springs.index_b[s];
+        if (movable(a) || movable(b)) ++island_springs_[island_of_[movable(a) ? a : b]];
+        if (anchored(a, b)) ++anchor_first_[island_of_[movable(a) ? a : b] + 1];
+    }
+    for (uint32_t k = 0; k < count; ++k) anchor_first_[k + 1] += anchor_first_[k];
+    anchors_.resize(anchor_first_.back());
+    anchor_rest_.resize(anchors_.size());
+    cursor.assign(anchor_first_.begin(), anchor_first_.end() - 1);
+    for (size_t s = 0; s < springs.size(); ++s)
+    {
+        const size_t a = springs.index_a[s], b = springs.index_b[s];
+        if (!anchored(a, b)) continue;
+        const size_t anchor = movable(a) ? b : a, free = movable(a) ? a : b;
+        anchors_[cursor[island_of_[free]]++] = static_cast<uint32_t>(anchor);
+    }
+
+    quiet_steps_.assign(count, 0);
+    asleep_.assign(count, 0);
+    sleeping_particles_ = 0;
+}
+
+void SleepIslands::restructure(ParticleData& data, const Spring& springs, const SlotChanges& changes)
+{
+    const size_t   n         = data.size();
+    const uint32_t old_count = static_cast<uint32_t>(asleep_.size());
+    // 旧下标在 n 个新槽位里的位置；压实时按 remap 搬，已死的不算
+    auto moved = [&](size_t i)
+    {
+        const size_t j = changes.remap.empty() ? i : i < changes.remap.size() ? changes.remap[i] : ParticlePool::kNone;
+        return j < n && !data.is_dead[j] ? j : ParticlePool::kNone;
+    };
+
+    prev_island_.assign(n, kNone);
+    survivors_.assign(old_count, 0);
+    for (size_t i = 0; i < island_of_.size(); ++i)
+    {
+        const size_t j = moved(i);
+        if (island_of_[i] == kNone || j == ParticlePool::kNone) continue;
+        prev_island_[j] = island_of_[i];
+        ++survivors_[island_of_[i]];
+    }
+    prev_rest_.resize(n);
+    has_rest_.assign(n, 0);
+    for (uint32_t k = 0; k < old_count; ++k)
+    {
+        if (!asleep_[k]) continue;
+        for (uint32_t a = anchor_first_[k]; a < anchor_first_[k + 1]; ++a)
+        {
+            const size_t j = moved(anchors_[a]);
+            if (j == ParticlePool::kNone) continue;
+            prev_rest_[j] = anchor_rest_[a];
+            has_rest_[j]  = 1;
+        }
+    }
+    touched_.assign(n, 0);
+    for (size_t s : changes.touched)
+        if (s < n) touched_[s] = 1;
+
+    prev_quiet_.swap(quiet_steps_);
+    prev_asleep_.swap(asleep_);
+    prev_springs_.swap(island_springs_);
+    rebuild(data, springs);
+
+    const uint32_t count = static_cast<uint32_t>(islandCount());
+    for (uint32_t k = 0; k < count; ++k)
+    {
+        // 成员（除了死掉的）和弹簧数都与某个旧岛相同、又没有被池动过，才算同一个岛
+        const uint32_t begin = island_first_[k], end = island_first_[k + 1];
+        const uint32_t prev  = prev_island_[island_particles_[begin]];
+        bool same = prev != kNone && end - begin == survivors_[prev] && island_springs_[k] == prev_springs_[prev];
+        bool asleep = same && prev_asleep_[prev];
+        for (uint32_t p = begin; p < end && same; ++p)
+        {
+            const uint32_t i = island_particles_[p];
+            same             = prev_island_[i] == prev && !touched_[i];
+            asleep           = asleep && data.is_sleeping[i];
+        }
+        for (uint32_t a = anchor_first_[k]; a < anchor_first_[k + 1] && asleep; ++a) asleep = has_rest_[anchors_[a]];
+        if (!same) continue;
+
+        quiet_steps_[k] = prev_quiet_[prev];
+        if (!asleep) continue;
+        asleep_[k] = 1;
+        sleeping_particles_ += end - begin;
+        for (uint32_t a = anchor_first_[k]; a < anchor_first_[k + 1]; ++a) anchor_rest_[a] = prev_rest_[anchors_[a]];
+    }
+
+    // 醒着的岛、固定点和死槽位清掉休眠位
+    bool changed = false;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const bool sleeping = island_of_[i] != kNone && asleep_[island_of_[i]];
+        if (data.is_sleeping[i] == sleeping) continue;
+        data.is_sleeping[i] = sleeping;
+        changed             = true;
+    }
+    if (changed) data.markSleepChanged();
+}
+
+void SleepIslands::setSleeping(ParticleData& data, const uint32_t island, const bool sleeping)
+{
+    if (static_cast<bool>(asleep_[island]) == sleeping) return;
+    data.markSleepChanged();
+    asleep_[island]      = sleeping;
+    quiet_steps_[island] = 0;
+    const uint32_t begin = island_first_[island], end = island_first_[island + 1];
+    for (uint32_t k = begin; k < end; ++k)
+    {
+        const uint32_t i     = island_particles_[k];
+        data.is_sleeping[i] = sleeping;
+        if (sleeping)
+        {
+            data.velocity[i]          = vec3(0.0f);
+            data.previous_position[i] = data.position[i];
+        }
+    }
+    if (sleeping)
+        for (uint32_t a = anchor_first_[island]; a < anchor_first_[island + 1]; ++a) anchor_rest_[a] = data.position[anchors_[a]];
+    if (sleeping) sleeping_particles_ += end - begin;
+    else sleeping_particles_ -= end - begin;
+}
+
+void SleepIslands::wake(ParticleData& data, const size_t i)
+{
+    if (i < island_of_.size() && island_of_[i] != kNone) setSleeping(data, island_of_[i], false);
+}
+
+size_t SleepIslands::sleepingIslandCount() const
+{
+    size_t count = 0;
+    for (uint8_t a : asleep_) count += a;
+    return count;
+}
+
+void SleepIslands::wakeDisturbed(ParticleData& data, const Spring& springs, const SlotChanges& changes)
+{
+    if (island_of_.size() != data.size() || particles_version_ != data.version || springs_version_ != springs.version
+        || !changes.touched.empty())
+    {
+        restructure(data, springs, changes);
+    }
+    if (sleeping_particles_ == 0) return;
+
+    const uint32_t count = static_cast<uint32_t>(asleep_.size());
+    flags_.assign(count, 0);
+    parallelForSlabs(0, count, [&](i64 b, i64 e)
+    {
+        for (i64 k = b; k < e; ++k)
+        {
+            if (!asleep_[k]) continue;
+            bool disturbed = !params_.enabled;
+            for (uint32_t p = island_first_[k]; p < island_first_[k + 1] && !disturbed; ++p)
+            {
+                const uint32_t i = island_particles_[p];
+                disturbed        = data.force[i] != vec3(0.0f) || data.velocity[i] != vec3(0.0f)
+                                || data.position[i] != data.previous_position[i];
+            }
+            for (uint32_t a = anchor_first_[k]; a < anchor_first_[k + 1] && !disturbed; ++a)
+            {
+                disturbed = data.position[anchors_[a]] != anchor_rest_[a];
+            }
+            flags_[k] = disturbed;
+        }
+    });
+    // is_sleeping 是位向量，不能并行写
+    for (uint32_t k = 0; k < count; ++k)
+        if (flags_[k]) setSleeping(data, k, false);
+}
+
+void SleepIslands::update(ParticleData& data)
+{
+    if (!params_.enabled || island_of_.size() != data.size()) return;
+
+    const uint32_t count = static_cast<uint32_t>(asleep_.size());
+    flags_.assign(count, 0);
+    parallelForSlabs(0, count, [&](i64 b, i64 e)
+    {
+        for (i64 k = b; k < e; ++k)
+        {
+            if (asleep_[k]) continue;
+            const uint32_t begin = island_first_[k], end = island_first_[k + 1];
+            float          energy = 0.0f;
+            for (uint32_t p = begin; p < end; ++p)
+            {
+                const vec3& v = data.velocity[island_particles_[p]];
+                energy += 0.5f * glm::dot(v, v);
+            }
+            const bool quiet = energy <= params_.energy_threshold * static_cast<float>(end - begin);
+            quiet_steps_[k]  = quiet ? quiet_steps_[k] + 1 : 0;
+            flags_[k]        = quiet_steps_[k] >= params_.steps_to_sleep;
+        }
+    });
+    for (uint32_t k = 0; k < count; ++k)
+        if (flags_[k]) setSleeping(data, k, true);
+}
+}
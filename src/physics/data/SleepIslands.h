@@ -0,0 +1,76 @@
+// data/SleepIslands.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "ParticlePool.h"
+
+namespace dk {
+/**
+ * 按弹簧图的连通块（岛）跟踪休眠.
+ * 固定点不把岛连起来：挂在同一个钉子上的两块布各自休眠；死槽位不属于任何岛。
+ * 一个岛的平均单位质量动能 ½|v|² 连续 steps_to_sleep 步低于 energy_threshold 时整岛休眠：
+ * 速度清零，previous_position 对齐 position，ParticleData::is_sleeping 置位。
+ * 休眠的质点不受内置力、不积分、不参与弹簧投影；下列情况整岛被唤醒：
+ * - 受到外力（内置力跳过休眠质点，所以 force 非零只可能来自外部）或速度被外部改写
+ * - 被移动：碰撞体、接触约束或用户直接改了位置，position 不再等于 previous_position
+ * - 挂住它的固定点被移动（拖动钉子、动画驱动的锚点）
+ * - 弹簧拓扑或固定点变化使它与别的岛合并、被拆开或增减了弹簧，或 ParticlePool 报告它的质点被删了边
+ * 粒子生灭只改变涉及的岛：其余岛重新分岛后保持休眠，醒着的岛保留连续低能的步数。
+ */
+class SleepIslands
+{
+public:
+    struct Params
+    {
+        bool  enabled          = true;
+        float energy_threshold = 1e-6f; // 平均 ½|v|²（J/kg）
+        int   steps_to_sleep   = 60;    // 连续低于阈值多少步才休眠
+    };
+
+    explicit SleepIslands(const Params& p = Params{}) : params_(p) {}
+
+    void          setParams(const Params& p) { params_ = p; }
+    const Params& params() const { return params_; }
+
+    // 施加完力、积分之前调用：唤醒被打扰的岛。changes 为 ParticlePool 自上次调用以来的槽位变化
+    void wakeDisturbed(ParticleData& data, const Spring& springs, const SlotChanges& changes = {});
+    // 积分之后调用：累计动能，满足条件的岛进入休眠
+    void update(ParticleData& data);
+    // 唤醒质点 i 所在的岛
+    void wake(ParticleData& data, size_t i);
+
+    size_t islandCount() const { return island_first_.empty() ? 0 : island_first_.size() - 1; }
+    size_t sleepingIslandCount() const;
+    size_t sleepingParticleCount() const { return sleeping_particles_; }
+
+private:
+    void rebuild(const ParticleData& data, const Spring& springs);
+    // 拓扑、固定点或生死变了：重新分岛，未受影响的岛沿用原来的休眠状态和低能步数
+    void restructure(ParticleData& data, const Spring& springs, const SlotChanges& changes);
+    void setSleeping(ParticleData& data, uint32_t island, bool sleeping);
+
+    Params params_;
+
+    // 岛 -> 质点的 CSR；固定点不属于任何岛（island_of_ 为 kNone）
+    static constexpr uint32_t kNone = ~0u;
+    std::vector<uint32_t>     island_of_;
+    std::vector<uint32_t>     island_first_, island_particles_;
+    std::vector<uint32_t>     island_springs_; // 每个岛连着的弹簧数（含挂到固定点的）
+    std::uint64_t             particles_version_ = 0, springs_version_ = 0; // 分岛时的版本号
+    // 岛 -> 经弹簧相连的固定点（可重复）的 CSR，及入睡时各固定点的位置
+    std::vector<uint32_t> anchor_first_, anchors_;
+    std::vector<vec3>     anchor_rest_;
+
+    std::vector<int>     quiet_steps_; // 每个岛连续低于阈值的步数
+    std::vector<uint8_t> asleep_;
+    std::vector<uint8_t> flags_;       // wakeDisturbed / update 的逐岛标记，跨步复用
+    size_t               sleeping_particles_ = 0;
+
+    // restructure 的临时数组：按新下标记原来所在的岛、原来休眠时固定点的位置，按旧岛记存活成员数和旧状态
+    std::vector<uint32_t> prev_island_, survivors_, prev_springs_;
+    std::vector<vec3>     prev_rest_;
+    std::vector<int>      prev_quiet_;
+    std::vector<uint8_t>  prev_asleep_, has_rest_, touched_;
+};
+}
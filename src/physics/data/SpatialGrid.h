@@ -34,6 +34,32 @@ public:
         }
     }
 
+    // 只放入 is_sleeping 等于 sleeping 的粒子：醒着的每步重建，休眠的只在休眠集合变化时重建。
+    // 死槽位都停在同一个 graveyard 点上，放进来会让那一格的查询退化成 O(死槽位²)，直接跳过
+    void build(const ParticleData& data, bool sleeping)
+    {
+        m_grid.clear();
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            if (data.is_sleeping[i] != sleeping || data.is_dead[i]) continue;
+            m_grid[getCellIndex(data.position[i])].push_back(i);
+        }
+    }
+
+    // 查询位置 p 周围的粒子
+    void query(const glm::vec3& p, std::vector<size_t>& out_candidates) const
+    {
+        out_candidates.clear();
+        const glm::ivec3 center_idx = getCellIndex(p);
+        for (int x = -1; x <= 1; ++x)
+            for (int y = -1; y <= 1; ++y)
+                for (int z = -1; z <= 1; ++z)
+                {
+                    auto it = m_grid.find(center_idx + glm::ivec3(x, y, z));
+                    if (it != m_grid.end()) out_candidates.insert(out_candidates.end(), it->second.begin(), it->second.end());
+                }
+    }
+
     // 查询一个粒子周围可能发生碰撞的其他粒子的索引
     void query(const ParticleData& data, size_t particle_idx, std::vector<size_t>& out_candidates)
     {
@@ -0,0 +1,301 @@
+// distributed/HaloExchange.cpp
+#include "distributed/HaloExchange.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace dk {
+// ---------------- SlabDecomposition ----------------
+void SlabDecomposition::ownedCells(int rank, int& begin, int& end) const
+{
+    // 均分，余数给前面几块
+    const int n    = global_dims[axis()];
+    const int base = n / ranks;
+    const int rem  = n % ranks;
+    begin          = rank * base + std::min(rank, rem);
+    end            = begin + base + (rank < rem ? 1 : 0);
+}
+
+void SlabDecomposition::ownedPlanes(int rank, MacGrid::FieldKind kind, int& begin, int& end) const
+{
+    ownedCells(rank, begin, end);
+    if (MacGrid::staggeredAxis(kind) == axis() && rank == ranks - 1) end += 1;
+}
+
+bool SlabDecomposition::valid() const
+{
+    if (ranks < 1 || halo < 1) return false;
+    if (ranks == 1) return true;
+    for (int r = 0; r < ranks; ++r)
+    {
+        int b, e;
+        ownedCells(r, b, e);
+        if (e - b < halo + 1) return false;
+    }
+    return true;
+}
+
+MacGrid SlabDecomposition::makeLocalGrid(int rank, float h, const vec3& origin) const
+{
+    const int a = axis();
+    int       b, e;
+    ownedCells(rank, b, e);
+
+    glm::ivec3 ghost_lo(0), ghost_hi(0), offset(0);
+    ghost_lo[a] = rank > 0 ? halo : 0;
+    ghost_hi[a] = rank + 1 < ranks ? halo : 0;
+    offset[a]   = b - ghost_lo[a];
+
+    glm::ivec3 dims = global_dims;
+    dims[a]         = e - b + ghost_lo[a] + ghost_hi[a];
+
+    MacGrid g(dims.x, dims.y, dims.z, h, origin);
+    g.setSubdomain(global_dims, offset, ghost_lo, ghost_hi);
+    return g;
+}
+
+// ---------------- HaloExchange ----------------
+HaloExchange::HaloExchange(const SlabDecomposition& decomposition, IHaloTransport& transport)
+    : _decomp(decomposition), _transport(transport)
+{
+    if (!_decomp.valid() || _transport.size() != _decomp.ranks)
+    {
+        throw std::runtime_error("HaloExchange: invalid slab decomposition for this transport");
+    }
+}
+
+size_t HaloExchange::planeSize(const MacGrid& g, MacGrid::FieldKind kind) const
+{
+    // 切分轴是最慢变化的轴（2D 时 nz == 1），一个平面就是一段连续内存
+    const glm::ivec3 d = g.fieldDims(kind);
+    return _decomp.axis() == 2 ? static_cast<size_t>(d.x) * d.y : static_cast<size_t>(d.x) * d.z;
+}
+
+void HaloExchange::pack(const MacGrid& g, const HaloField& f, int p0, int p1, std::vector<float>& buf) const
+{
+    const size_t ps = planeSize(g, f.kind);
+    const float* src = f.field->data() + static_cast<size_t>(p0) * ps;
+    buf.insert(buf.end(), src, src + static_cast<size_t>(p1 - p0) * ps);
+}
+
+void HaloExchange::unpack(const MacGrid& g, const HaloField& f, int p0, int p1, const float*& src) const
+{
+    const size_t ps = planeSize(g, f.kind);
+    const size_t n  = static_cast<size_t>(p1 - p0) * ps;
+    std::memcpy(f.field->data() + static_cast<size_t>(p0) * ps, src, n * sizeof(float));
+    src += n;
+}
+
+void HaloExchange::exchange(const MacGrid& g, const std::vector<HaloField>& fields)
+{
+    const int r    = rank();
+    const int a    = _decomp.axis();
+    const int last = _decomp.ranks - 1;
+    if (_decomp.ranks == 1) return;
+
+    auto lowGhost = [&](const HaloField& f) { return g.ownedBegin(f.kind)[a]; };
+    auto ownedEnd = [&](const HaloField& f) { return g.ownedEnd(f.kind)[a]; };
+    auto dim      = [&](const HaloField& f) { return g.fieldDims(f.kind)[a]; };
+
+    auto recvInto = [&](int peer, auto planes)
+    {
+        size_t total = 0;
+        for (const auto& f : fields)
+        {
+            auto [p0, p1] = planes(f);
+            total += static_cast<size_t>(p1 - p0) * planeSize(g, f.kind);
+        }
+        _recv.resize(total);
+        _transport.recv(peer, _recv.data(), total * sizeof(float));
+        const float* src = _recv.data();
+        for (const auto& f : fields)
+        {
+            auto [p0, p1] = planes(f);
+            unpack(g, f, p0, p1, src);
+        }
+    };
+
+    // 向下：把自己最前面的 owned 平面发给 r - 1（面心布局多带共享面上方那一层），收 r + 1 的
+    if (r > 0)
+    {
+        _send.clear();
+        for (const auto& f : fields)
+        {
+            const int p0    = lowGhost(f);
+            const int extra = MacGrid::staggeredAxis(f.kind) == a ? 1 : 0;
+            pack(g, f, p0, p0 + g.ghostLo()[a] + extra, _send);
+        }
+        _transport.send(r - 1, _send.data(), _send.size() * sizeof(float));
+    }
+    if (r < last)
+    {
+        recvInto(r + 1, [&](const HaloField& f) { return std::pair(ownedEnd(f), dim(f)); });
+    }
+
+    // 向上：把最后 halo 层 owned 平面发给 r + 1，收 r - 1 的
+    if (r < last)
+    {
+        _send.clear();
+        for (const auto& f : fields)
+        {
+            const int p1 = ownedEnd(f);
+            pack(g, f, p1 - g.ghostHi()[a], p1, _send);
+        }
+        _transport.send(r + 1, _send.data(), _send.size() * sizeof(float));
+    }
+    if (r > 0)
+    {
+        recvInto(r - 1, [&](const HaloField& f) { return std::pair(0, lowGhost(f)); });
+    }
+}
+
+std::vector<HaloField> HaloExchange::gridFields(MacGrid& g) const
+{
+    std::vector<HaloField> fields{
+        {&g.u(), MacGrid::FieldKind::U},
+        {&g.v(), MacGrid::FieldKind::V},
+    };
+    // 2D 时 W 恒为 0，且它的 y 平面不连续，不参与
+    if (_decomp.axis() == 2) fields.push_back({&g.w(), MacGrid::FieldKind::W});
+    fields.push_back({&g.p(), MacGrid::FieldKind::Center});
+    fields.push_back({&g.dye(), MacGrid::FieldKind::Center});
+    for (int c = 0; c < g.scalarChannelCount(); ++c) fields.push_back({&g.scalar(c), MacGrid::FieldKind::Center});
+    return fields;
+}
+
+size_t HaloExchange::payloadSize(const MacGrid& g, int q) const
+{
+    size_t total = 0;
+    for (const auto& f : gridFields(const_cast<MacGrid&>(g)))
+    {
+        int b, e;
+        _decomp.ownedPlanes(q, f.kind, b, e);
+        total += static_cast<size_t>(e - b) * planeSize(g, f.kind);
+    }
+    return total;
+}
+
+void HaloExchange::gather(const MacGrid& local, MacGrid* global)
+{
+    const int r    = rank();
+    const int a    = _decomp.axis();
+    const int last = _decomp.ranks - 1;
+
+    // 只读打包，gridFields 需要非 const 指针
+    auto  localFields = gridFields(const_cast<MacGrid&>(local));
+    auto& buf         = _send;
+
+    if (r == 0)
+    {
+        if (!global || global->scalarChannelCount() != local.scalarChannelCount()
+            || global->globalDims() != _decomp.global_dims)
+        {
+            throw std::runtime_error("HaloExchange: rank 0 needs a whole-domain grid with the same channels");
+        }
+        auto globalFields = gridFields(*global);
+        // 自己的部分直接拷贝（rank 0 没有下幽灵层，本地平面就是全局平面）
+        for (size_t n = 0; n < localFields.size(); ++n)
+        {
+            int b, e;
+            _decomp.ownedPlanes(0, localFields[n].kind, b, e);
+            buf.clear();
+            pack(local, localFields[n], b, e, buf);
+            const float* src = buf.data();
+            unpack(*global, globalFields[n], b, e, src);
+        }
+        // 其余各块由 rank 1 逐个转发上来
+        for (int q = 1; q <= last; ++q)
+        {
+            _recv.resize(payloadSize(local, q));
+            _transport.recv(1, _recv.data(), _recv.size() * sizeof(float));
+            const float* src = _recv.data();
+            for (const auto& f : globalFields)
+            {
+                int b, e;
+                _decomp.ownedPlanes(q, f.kind, b, e);
+                unpack(*global, f, b, e, src);
+            }
+        }
+        return;
+    }
+
+    // 先发自己的，再把上面各块的依次转发下去
+    buf.clear();
+    const int offset = local.globalOffset()[a];
+    for (const auto& f : localFields)
+    {
+        int b, e;
+        _decomp.ownedPlanes(r, f.kind, b, e);
+        pack(local, f, b - offset, e - offset, buf);
+    }
+    _transport.send(r - 1, buf.data(), buf.size() * sizeof(float));
+    for (int q = r + 1; q <= last; ++q)
+    {
+        _recv.resize(payloadSize(local, q));
+        _transport.recv(r + 1, _recv.data(), _recv.size() * sizeof(float));
+        _transport.send(r - 1, _recv.data(), _recv.size() * sizeof(float));
+    }
+}
+
+void HaloExchange::scatter(const MacGrid* global, MacGrid& local)
+{
+    const int r    = rank();
+    const int a    = _decomp.axis();
+    const int last = _decomp.ranks - 1;
+
+    auto localFields = gridFields(local);
+    if (r == 0)
+    {
+        if (!global || global->scalarChannelCount() != local.scalarChannelCount()
+            || global->globalDims() != _decomp.global_dims)
+        {
+            throw std::runtime_error("HaloExchange: rank 0 needs a whole-domain grid with the same channels");
+        }
+        auto globalFields = gridFields(const_cast<MacGrid&>(*global));
+        for (size_t n = 0; n < localFields.size(); ++n)
+        {
+            int b, e;
+            _decomp.ownedPlanes(0, localFields[n].kind, b, e);
+            _send.clear();
+            pack(*global, globalFields[n], b, e, _send);
+            const float* src = _send.data();
+            unpack(local, localFields[n], b, e, src);
+        }
+        for (int q = 1; q <= last; ++q)
+        {
+            _send.clear();
+            for (const auto& f : globalFields)
+            {
+                int b, e;
+                _decomp.ownedPlanes(q, f.kind, b, e);
+                pack(*global, f, b, e, _send);
+            }
+            _transport.send(1, _send.data(), _send.size() * sizeof(float));
+        }
+    }
+    else
+    {
+        // 第一份是自己的，其余转发给上面
+        _recv.resize(payloadSize(local, r));
+        _transport.recv(r - 1, _recv.data(), _recv.size() * sizeof(float));
+        const float* src    = _recv.data();
+        const int    offset = local.globalOffset()[a];
+        for (const auto& f : localFields)
+        {
+            int b, e;
+            _decomp.ownedPlanes(r, f.kind, b, e);
+            unpack(local, f, b - offset, e - offset, src);
+        }
+        for (int q = r + 1; q <= last; ++q)
+        {
+            _recv.resize(payloadSize(local, q));
+            _transport.recv(r - 1, _recv.data(), _recv.size() * sizeof(float));
+            _transport.send(r + 1, _recv.data(), _recv.size() * sizeof(float));
+        }
+    }
+
+    exchange(local, localFields);
+}
+}
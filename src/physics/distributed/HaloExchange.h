@@ -0,0 +1,81 @@
+// distributed/HaloExchange.h
+#pragma once
+#include <vector>
+
+#include "data/MacGrid.h"
+#include "distributed/HaloTransport.h"
+
+namespace dk {
+/**
+ * MacGrid 的 slab 域分解：沿最慢的轴切开（3D 为 z，nz == 1 的 2D 网格为 y），
+ * 每个 rank（一个 worker 进程）持有一段连续的 cell，两侧各带 halo 层幽灵 cell。
+ * 切分轴上的平面在内存里连续，halo 交换就是整块拷贝。
+ *
+ * 结果与单进程逐位一致的前提：每步的回溯距离不超过 halo - 2 个 cell
+ * （三线性模板多读一层，MacCormack/BFECC 的反向回溯再读一层），且每块至少拥有 halo + 1 层 cell。
+ * StableFluidSolver 每步对流前检查回溯距离，超出时在该 rank 上抛 std::runtime_error。
+ */
+struct SlabDecomposition
+{
+    glm::ivec3 global_dims{0}; // 全局 cell 数
+    int        ranks = 1;
+    int        halo  = 3; // 幽灵层厚度（cell）
+
+    int axis() const { return global_dims.z == 1 ? 1 : 2; }
+
+    // rank 拥有的全局 cell 区间 [begin, end)
+    void ownedCells(int rank, int& begin, int& end) const;
+    // rank 拥有的全局平面区间；面心布局在切分轴上多一层，共享面归上面一块，末尾那层归最后一块
+    void ownedPlanes(int rank, MacGrid::FieldKind kind, int& begin, int& end) const;
+
+    bool valid() const;
+
+    // 建 rank 的分块网格：已 setSubdomain，全局原点与步长和整块网格相同
+    MacGrid makeLocalGrid(int rank, float h, const vec3& origin = vec3(0)) const;
+};
+
+// 参与 halo 交换的一个字段
+struct HaloField
+{
+    Field*             field;
+    MacGrid::FieldKind kind;
+};
+
+/**
+ * 在相邻 rank 之间交换幽灵层，并在 rank 0 与各块之间收发整场.
+ * 只和相邻 rank 通信：交换先整体向下、再整体向上，任何阻塞式传输都不会形成环等待；
+ * gather/scatter 逐级转发。所有 rank 必须以相同顺序调用同样的函数（集体操作）。
+ * 用法：每个 worker 用 makeLocalGrid 建分块网格，StableFluidSolver::setHaloExchange 挂上本对象，
+ * scatter 初值后照常 solve；需要整场时 gather 到 rank 0。
+ */
+class HaloExchange
+{
+public:
+    HaloExchange(const SlabDecomposition& decomposition, IHaloTransport& transport);
+
+    int                      rank() const { return _transport.rank(); }
+    const SlabDecomposition& decomposition() const { return _decomp; }
+
+    // 用邻居的 owned 数据刷新 g 的幽灵层
+    void exchange(const MacGrid& g, const std::vector<HaloField>& fields);
+
+    // 把各块 owned 的 u/v/w/p/dye/标量通道汇总到 rank 0 的整块网格 global（其它 rank 传 nullptr）
+    void gather(const MacGrid& local, MacGrid* global);
+    // 反过来：rank 0 把整块网格切给各块，幽灵层随后一并交换
+    void scatter(const MacGrid* global, MacGrid& local);
+
+private:
+    std::vector<HaloField> gridFields(MacGrid& g) const;
+    size_t                 planeSize(const MacGrid& g, MacGrid::FieldKind kind) const;
+    // rank q 的 owned 数据打包后的长度（float 个数）
+    size_t payloadSize(const MacGrid& g, int q) const;
+
+    // 在 g 的本地平面 [p0, p1) 与缓冲之间拷贝
+    void pack(const MacGrid& g, const HaloField& f, int p0, int p1, std::vector<float>& buf) const;
+    void unpack(const MacGrid& g, const HaloField& f, int p0, int p1, const float*& src) const;
+
+    SlabDecomposition  _decomp;
+    IHaloTransport&    _transport;
+    std::vector<float> _send, _recv;
+};
+}
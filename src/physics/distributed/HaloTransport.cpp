@@ -0,0 +1,226 @@
+// distributed/HaloTransport.cpp
+#include "distributed/HaloTransport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace dk {
+// ---------------- 进程内 ----------------
+class InProcessHaloTransport : public IHaloTransport
+{
+public:
+    InProcessHaloTransport(InProcessHaloHub& hub, int rank) : _hub(hub), _rank(rank) {}
+
+    int rank() const override { return _rank; }
+    int size() const override { return _hub.size(); }
+
+    void send(int peer, const void* data, size_t bytes) override
+    {
+        auto& ch  = _hub.channel(_rank, peer);
+        auto* src = static_cast<const char*>(data);
+        {
+            std::lock_guard lock(ch.mutex);
+            ch.messages.emplace_back(src, src + bytes);
+        }
+        ch.cv.notify_one();
+    }
+
+    void recv(int peer, void* data, size_t bytes) override
+    {
+        auto&             ch = _hub.channel(peer, _rank);
+        std::unique_lock lock(ch.mutex);
+        ch.cv.wait(lock, [&] { return !ch.messages.empty(); });
+        std::vector<char> msg = std::move(ch.messages.front());
+        ch.messages.pop_front();
+        lock.unlock();
+
+        if (msg.size() != bytes) throw std::runtime_error("InProcessHaloTransport: message size mismatch");
+        std::memcpy(data, msg.data(), bytes);
+    }
+
+private:
+    InProcessHaloHub& _hub;
+    int               _rank;
+};
+
+InProcessHaloHub::InProcessHaloHub(int size) : _size(size)
+{
+    _channels.resize(static_cast<size_t>(size) * size);
+    for (auto& ch : _channels) ch = std::make_unique<Channel>();
+}
+
+std::unique_ptr<IHaloTransport> InProcessHaloHub::transport(int rank)
+{
+    return std::make_unique<InProcessHaloTransport>(*this, rank);
+}
+
+// ---------------- 本地 socket ----------------
+namespace {
+#if defined(_WIN32)
+using socket_t                     = SOCKET;
+constexpr socket_t kInvalidSocket = INVALID_SOCKET;
+
+constexpr int kSendFlags = 0;
+
+void closeSocket(socket_t s) { closesocket(s); }
+
+struct WinsockInit
+{
+    WinsockInit()
+    {
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+    }
+
+    ~WinsockInit() { WSACleanup(); }
+};
+#else
+using socket_t                     = int;
+constexpr socket_t kInvalidSocket = -1;
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL; // 对端退出时返回错误而不是 SIGPIPE
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void closeSocket(socket_t s) { ::close(s); }
+#endif
+
+sockaddr_un makeAddress(const std::string& path)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        throw std::runtime_error("LocalSocketTransport: endpoint path too long: " + path);
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+std::string endpointPath(const std::string& endpoint, int rank)
+{
+    return endpoint + "." + std::to_string(rank);
+}
+}
+
+LocalSocketTransport::LocalSocketTransport(int rank, int size, std::string endpoint, int connect_timeout_ms)
+    : _rank(rank), _size(size), _endpoint(std::move(endpoint))
+{
+#if defined(_WIN32)
+    static WinsockInit winsock;
+#endif
+    // 先开监听（等上面一块连进来），再去连下面一块：所有进程都这样做不会互相等死
+    socket_t listener = kInvalidSocket;
+    if (_rank + 1 < _size)
+    {
+        const std::string path = endpointPath(_endpoint, _rank);
+        sockaddr_un       addr = makeAddress(path);
+#if defined(_WIN32)
+        DeleteFileA(path.c_str());
+#else
+        ::unlink(path.c_str());
+#endif
+        listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener == kInvalidSocket || ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+            || ::listen(listener, 1) != 0)
+        {
+            if (listener != kInvalidSocket) closeSocket(listener);
+            throw std::runtime_error("LocalSocketTransport: cannot listen on " + path);
+        }
+    }
+
+    if (_rank > 0)
+    {
+        const std::string path     = endpointPath(_endpoint, _rank - 1);
+        sockaddr_un       addr     = makeAddress(path);
+        const auto        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connect_timeout_ms);
+        for (;;)
+        {
+            socket_t s = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (s != kInvalidSocket && ::connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0)
+            {
+                _lower = static_cast<std::intptr_t>(s);
+                break;
+            }
+            if (s != kInvalidSocket) closeSocket(s);
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                if (listener != kInvalidSocket) closeSocket(listener);
+                throw std::runtime_error("LocalSocketTransport: cannot connect to " + path);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    if (listener != kInvalidSocket)
+    {
+        socket_t s = ::accept(listener, nullptr, nullptr);
+        closeSocket(listener);
+#if defined(_WIN32)
+        DeleteFileA(endpointPath(_endpoint, _rank).c_str());
+#else
+        ::unlink(endpointPath(_endpoint, _rank).c_str());
+#endif
+        if (s == kInvalidSocket) throw std::runtime_error("LocalSocketTransport: accept failed");
+        _upper = static_cast<std::intptr_t>(s);
+    }
+}
+
+LocalSocketTransport::~LocalSocketTransport()
+{
+    if (_lower != -1) closeSocket(static_cast<socket_t>(_lower));
+    if (_upper != -1) closeSocket(static_cast<socket_t>(_upper));
+}
+
+std::intptr_t LocalSocketTransport::socketFor(int peer) const
+{
+    if (peer == _rank - 1 && _lower != -1) return _lower;
+    if (peer == _rank + 1 && _upper != -1) return _upper;
+    throw std::runtime_error("LocalSocketTransport: only neighbouring ranks are connected");
+}
+
+void LocalSocketTransport::send(int peer, const void* data, size_t bytes)
+{
+    const auto  s   = static_cast<socket_t>(socketFor(peer));
+    const char* ptr = static_cast<const char*>(data);
+    while (bytes > 0)
+    {
+        const int chunk = static_cast<int>(std::min<size_t>(bytes, 1u << 30));
+        const auto n     = ::send(s, ptr, chunk, kSendFlags);
+        if (n <= 0) throw std::runtime_error("LocalSocketTransport: send failed");
+        ptr += n;
+        bytes -= static_cast<size_t>(n);
+    }
+}
+
+void LocalSocketTransport::recv(int peer, void* data, size_t bytes)
+{
+    const auto s   = static_cast<socket_t>(socketFor(peer));
+    char*      ptr = static_cast<char*>(data);
+    while (bytes > 0)
+    {
+        const int chunk = static_cast<int>(std::min<size_t>(bytes, 1u << 30));
+        const auto n     = ::recv(s, ptr, chunk, 0);
+        if (n <= 0) throw std::runtime_error("LocalSocketTransport: peer closed or recv failed");
+        ptr += n;
+        bytes -= static_cast<size_t>(n);
+    }
+}
+}
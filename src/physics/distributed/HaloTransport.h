@@ -0,0 +1,93 @@
+// distributed/HaloTransport.h
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dk {
+/**
+ * 域分解用的点对点传输层.
+ * HaloExchange 只依赖这个接口：同一台机器上用本地 socket，
+ * 以后换成网络传输（TCP/MPI）只需要再实现一个 IHaloTransport。
+ * 约定：同一对 (发送方, 接收方) 之间的消息按发送顺序到达，recv 的字节数与对应 send 相同。
+ * 传输失败无法恢复，抛 std::runtime_error。
+ */
+class IHaloTransport
+{
+public:
+    virtual ~IHaloTransport() = default;
+
+    virtual int rank() const = 0;
+    virtual int size() const = 0;
+
+    // 返回时 data 可以复用
+    virtual void send(int peer, const void* data, size_t bytes) = 0;
+    // 阻塞直到收齐 peer 发来的 bytes 字节
+    virtual void recv(int peer, void* data, size_t bytes) = 0;
+};
+
+/**
+ * 进程内传输：各 rank 跑在同一进程的不同线程上（测试、单机调试用）.
+ * 由 InProcessHaloHub 创建，hub 必须比所有 transport 活得久。
+ */
+class InProcessHaloHub
+{
+public:
+    explicit InProcessHaloHub(int size);
+
+    int size() const { return _size; }
+
+    std::unique_ptr<IHaloTransport> transport(int rank);
+
+private:
+    friend class InProcessHaloTransport;
+
+    struct Channel
+    {
+        std::mutex                     mutex;
+        std::condition_variable        cv;
+        std::deque<std::vector<char>> messages;
+    };
+
+    Channel& channel(int from, int to) { return *_channels[static_cast<size_t>(from) * _size + to]; }
+
+    int                                   _size;
+    std::vector<std::unique_ptr<Channel>> _channels;
+};
+
+/**
+ * 同机多进程传输：相邻 rank 之间用本地 (AF_UNIX) 流式 socket 连接.
+ * rank r 在 "<endpoint>.<r>" 上监听，等 r + 1 连进来；r > 0 时连接 "<endpoint>.<r - 1>"。
+ * 各 worker 进程以相同的 endpoint/size、不同的 rank 启动即可，启动顺序任意（连接会重试）。
+ * 只有相邻 rank 之间有连接，正好满足 slab 分解的 halo 交换与向 rank 0 逐级汇总。
+ */
+class LocalSocketTransport : public IHaloTransport
+{
+public:
+    LocalSocketTransport(int rank, int size, std::string endpoint, int connect_timeout_ms = 30000);
+    ~LocalSocketTransport() override;
+
+    LocalSocketTransport(const LocalSocketTransport&)            = delete;
+    LocalSocketTransport& operator=(const LocalSocketTransport&) = delete;
+
+    int rank() const override { return _rank; }
+    int size() const override { return _size; }
+
+    void send(int peer, const void* data, size_t bytes) override;
+    void recv(int peer, void* data, size_t bytes) override;
+
+private:
+    std::intptr_t socketFor(int peer) const;
+
+    int           _rank;
+    int           _size;
+    std::string   _endpoint;
+    std::intptr_t _lower{-1}; // 与 rank - 1 的连接
+    std::intptr_t _upper{-1}; // 与 rank + 1 的连接
+};
+}
@@ -0,0 +1,74 @@
+// emit/Emitter.h
+#pragma once
+#include <cmath>
+#include <random>
+
+#include "data/ParticlePool.h"
+
+namespace dk {
+class IEmitter
+{
+public:
+    virtual ~IEmitter() = default;
+    // 在 dt 时间内通过池生成新质点
+    virtual void emit(ParticlePool& pool, ParticleData& data, float dt) = 0;
+};
+
+/**
+ * 点发射器：从一点沿圆锥内的随机方向喷射.
+ * 每秒生成 rate 个，不足一个的部分累积到下一步，所以小步长下发射数也准确。
+ * 随机数由 seed 决定，同样的步进序列得到同样的粒子。
+ */
+class PointEmitter : public IEmitter
+{
+public:
+    struct Params
+    {
+        vec3     position     = vec3(0.0f);
+        vec3     direction    = vec3(0.0f, 1.0f, 0.0f);
+        float    spread       = 0.3f;  // 圆锥半角（弧度）
+        float    speed        = 5.0f;
+        float    speed_jitter = 0.2f;  // 速度的相对随机扰动
+        float    rate         = 1000.0f;
+        float    mass         = 0.01f;
+        float    lifetime     = 2.0f;  // 秒，配合 LifetimeKiller 回收
+        uint32_t seed         = 1;
+    };
+
+    explicit PointEmitter(const Params& p = Params{}) : params_(p), rng_(p.seed) {}
+
+    void          setParams(const Params& p) { params_ = p; }
+    const Params& params() const { return params_; }
+
+    void emit(ParticlePool& pool, ParticleData& data, float dt) override
+    {
+        accumulator_ += params_.rate * dt;
+        const int count = static_cast<int>(accumulator_);
+        accumulator_ -= static_cast<float>(count);
+        if (count == 0) return;
+
+        // 以 direction 为 z 轴的正交基
+        const vec3 w = glm::normalize(params_.direction);
+        const vec3 u = glm::normalize(glm::cross(std::fabs(w.x) < 0.9f ? vec3(1, 0, 0) : vec3(0, 1, 0), w));
+        const vec3 v = glm::cross(w, u);
+
+        std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+        const float                           cos_spread = std::cos(params_.spread);
+        for (int k = 0; k < count; ++k)
+        {
+            // 在圆锥对应的球冠上均匀取方向
+            const float cos_t = 1.0f - uni(rng_) * (1.0f - cos_spread);
+            const float sin_t = std::sqrt(std::max(0.0f, 1.0f - cos_t * cos_t));
+            const float phi   = 6.28318531f * uni(rng_);
+            const vec3  dir   = cos_t * w + sin_t * (std::cos(phi) * u + std::sin(phi) * v);
+            const float speed = params_.speed * (1.0f + params_.speed_jitter * (2.0f * uni(rng_) - 1.0f));
+            pool.spawn(data, params_.position, speed * dir, params_.mass, params_.lifetime);
+        }
+    }
+
+private:
+    Params       params_;
+    std::mt19937 rng_;
+    float        accumulator_ = 0.0f;
+};
+}
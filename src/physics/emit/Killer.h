@@ -0,0 +1,67 @@
+// emit/Killer.h
+#pragma once
+#include <vector>
+
+#include "Parallel.h"
+#include "data/ParticlePool.h"
+
+namespace dk {
+class IKiller
+{
+public:
+    virtual ~IKiller() = default;
+    // 在 dt 时间结束时回收满足条件的质点
+    virtual void kill(ParticlePool& pool, ParticleData& data, float dt) = 0;
+
+protected:
+    // 并行判定、串行回收（回收要改空闲链表和 is_dead 位向量）
+    template <class Pred>
+    void killWhere(ParticlePool& pool, ParticleData& data, Pred&& pred)
+    {
+        const size_t n = pool.slotCount();
+        flags_.resize(n);
+        parallelForSlabs(0, static_cast<i64>(n), [&](i64 b, i64 e)
+        {
+            for (i64 s = b; s < e; ++s) flags_[s] = pool.alive(s) && pred(static_cast<size_t>(s));
+        });
+        for (size_t s = 0; s < n; ++s)
+            if (flags_[s]) pool.killSlot(data, s);
+    }
+
+private:
+    std::vector<uint8_t> flags_;
+};
+
+// 年龄达到出生时给定寿命的质点
+class LifetimeKiller : public IKiller
+{
+public:
+    void kill(ParticlePool& pool, ParticleData& data, float) override
+    {
+        killWhere(pool, data, [&](size_t s) { return pool.age(s) >= pool.lifetime(s); });
+    }
+};
+
+// 离开盒子的质点；kill_inside 为 true 时反过来回收进入盒子的（例如地面上的排水口）
+class BoxKiller : public IKiller
+{
+public:
+    BoxKiller(const vec3& min, const vec3& max, bool kill_inside = false) : min_(min), max_(max), kill_inside_(kill_inside)
+    {
+    }
+
+    void kill(ParticlePool& pool, ParticleData& data, float) override
+    {
+        killWhere(pool, data, [&](size_t s)
+        {
+            const vec3& p      = data.position[s];
+            const bool  inside = glm::all(glm::greaterThanEqual(p, min_)) && glm::all(glm::lessThanEqual(p, max_));
+            return inside == kill_inside_;
+        });
+    }
+
+private:
+    vec3 min_, max_;
+    bool kill_inside_;
+};
+}
@@ -0,0 +1,540 @@
+// fluid/FlipSystem.cpp
+#include "fluid/FlipSystem.h"
+
+#include <algorithm>
+#include <random>
+
+#include "Parallel.h"
+#include "PhysicsStats.h"
+
+namespace dk {
+namespace {
+using Kind = MacGrid::FieldKind;
+constexpr Kind kFaceKinds[3] = {Kind::U, Kind::V, Kind::W};
+
+// 粒子在某个布局上的三线性模板：角点为 base + {0,1}^Dim，f 为小数部分
+struct Stencil
+{
+    glm::ivec3 base;
+    vec3       f;
+};
+
+inline Stencil stencilOf(const MacGrid& g, Kind kind, const vec3& x)
+{
+    const vec3 s  = (x - g.origin()) / g.h() - MacGrid::fieldOffset(kind);
+    const vec3 fl = glm::floor(s);
+    return {glm::ivec3(fl), s - fl};
+}
+
+// 对 2^Dim 个角点调用 fn(下标, 权重, 权重梯度 * h, 角点相对粒子的偏移 / h)；越界角点夹回边界
+template <int Dim, class Fn>
+inline void forStencil(const glm::ivec3& d, const Stencil& st, Fn&& fn)
+{
+    constexpr int kz = Dim == 3 ? 2 : 1;
+    for (int dz = 0; dz < kz; ++dz)
+        for (int dy = 0; dy < 2; ++dy)
+            for (int dx = 0; dx < 2; ++dx)
+            {
+                const float wx = dx ? st.f.x : 1.0f - st.f.x, gx = dx ? 1.0f : -1.0f;
+                const float wy = dy ? st.f.y : 1.0f - st.f.y, gy = dy ? 1.0f : -1.0f;
+                float       wz = 1.0f, gz = 0.0f;
+                if constexpr (Dim == 3)
+                {
+                    wz = dz ? st.f.z : 1.0f - st.f.z;
+                    gz = dz ? 1.0f : -1.0f;
+                }
+                const int i = std::clamp(st.base.x + dx, 0, d.x - 1);
+                const int j = std::clamp(st.base.y + dy, 0, d.y - 1);
+                const int k = Dim == 3 ? std::clamp(st.base.z + dz, 0, d.z - 1) : 0;
+
+                vec3 offset(static_cast<float>(dx) - st.f.x, static_cast<float>(dy) - st.f.y, 0.0f);
+                if constexpr (Dim == 3) offset.z = static_cast<float>(dz) - st.f.z;
+                fn((static_cast<size_t>(k) * d.y + j) * d.x + i, wx * wy * wz, vec3(gx * wy * wz, wx * gy * wz, wx * wy * gz),
+                   offset);
+            }
+}
+}
+
+FlipFluidSystem::FlipFluidSystem(const Config& cfg)
+    : cfg_(cfg), grid_(cfg.nx, cfg.ny, cfg.nz, cfg.h, cfg.origin)
+{
+    const vec3& lo = cfg.fill_min;
+    const vec3& hi = cfg.fill_max;
+    if (lo.x < hi.x && lo.y < hi.y && (cfg.nz == 1 || lo.z < hi.z)) seedBox(lo, hi);
+}
+
+vec3 FlipFluidSystem::clampParticle(const vec3& x) const
+{
+    // 贴着固壁但不越界；2D 时 z 固定在 cell 中心
+    const float eps = 1e-3f * grid_.h();
+    const vec3  lo  = grid_.origin() + vec3(eps);
+    const vec3  hi  = grid_.origin() + vec3(grid_.globalDims()) * grid_.h() - vec3(eps);
+    vec3        c   = glm::clamp(x, lo, hi);
+    if (grid_.nz() == 1) c.z = grid_.origin().z + 0.5f * grid_.h();
+    return c;
+}
+
+void FlipFluidSystem::addParticle(const vec3& x, const vec3& v)
+{
+    particles_.x.push_back(clampParticle(x));
+    particles_.v.push_back(v);
+    particles_.cu.emplace_back(0.0f);
+    particles_.cv.emplace_back(0.0f);
+    particles_.cw.emplace_back(0.0f);
+}
+
+void FlipFluidSystem::seedBox(const vec3& lo, const vec3& hi, const vec3& velocity)
+{
+    // 每个 cell 分成 2^Dim 个子格，各放一个抖动粒子；固定种子，结果可复现
+    std::mt19937                          rng(1234u + static_cast<unsigned>(particles_.size()));
+    std::uniform_real_distribution<float> jitter(0.1f, 0.9f);
+    const float                           h  = grid_.h();
+    const float                           hs = 0.5f * h;
+    const int                             kz = grid_.nz() > 1 ? 2 * grid_.nz() : 1;
+
+    for (int k = 0; k < kz; ++k)
+        for (int j = 0; j < 2 * grid_.ny(); ++j)
+            for (int i = 0; i < 2 * grid_.nx(); ++i)
+            {
+                vec3 x = grid_.origin() + hs * vec3(i + jitter(rng), j + jitter(rng), k + jitter(rng));
+                if (grid_.nz() == 1) x.z = grid_.origin().z + 0.5f * h;
+                const bool inside = x.x >= lo.x && x.x < hi.x && x.y >= lo.y && x.y < hi.y
+                                    && (grid_.nz() == 1 || (x.z >= lo.z && x.z < hi.z));
+                if (inside) addParticle(x, velocity);
+            }
+}
+
+void FlipFluidSystem::step(float dt)
+{
+    if (particles_.size() == 0) return;
+    if (grid_.nz() == 1)
+    {
+        stepDim<2>(dt);
+    }
+    else
+    {
+        stepDim<3>(dt);
+    }
+}
+
+template <int Dim>
+void FlipFluidSystem::stepDim(float dt)
+{
+    using Timer = PhysicsStats::StageTimer;
+    {
+        Timer timer("sort");
+        sortParticles<Dim>();
+    }
+    {
+        Timer timer("p2g");
+        particlesToGrid<Dim>();
+        if (cfg_.transfer == Transfer::FLIP)
+        {
+            u_old_ = grid_.u();
+            v_old_ = grid_.v();
+            if constexpr (Dim == 3) w_old_ = grid_.w();
+        }
+    }
+    {
+        Timer timer("projection");
+        addGravityAndWalls<Dim>(dt);
+        project<Dim>();
+        PhysicsStats::instance().addCount("pressure iterations", cfg_.pressure_iters);
+    }
+    {
+        Timer timer("g2p");
+        extrapolate<Dim>();
+        gridToParticles<Dim>();
+    }
+    {
+        Timer timer("advection");
+        advectParticles<Dim>(dt);
+    }
+}
+
+template <int Dim>
+void FlipFluidSystem::slabLayout(int& layers, size_t& layer_cells) const
+{
+    if constexpr (Dim == 3)
+    {
+        layers      = grid_.nz();
+        layer_cells = static_cast<size_t>(grid_.nx()) * grid_.ny();
+    }
+    else
+    {
+        layers      = grid_.ny();
+        layer_cells = static_cast<size_t>(grid_.nx());
+    }
+}
+
+template <int Dim>
+void FlipFluidSystem::sortParticles()
+{
+    const i64    n      = static_cast<i64>(particles_.size());
+    const size_t ncells = static_cast<size_t>(grid_.nx()) * grid_.ny() * grid_.nz();
+    cell_of_.resize(n);
+    parallelForSlabs(0, n, [&](i64 b, i64 e)
+    {
+        for (i64 p = b; p < e; ++p)
+        {
+            const vec3       s = (particles_.x[p] - grid_.origin()) / grid_.h();
+            const glm::ivec3 c = glm::clamp(glm::ivec3(glm::floor(s)), glm::ivec3(0),
+                                            glm::ivec3(grid_.nx(), grid_.ny(), grid_.nz()) - 1);
+            cell_of_[p] = static_cast<uint32_t>(grid_.idxP(c.x, c.y, Dim == 3 ? c.z : 0));
+        }
+    });
+
+    // cell 切成每线程一段：各线程按原顺序扫一遍全部粒子，只统计、只放置落在自己那段 cell 里的粒子。
+    // 直方图和写入位置都只有 ncells 个（各线程只碰自己的一段），同一 cell 里保持原顺序（稳定、无原子操作）
+    cell_start_.resize(ncells + 1);
+    parallelForSlabs(0, static_cast<i64>(ncells), [&](i64 c0, i64 c1)
+    {
+        std::fill(cell_start_.begin() + c0 + 1, cell_start_.begin() + c1 + 1, 0u);
+        for (i64 p = 0; p < n; ++p)
+        {
+            const uint32_t c = cell_of_[p];
+            if (c >= c0 && c < c1) ++cell_start_[c + 1];
+        }
+    });
+    cell_start_[0] = 0;
+    for (size_t c = 0; c < ncells; ++c) cell_start_[c + 1] += cell_start_[c];
+
+    order_.resize(n);
+    cell_cursor_.resize(ncells);
+    parallelForSlabs(0, static_cast<i64>(ncells), [&](i64 c0, i64 c1)
+    {
+        std::copy(cell_start_.begin() + c0, cell_start_.begin() + c1, cell_cursor_.begin() + c0);
+        for (i64 p = 0; p < n; ++p)
+        {
+            const uint32_t c = cell_of_[p];
+            if (c >= c0 && c < c1) order_[cell_cursor_[c]++] = static_cast<uint32_t>(p);
+        }
+    });
+
+    sorted_.resize(n);
+    parallelForSlabs(0, n, [&](i64 b, i64 e)
+    {
+        for (i64 q = b; q < e; ++q)
+        {
+            const uint32_t p = order_[q];
+            sorted_.x[q]     = particles_.x[p];
+            sorted_.v[q]     = particles_.v[p];
+            sorted_.cu[q]    = particles_.cu[p];
+            sorted_.cv[q]    = particles_.cv[p];
+            sorted_.cw[q]    = particles_.cw[p];
+        }
+    });
+    std::swap(particles_, sorted_);
+
+    liquid_.resize(ncells);
+    parallelForSlabs(0, static_cast<i64>(ncells), [&](i64 b, i64 e)
+    {
+        for (i64 c = b; c < e; ++c) liquid_[c] = cell_start_[c + 1] > cell_start_[c];
+    });
+}
+
+template <int Dim>
+void FlipFluidSystem::particlesToGrid()
+{
+    MacGrid&          g = grid_;
+    Field*            num[3] = {&g.u(), &g.v(), &g.w()};
+    Field*            den[3] = {&g.u_tmp(), &g.v_tmp(), &g.w_tmp()};
+    const vec3* const vel    = particles_.v.data();
+    const std::vector<vec3>* aff[3] = {&particles_.cu, &particles_.cv, &particles_.cw};
+    const bool        apic   = cfg_.transfer == Transfer::APIC;
+    const float       h      = g.h();
+
+    for (int a = 0; a < Dim; ++a)
+    {
+        g.initField(*num[a], kFaceKinds[a]);
+        g.initField(*den[a], kFaceKinds[a]);
+    }
+
+    // slab 厚度至少 2 层 cell；同色 slab 之间隔着一个异色 slab，写入区间不重叠
+    int    layers;
+    size_t layer_cells;
+    slabLayout<Dim>(layers, layer_cells);
+    const int slabs = std::max(1, std::min(2 * SlabPool::instance().threadCount(), layers / 2));
+
+    auto scatterSlab = [&](int s)
+    {
+        const int      l0 = layers * s / slabs, l1 = layers * (s + 1) / slabs;
+        const uint32_t p0 = cell_start_[l0 * layer_cells], p1 = cell_start_[l1 * layer_cells];
+        for (int a = 0; a < Dim; ++a)
+        {
+            const glm::ivec3 d = g.fieldDims(kFaceKinds[a]);
+            float*           nm = num[a]->data();
+            float*           dn = den[a]->data();
+            for (uint32_t p = p0; p < p1; ++p)
+            {
+                const float vp = vel[p][a];
+                const vec3  cp = apic ? (*aff[a])[p] : vec3(0.0f);
+                forStencil<Dim>(d, stencilOf(g, kFaceKinds[a], particles_.x[p]),
+                                [&](size_t idx, float w, const vec3&, const vec3& offset)
+                {
+                    nm[idx] += w * (vp + h * glm::dot(cp, offset));
+                    dn[idx] += w;
+                });
+            }
+        }
+    };
+    for (int color = 0; color < 2; ++color)
+    {
+        const int count = (slabs - color + 1) / 2;
+        parallelForSlabs(0, count, [&](i64 b, i64 e)
+        {
+            for (i64 s = b; s < e; ++s) scatterSlab(static_cast<int>(2 * s + color));
+        });
+    }
+
+    for (int a = 0; a < Dim; ++a)
+    {
+        Field& nm = *num[a];
+        Field& dn = *den[a];
+        parallelForSlabs(0, static_cast<i64>(nm.size()), [&](i64 b, i64 e)
+        {
+            for (i64 n = b; n < e; ++n) nm[n] = dn[n] > 0.0f ? nm[n] / dn[n] : 0.0f;
+        });
+    }
+}
+
+template <int Dim>
+void FlipFluidSystem::addGravityAndWalls(float dt)
+{
+    MacGrid&    g      = grid_;
+    Field*      f[3]   = {&g.u(), &g.v(), &g.w()};
+    const vec3  dv     = dt * cfg_.gravity;
+    for (int a = 0; a < Dim; ++a)
+    {
+        const glm::ivec3 d = g.fieldDims(kFaceKinds[a]);
+        Field&           fa = *f[a];
+        parallelForGrid<Dim>(d, [&](int i, int j, int k)
+        {
+            const int c = glm::ivec3(i, j, k)[a];
+            // 固壁：域边界面法向速度为 0
+            fa[(static_cast<size_t>(k) * d.y + j) * d.x + i] = c == 0 || c == d[a] - 1
+                                                                   ? 0.0f
+                                                                   : fa[(static_cast<size_t>(k) * d.y + j) * d.x + i] + dv[a];
+        });
+    }
+}
+
+template <int Dim>
+void FlipFluidSystem::project()
+{
+    MacGrid&         g    = grid_;
+    const float      h    = g.h();
+    const float      invh = 1.0f / h;
+    const glm::ivec3 n(g.nx(), g.ny(), g.nz());
+    auto             isLiquid = [&](int i, int j, int k) { return liquid_[g.idxP(i, j, k)] != 0; };
+
+    parallelForGrid<Dim>(n, [&](int i, int j, int k)
+    {
+        float div = 0.0f;
+        if (isLiquid(i, j, k))
+        {
+            div = g.U(i + 1, j, k) - g.U(i, j, k) + g.V(i, j + 1, k) - g.V(i, j, k);
+            if constexpr (Dim == 3) div += g.W(i, j, k + 1) - g.W(i, j, k);
+        }
+        g.Div(i, j, k) = invh * div;
+        if (!isLiquid(i, j, k)) g.P(i, j, k) = 0.0f; // 空气：p = 0；液体 cell 用上一步的压力热启动
+    });
+
+    // 解 laplace(p) = div：空气邻居 p = 0（Dirichlet），域外邻居是固壁，不计入（Neumann）
+    for (int it = 0; it < cfg_.pressure_iters; ++it)
+    {
+        parallelForGrid<Dim>(n, [&](int i, int j, int k)
+        {
+            float& out = g.p_tmp()[g.idxP(i, j, k)];
+            if (!isLiquid(i, j, k))
+            {
+                out = 0.0f;
+                return;
+            }
+            float sum   = 0.0f;
+            int   count = 0;
+            auto  add   = [&](int ii, int jj, int kk, bool inside)
+            {
+                if (!inside) return;
+                sum += g.P(ii, jj, kk);
+                ++count;
+            };
+            add(i - 1, j, k, i > 0);
+            add(i + 1, j, k, i + 1 < n.x);
+            add(i, j - 1, k, j > 0);
+            add(i, j + 1, k, j + 1 < n.y);
+            if constexpr (Dim == 3)
+            {
+                add(i, j, k - 1, k > 0);
+                add(i, j, k + 1, k + 1 < n.z);
+            }
+            out = count > 0 ? (sum - h * h * g.Div(i, j, k)) / static_cast<float>(count) : 0.0f;
+        });
+        g.p().swap(g.p_tmp());
+    }
+
+    // 只修正至少一侧是液体的内部面
+    parallelForGrid<Dim>(g.fieldDims(Kind::U), [&](int i, int j, int k)
+    {
+        if (i == 0 || i == n.x || !(isLiquid(i - 1, j, k) || isLiquid(i, j, k))) return;
+        g.U(i, j, k) -= invh * (g.P(i, j, k) - g.P(i - 1, j, k));
+    });
+    parallelForGrid<Dim>(g.fieldDims(Kind::V), [&](int i, int j, int k)
+    {
+        if (j == 0 || j == n.y || !(isLiquid(i, j - 1, k) || isLiquid(i, j, k))) return;
+        g.V(i, j, k) -= invh * (g.P(i, j, k) - g.P(i, j - 1, k));
+    });
+    if constexpr (Dim == 3)
+    {
+        parallelForGrid<Dim>(g.fieldDims(Kind::W), [&](int i, int j, int k)
+        {
+            if (k == 0 || k == n.z || !(isLiquid(i, j, k - 1) || isLiquid(i, j, k))) return;
+            g.W(i, j, k) -= invh * (g.P(i, j, k) - g.P(i, j, k - 1));
+        });
+    }
+}
+
+template <int Dim>
+void FlipFluidSystem::extrapolate()
+{
+    // 与液体 cell 相邻的面有效；每层把无效面设为相邻有效面的平均，G2P 在自由面附近才读得到合理速度
+    MacGrid&         g    = grid_;
+    Field*           f[3] = {&g.u(), &g.v(), &g.w()};
+    const glm::ivec3 n(g.nx(), g.ny(), g.nz());
+
+    for (int a = 0; a < Dim; ++a)
+    {
+        const glm::ivec3 d  = g.fieldDims(kFaceKinds[a]);
+        Field&           fa = *f[a];
+        auto             at = [&](int i, int j, int k) { return (static_cast<size_t>(k) * d.y + j) * d.x + i; };
+        valid_.resize(fa.size());
+        valid_tmp_.resize(fa.size());
+
+        parallelForGrid<Dim>(d, [&](int i, int j, int k)
+        {
+            glm::ivec3 lo(i, j, k), hi(i, j, k);
+            lo[a] -= 1;
+            const bool l = lo[a] >= 0 && liquid_[g.idxP(lo.x, lo.y, lo.z)];
+            const bool r = hi[a] < n[a] && liquid_[g.idxP(hi.x, hi.y, hi.z)];
+            valid_[at(i, j, k)] = l || r;
+        });
+
+        for (int layer = 0; layer < cfg_.extrapolation_layers; ++layer)
+        {
+            parallelForGrid<Dim>(d, [&](int i, int j, int k)
+            {
+                const size_t idx = at(i, j, k);
+                valid_tmp_[idx]  = valid_[idx];
+                if (valid_[idx]) return;
+                float sum   = 0.0f;
+                int   count = 0;
+                auto  add   = [&](int ii, int jj, int kk)
+                {
+                    if (ii < 0 || jj < 0 || kk < 0 || ii >= d.x || jj >= d.y || kk >= d.z) return;
+                    const size_t m = at(ii, jj, kk);
+                    if (!valid_[m]) return;
+                    sum += fa[m];
+                    ++count;
+                };
+                add(i - 1, j, k);
+                add(i + 1, j, k);
+                add(i, j - 1, k);
+                add(i, j + 1, k);
+                if constexpr (Dim == 3)
+                {
+                    add(i, j, k - 1);
+                    add(i, j, k + 1);
+                }
+                if (count > 0)
+                {
+                    fa[idx]         = sum / static_cast<float>(count);
+                    valid_tmp_[idx] = 1;
+                }
+            });
+            valid_.swap(valid_tmp_);
+        }
+
+        // 外插不能改写固壁上的法向速度
+        parallelForGrid<Dim>(d, [&](int i, int j, int k)
+        {
+            const int c = glm::ivec3(i, j, k)[a];
+            if (c == 0 || c == d[a] - 1) fa[at(i, j, k)] = 0.0f;
+        });
+    }
+}
+
+template <int Dim>
+void FlipFluidSystem::gridToParticles()
+{
+    const MacGrid&     g       = grid_;
+    const Field*       now[3]  = {&g.u(), &g.v(), &g.w()};
+    const Field*       old[3]  = {&u_old_, &v_old_, &w_old_};
+    std::vector<vec3>* aff[3]  = {&particles_.cu, &particles_.cv, &particles_.cw};
+    const Transfer     mode    = cfg_.transfer;
+    const float        ratio   = cfg_.flip_ratio;
+    const float        invh    = 1.0f / g.h();
+
+    parallelForSlabs(0, static_cast<i64>(particles_.size()), [&](i64 b, i64 e)
+    {
+        for (i64 p = b; p < e; ++p)
+        {
+            vec3 v_pic(0.0f), v_old(0.0f);
+            for (int a = 0; a < Dim; ++a)
+            {
+                const glm::ivec3 d  = g.fieldDims(kFaceKinds[a]);
+                const float*     fn = now[a]->data();
+                const float*     fo = mode == Transfer::FLIP ? old[a]->data() : nullptr;
+                vec3             grad(0.0f);
+                forStencil<Dim>(d, stencilOf(g, kFaceKinds[a], particles_.x[p]),
+                                [&](size_t idx, float w, const vec3& gw, const vec3&)
+                {
+                    v_pic[a] += w * fn[idx];
+                    if (fo) v_old[a] += w * fo[idx];
+                    grad += gw * fn[idx];
+                });
+                (*aff[a])[p] = mode == Transfer::APIC ? grad * invh : vec3(0.0f);
+            }
+            vec3& v = particles_.v[p];
+            v       = mode == Transfer::FLIP ? ratio * (v + v_pic - v_old) + (1.0f - ratio) * v_pic : v_pic;
+            if constexpr (Dim == 2) v.z = 0.0f;
+        }
+    });
+}
+
+template <int Dim>
+void FlipFluidSystem::advectParticles(float dt)
+{
+    // 沿无散的网格速度做中点 RK2，比直接用粒子速度更不容易挤进固壁或聚团
+    parallelForSlabs(0, static_cast<i64>(particles_.size()), [&](i64 b, i64 e)
+    {
+        for (i64 p = b; p < e; ++p)
+        {
+            vec3&      x   = particles_.x[p];
+            const vec3 mid = clampParticle(x + 0.5f * dt * grid_.sampleVelocity<Dim>(x));
+            x              = clampParticle(x + dt * grid_.sampleVelocity<Dim>(mid));
+        }
+    });
+}
+
+void FlipFluidSystem::getRenderData(std::vector<PointData>& out_data) const
+{
+    out_data.clear();
+    out_data.resize(renderPointCount());
+    writeRenderData(out_data);
+}
+
+size_t FlipFluidSystem::writeRenderData(std::span<PointData> out) const
+{
+    const size_t count = std::min(out.size(), particles_.size());
+    parallelForSlabs(0, static_cast<i64>(count), [&](i64 b, i64 e)
+    {
+        for (i64 i = b; i < e; ++i)
+        {
+            const float t   = std::min(glm::length(particles_.v[i]) * 0.5f, 1.0f);
+            out[i].position = vec4(particles_.x[i], 1.0f);
+            out[i].color    = glm::mix(vec4(0.1f, 0.35f, 0.9f, 1.0f), vec4(1.0f), t);
+        }
+    });
+    return count;
+}
+}
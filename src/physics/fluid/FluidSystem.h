@@ -3,6 +3,9 @@
 #include "World.h"            // ISystem 定义在这里
 #include "solver/StableFliuidsSolver.h"
 #include "data/MacGrid.h"
+#include "distributed/HaloExchange.h"
+#include "fluid/IsoSurface.h"
+#include <cassert>
 
 namespace dk {
 class FluidSystem : public ISystem
@@ -20,20 +23,18 @@ public:
         : grid_(cfg.nx, cfg.ny, cfg.nz, cfg.h, cfg.origin),
           solver_(cfg.solver_params)
     {
-        // 可以在此给 dye 初值/速度激励，做个简单烟雾源
-        int cx = cfg.nx / 4, cy = cfg.ny / 2, cz = cfg.nz / 2;
-        for (int k = cz - 2; k <= cz + 2; ++k)
-            for (int j = cy - 2; j <= cy + 2; ++j)
-                for (int i = cx - 2; i <= cx + 2; ++i)
-                {
-                    if (i >= 0 && i < cfg.nx && j >= 0 && j < cfg.ny && k >= 0 && k < cfg.nz)
-                    {
-                        grid_.Dye(i, j, k) = 1.0f; // 一小团染料
-                    }
-                }
-        // 向右侧加点初速度（演示）
-        for (int j = 0; j < cfg.ny; ++j)
-            for (int k = 0; k < cfg.nz; ++k) grid_.U(1, j, k) = 1.0f;
+        seed(cfg);
+    }
+
+    // 域分解模式：本进程只持有 halo.rank() 那一块（含幽灵层），每步与相邻 worker 交换 halo。
+    // cfg 描述的仍是整个域，必须与 halo.decomposition().global_dims 一致
+    FluidSystem(const Config& cfg, HaloExchange& halo)
+        : grid_(halo.decomposition().makeLocalGrid(halo.rank(), cfg.h, cfg.origin)),
+          solver_(cfg.solver_params)
+    {
+        assert(halo.decomposition().global_dims == glm::ivec3(cfg.nx, cfg.ny, cfg.nz));
+        solver_.setHaloExchange(&halo);
+        seed(cfg);
     }
 
     void step(float dt) override
@@ -41,13 +42,28 @@ public:
         solver_.solve(grid_, dt);
     }
 
+    // 网格流体没有点表示；渲染走 extractSurface 提取的等值面（RenderSystem::setFluidSurface 上传）
     void getRenderData(std::vector<PointData>& out_data) const override
     {
-        // 这里先留空（避免假设你的 PointData 结构）
-        // 你可以把高于阈值的染料体素转换为点云（position=color=中心，alpha=浓度）
         out_data.clear();
     }
 
+    // 提取 dye 的 iso 等值面，Mesh 一般是 MeshData；brick 层级与各段缓冲在帧间复用
+    template <class Mesh>
+    void extractSurface(float iso, Mesh& out)
+    {
+        surface_.extract(grid_, grid_.dye(), iso, out);
+    }
+
+    // 任一 cell 中心标量通道的等值面
+    template <class Mesh>
+    void extractSurface(int channel, float iso, Mesh& out)
+    {
+        surface_.extract(grid_, grid_.scalar(channel), iso, out);
+    }
+
+    const IsoSurfaceExtractor& surfaceExtractor() const { return surface_; }
+
     MacGrid&       grid() { return grid_; }
     const MacGrid& grid() const { return grid_; }
 
@@ -55,7 +71,28 @@ public:
     const StableFluidSolver& solver() const { return solver_; }
 
 private:
-    MacGrid           grid_;
-    StableFluidSolver solver_;
+    // 初值按全局下标给，分块时每块只写落在自己范围内的部分
+    void seed(const Config& cfg)
+    {
+        const glm::ivec3 off = grid_.globalOffset();
+        // 可以在此给 dye 初值/速度激励，做个简单烟雾源
+        int cx = cfg.nx / 4, cy = cfg.ny / 2, cz = cfg.nz / 2;
+        for (int k = cz - 2 - off.z; k <= cz + 2 - off.z; ++k)
+            for (int j = cy - 2 - off.y; j <= cy + 2 - off.y; ++j)
+                for (int i = cx - 2 - off.x; i <= cx + 2 - off.x; ++i)
+                {
+                    if (i >= 0 && i < grid_.nx() && j >= 0 && j < grid_.ny() && k >= 0 && k < grid_.nz())
+                    {
+                        grid_.Dye(i, j, k) = 1.0f; // 一小团染料
+                    }
+                }
+        // 向右侧加点初速度（演示）
+        for (int j = 0; j < grid_.ny(); ++j)
+            for (int k = 0; k < grid_.nz(); ++k) grid_.U(1 - off.x, j, k) = 1.0f;
+    }
+
+    MacGrid             grid_;
+    StableFluidSolver   solver_;
+    IsoSurfaceExtractor surface_;
 };
 }
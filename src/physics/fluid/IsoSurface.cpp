@@ -0,0 +1,302 @@
+// fluid/IsoSurface.cpp
+#include "fluid/IsoSurface.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#include "Parallel.h"
+
+namespace dk {
+namespace {
+constexpr int B  = IsoSurfaceExtractor::kBrickSize;
+constexpr int L  = B + 1; // brick 每轴的格点数
+constexpr int B3 = B * B * B;
+
+// cube 的角点 n 位于 (n & 1, (n >> 1) & 1, (n >> 2) & 1)
+constexpr int kEdges[12][2] = {{0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3},
+                               {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+inline vec3 cornerOf(int n) { return vec3(n & 1, (n >> 1) & 1, (n >> 2) & 1); }
+
+inline int localCube(int x, int y, int z) { return (z * B + y) * B + x; }
+
+// 交点平均得顶点（cube 局部坐标），负梯度作法线
+void surfaceVertex(const float v[8], float iso, vec3& p, vec3& n)
+{
+    vec3 sum(0.0f);
+    int  count = 0;
+    for (const auto& e : kEdges)
+    {
+        const float a = v[e[0]], b = v[e[1]];
+        if ((a >= iso) == (b >= iso)) continue;
+        const float t = (iso - a) / (b - a);
+        sum += cornerOf(e[0]) + t * (cornerOf(e[1]) - cornerOf(e[0]));
+        ++count;
+    }
+    p = sum / static_cast<float>(count);
+
+    const float x = p.x, y = p.y, z = p.z;
+    const vec3  grad(
+        (1 - y) * (1 - z) * (v[1] - v[0]) + y * (1 - z) * (v[3] - v[2]) + (1 - y) * z * (v[5] - v[4]) + y * z * (v[7] - v[6]),
+        (1 - x) * (1 - z) * (v[2] - v[0]) + x * (1 - z) * (v[3] - v[1]) + (1 - x) * z * (v[6] - v[4]) + x * z * (v[7] - v[5]),
+        (1 - x) * (1 - y) * (v[4] - v[0]) + x * (1 - y) * (v[5] - v[1]) + (1 - x) * y * (v[6] - v[2]) + x * y * (v[7] - v[3]));
+    const float len = glm::length(grad);
+    n               = len > 1e-20f ? -grad / len : vec3(0.0f, 1.0f, 0.0f);
+}
+}
+
+glm::ivec3 IsoSurfaceExtractor::brickCoord(i64 b) const
+{
+    const i64 plane = static_cast<i64>(_brick_dims.x) * _brick_dims.y;
+    return glm::ivec3(static_cast<int>(b % _brick_dims.x), static_cast<int>(b % plane / _brick_dims.x),
+                      static_cast<int>(b / plane));
+}
+
+void IsoSurfaceExtractor::loadCorners(const glm::ivec3& b, float* c) const
+{
+    // cube q 的最小角是格点 q - 1（补的那圈是 -1 和 n）
+    const glm::ivec3 p0 = b * B - 1;
+    const int        nx = _grid->nx(), ny = _grid->ny(), nz = _grid->nz();
+    const int        i0 = std::max(p0.x, 0), i1 = std::min(p0.x + L, nx);
+    const float*     f  = _field->data();
+
+    for (int z = 0; z < L; ++z)
+        for (int y = 0; y < L; ++y)
+        {
+            float*    row = c + (z * L + y) * L;
+            const int k = p0.z + z, j = p0.y + y;
+            if (k < 0 || k >= nz || j < 0 || j >= ny || i1 <= i0)
+            {
+                std::fill(row, row + L, 0.0f);
+                continue;
+            }
+            std::fill(row, row + (i0 - p0.x), 0.0f);
+            std::memcpy(row + (i0 - p0.x), f + _grid->idxP(i0, j, k), static_cast<size_t>(i1 - i0) * sizeof(float));
+            std::fill(row + (i1 - p0.x), row + L, 0.0f);
+        }
+}
+
+void IsoSurfaceExtractor::update(const MacGrid& g, const Field& f)
+{
+    assert(f.size() == static_cast<size_t>(g.nx()) * g.ny() * g.nz());
+    _grid  = &g;
+    _field = &f;
+
+    _cubes      = glm::ivec3(g.nx(), g.ny(), g.nz()) + 1;
+    _brick_dims = (_cubes + (B - 1)) / B;
+    _super_dims = (_brick_dims + (kSuperSize - 1)) / kSuperSize;
+
+    const i64 bricks = static_cast<i64>(_brick_dims.x) * _brick_dims.y * _brick_dims.z;
+    _brick_min.resize(bricks);
+    _brick_max.resize(bricks);
+
+    // brick 层按 z 切 slab，各 brick 多读一层格点，与相邻 brick 共享边界
+    parallelForSlabs(0, _brick_dims.z, [&](i64 z0, i64 z1)
+    {
+        float c[L * L * L];
+        for (int bz = static_cast<int>(z0); bz < static_cast<int>(z1); ++bz)
+            for (int by = 0; by < _brick_dims.y; ++by)
+                for (int bx = 0; bx < _brick_dims.x; ++bx)
+                {
+                    loadCorners(glm::ivec3(bx, by, bz), c);
+                    const auto [lo, hi] = std::minmax_element(c, c + L * L * L);
+                    const i64  b        = (static_cast<i64>(bz) * _brick_dims.y + by) * _brick_dims.x + bx;
+                    _brick_min[b]       = *lo;
+                    _brick_max[b]       = *hi;
+                }
+    });
+
+    const i64 supers = static_cast<i64>(_super_dims.x) * _super_dims.y * _super_dims.z;
+    _super_min.assign(supers, std::numeric_limits<float>::max());
+    _super_max.assign(supers, std::numeric_limits<float>::lowest());
+    for (i64 b = 0; b < bricks; ++b)
+    {
+        const glm::ivec3 s = brickCoord(b) / kSuperSize;
+        const i64        n = (static_cast<i64>(s.z) * _super_dims.y + s.y) * _super_dims.x + s.x;
+        _super_min[n]      = std::min(_super_min[n], _brick_min[b]);
+        _super_max[n]      = std::max(_super_max[n], _brick_max[b]);
+    }
+}
+
+void IsoSurfaceExtractor::build(float iso)
+{
+    assert(_grid && "IsoSurfaceExtractor: update() before extract()");
+    auto crosses = [iso](float lo, float hi) { return lo < iso && hi >= iso; };
+
+    // ---- 沿层级收集活跃 brick ----
+    const i64 bricks = static_cast<i64>(_brick_dims.x) * _brick_dims.y * _brick_dims.z;
+    _slot.assign(bricks, -1);
+    _active.clear();
+    for (int sz = 0; sz < _super_dims.z; ++sz)
+        for (int sy = 0; sy < _super_dims.y; ++sy)
+            for (int sx = 0; sx < _super_dims.x; ++sx)
+            {
+                const i64 s = (static_cast<i64>(sz) * _super_dims.y + sy) * _super_dims.x + sx;
+                if (!crosses(_super_min[s], _super_max[s])) continue;
+
+                const glm::ivec3 lo = glm::ivec3(sx, sy, sz) * kSuperSize;
+                const glm::ivec3 hi = glm::min(lo + kSuperSize, _brick_dims);
+                for (int bz = lo.z; bz < hi.z; ++bz)
+                    for (int by = lo.y; by < hi.y; ++by)
+                        for (int bx = lo.x; bx < hi.x; ++bx)
+                        {
+                            const i64 b = (static_cast<i64>(bz) * _brick_dims.y + by) * _brick_dims.x + bx;
+                            if (!crosses(_brick_min[b], _brick_max[b])) continue;
+                            _slot[b] = static_cast<int32_t>(_active.size());
+                            _active.push_back(b);
+                        }
+            }
+
+    const i64 active = static_cast<i64>(_active.size());
+    const int chunks = static_cast<int>(std::min<i64>(SlabPool::instance().threadCount(), active));
+    _chunks.resize(chunks);
+    _slot_chunk.resize(active);
+    _masks.resize(static_cast<size_t>(active) * B3);
+    _vertex_ids.resize(static_cast<size_t>(active) * B3);
+    auto slotRange = [&](int c, i64& s0, i64& s1)
+    {
+        s0 = active * c / chunks;
+        s1 = active * (c + 1) / chunks;
+    };
+
+    // ---- 第一遍：每个跨越 iso 的 cube 一个顶点，登记在槽位里 ----
+    const float h = _grid->h();
+    parallelForSlabs(0, chunks, [&](i64 c0, i64 c1)
+    {
+        float c[L * L * L];
+        for (int ci = static_cast<int>(c0); ci < static_cast<int>(c1); ++ci)
+        {
+            Chunk& chunk = _chunks[ci];
+            chunk.positions.clear();
+            chunk.normals.clear();
+            chunk.indices.clear();
+
+            i64 s0, s1;
+            slotRange(ci, s0, s1);
+            for (i64 s = s0; s < s1; ++s)
+            {
+                _slot_chunk[s]       = ci;
+                const glm::ivec3 b   = brickCoord(_active[s]);
+                const glm::ivec3 q0  = b * B;
+                const glm::ivec3 end = glm::min(glm::ivec3(B), _cubes - q0);
+                uint8_t*         m   = _masks.data() + s * B3;
+                uint32_t*        ids = _vertex_ids.data() + s * B3;
+                loadCorners(b, c);
+                std::fill(m, m + B3, uint8_t(0));
+
+                for (int z = 0; z < end.z; ++z)
+                    for (int y = 0; y < end.y; ++y)
+                        for (int x = 0; x < end.x; ++x)
+                        {
+                            float   v[8];
+                            uint8_t mask = 0;
+                            for (int n = 0; n < 8; ++n)
+                            {
+                                v[n] = c[((z + ((n >> 2) & 1)) * L + y + ((n >> 1) & 1)) * L + x + (n & 1)];
+                                mask |= static_cast<uint8_t>(v[n] >= iso) << n;
+                            }
+                            const int l = localCube(x, y, z);
+                            m[l]        = mask;
+                            if (mask == 0 || mask == 0xff) continue;
+
+                            vec3 p, nrm;
+                            surfaceVertex(v, iso, p, nrm);
+                            const glm::ivec3 q = q0 + glm::ivec3(x, y, z);
+                            ids[l]             = static_cast<uint32_t>(chunk.positions.size());
+                            chunk.positions.push_back(_grid->cellCenter(q.x - 1, q.y - 1, q.z - 1) + h * p);
+                            chunk.normals.push_back(nrm);
+                        }
+            }
+        }
+    });
+
+    uint32_t vertices = 0;
+    for (Chunk& chunk : _chunks)
+    {
+        chunk.vertex_offset = vertices;
+        vertices += static_cast<uint32_t>(chunk.positions.size());
+    }
+
+    // ---- 第二遍：每条跨越 iso 的格点边连接周围 4 个 cube 的顶点 ----
+    // 边归它最小端点所在的 cube；周围的 cube 都含这条边，必然活跃且已有顶点
+    auto vertexOf = [&](const glm::ivec3& q) -> uint32_t
+    {
+        const glm::ivec3 b = q / B, l = q - b * B;
+        const int32_t    s = _slot[(static_cast<i64>(b.z) * _brick_dims.y + b.y) * _brick_dims.x + b.x];
+        assert(s >= 0);
+        return _vertex_ids[static_cast<size_t>(s) * B3 + localCube(l.x, l.y, l.z)] + _chunks[_slot_chunk[s]].vertex_offset;
+    };
+
+    parallelForSlabs(0, chunks, [&](i64 c0, i64 c1)
+    {
+        for (int ci = static_cast<int>(c0); ci < static_cast<int>(c1); ++ci)
+        {
+            Chunk& chunk = _chunks[ci];
+            i64    s0, s1;
+            slotRange(ci, s0, s1);
+            for (i64 s = s0; s < s1; ++s)
+            {
+                const glm::ivec3 q0  = brickCoord(_active[s]) * B;
+                const glm::ivec3 end = glm::min(glm::ivec3(B), _cubes - q0);
+                const uint8_t*   m   = _masks.data() + s * B3;
+
+                for (int z = 0; z < end.z; ++z)
+                    for (int y = 0; y < end.y; ++y)
+                        for (int x = 0; x < end.x; ++x)
+                        {
+                            const uint8_t mask = m[localCube(x, y, z)];
+                            if (mask == 0 || mask == 0xff) continue;
+                            const glm::ivec3 q = q0 + glm::ivec3(x, y, z);
+
+                            for (int a = 0; a < 3; ++a)
+                            {
+                                // 沿 a 轴的边：角点 0 -> 角点 1 << a；绕边的另外两轴按 (a+1, a+2) 取右手序
+                                const bool inside = mask & 1;
+                                if (inside == static_cast<bool>((mask >> (1 << a)) & 1)) continue;
+                                const int a1 = (a + 1) % 3, a2 = (a + 2) % 3;
+                                if (q[a1] == 0 || q[a2] == 0) continue;
+
+                                glm::ivec3 e1(0), e2(0);
+                                e1[a1] = 1;
+                                e2[a2] = 1;
+                                const uint32_t v0 = vertexOf(q), v1 = vertexOf(q - e1);
+                                const uint32_t v2 = vertexOf(q - e1 - e2), v3 = vertexOf(q - e2);
+                                // 逆时针绕 +a；起点在内侧时外法线朝 +a，否则反过来
+                                if (inside) chunk.indices.insert(chunk.indices.end(), {v0, v1, v2, v0, v2, v3});
+                                else chunk.indices.insert(chunk.indices.end(), {v0, v3, v2, v0, v2, v1});
+                            }
+                        }
+            }
+        }
+    });
+
+    _stats.bricks        = bricks;
+    _stats.active_bricks = active;
+    _stats.vertices      = vertices;
+    _stats.triangles     = 0;
+    for (const Chunk& chunk : _chunks) _stats.triangles += static_cast<i64>(chunk.indices.size() / 3);
+}
+
+void IsoSurfaceExtractor::gather(std::vector<vec3>& positions, std::vector<vec3>& normals,
+                                 std::vector<uint32_t>& indices) const
+{
+    std::vector<size_t> index_offset(_chunks.size() + 1, 0);
+    for (size_t c = 0; c < _chunks.size(); ++c) index_offset[c + 1] = index_offset[c] + _chunks[c].indices.size();
+
+    positions.resize(static_cast<size_t>(_stats.vertices));
+    normals.resize(static_cast<size_t>(_stats.vertices));
+    indices.resize(index_offset.back());
+    parallelForSlabs(0, static_cast<i64>(_chunks.size()), [&](i64 c0, i64 c1)
+    {
+        for (i64 c = c0; c < c1; ++c)
+        {
+            const Chunk& chunk = _chunks[c];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.vertex_offset);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.vertex_offset);
+            std::copy(chunk.indices.begin(), chunk.indices.end(), indices.begin() + index_offset[c]);
+        }
+    });
+}
+}
@@ -0,0 +1,303 @@
+// fluid/LbmSystem.cpp
+#include "fluid/LbmSystem.h"
+
+#include <algorithm>
+
+#include "Parallel.h"
+
+namespace dk {
+namespace {
+using CellType    = LatticeBoltzmannSystem::CellType;
+constexpr int kQ  = LatticeBoltzmannSystem::kQ;
+
+// D3Q19：静止 + 6 个轴向 + 12 个棱向，方向 2m-1 与 2m 互为反向
+constexpr int kC[kQ][3] = {
+    {0, 0, 0},
+    {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1},
+    {1, 1, 0}, {-1, -1, 0}, {1, -1, 0}, {-1, 1, 0},
+    {1, 0, 1}, {-1, 0, -1}, {1, 0, -1}, {-1, 0, 1},
+    {0, 1, 1}, {0, -1, -1}, {0, 1, -1}, {0, -1, 1}};
+
+constexpr float kW[kQ] = {
+    1.0f / 3.0f,
+    1.0f / 18.0f, 1.0f / 18.0f, 1.0f / 18.0f, 1.0f / 18.0f, 1.0f / 18.0f, 1.0f / 18.0f,
+    1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f,
+    1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f, 1.0f / 36.0f};
+
+constexpr int opposite(int q) { return q == 0 ? 0 : (q % 2 ? q + 1 : q - 1); }
+
+inline float equilibrium(int q, float rho, const vec3& u, float usq)
+{
+    const float cu = kC[q][0] * u.x + kC[q][1] * u.y + kC[q][2] * u.z;
+    return kW[q] * rho * (1.0f + 3.0f * cu + 4.5f * cu * cu - 1.5f * usq);
+}
+
+inline void momentsOf(const float f[kQ], float& rho, vec3& u)
+{
+    rho = 0.0f;
+    u   = vec3(0.0f);
+    for (int q = 0; q < kQ; ++q)
+    {
+        rho += f[q];
+        u += f[q] * vec3(kC[q][0], kC[q][1], kC[q][2]);
+    }
+    u /= rho;
+}
+}
+
+LatticeBoltzmannSystem::LatticeBoltzmannSystem(const Config& cfg)
+    : cfg_(cfg), grid_(cfg.nx, cfg.ny, cfg.nz, cfg.h, cfg.origin)
+{
+    pdims_ = glm::ivec3(cfg.nx, cfg.ny, cfg.nz) + 2;
+    cells_ = static_cast<size_t>(pdims_.x) * pdims_.y * pdims_.z;
+    for (int q = 0; q < kQ; ++q)
+    {
+        offsets_[q] = (static_cast<i64>(kC[q][2]) * pdims_.y + kC[q][1]) * pdims_.x + kC[q][0];
+    }
+
+    // 幽灵层是固壁；风洞时 x 两端的内层 cell 做入口/出口
+    type_.assign(cells_, CellType::Solid);
+    for (int k = 0; k < cfg.nz; ++k)
+        for (int j = 0; j < cfg.ny; ++j)
+            for (int i = 0; i < cfg.nx; ++i)
+            {
+                CellType t = CellType::Fluid;
+                if (cfg.wind_tunnel && i == 0) t = CellType::Inlet;
+                if (cfg.wind_tunnel && i == cfg.nx - 1) t = CellType::Outlet;
+                type_[cellIndex(i, j, k)] = t;
+            }
+
+    f_.resize(cells_ * kQ);
+    initEquilibrium();
+}
+
+void LatticeBoltzmannSystem::initEquilibrium()
+{
+    // 流场从 inflow 速度的平衡态出发；按 slab 首次触碰
+    const vec3  u   = cfg_.inflow;
+    const float usq = glm::dot(u, u);
+    parallelForSlabs(0, pdims_.z, [&](i64 z0, i64 z1)
+    {
+        const size_t b = static_cast<size_t>(z0) * pdims_.x * pdims_.y, e = static_cast<size_t>(z1) * pdims_.x * pdims_.y;
+        for (int q = 0; q < kQ; ++q)
+        {
+            float*      f  = dist(q);
+            const float fq = equilibrium(q, 1.0f, u, usq);
+            for (size_t n = b; n < e; ++n) f[n] = type_[n] == CellType::Solid ? 0.0f : fq;
+        }
+    });
+    odd_next_ = false;
+}
+
+void LatticeBoltzmannSystem::setSolid(int i, int j, int k, bool solid)
+{
+    const size_t n = cellIndex(i, j, k);
+    if (solid)
+    {
+        type_[n] = CellType::Solid;
+        return;
+    }
+    if (type_[n] != CellType::Solid) return;
+
+    // 重新开放的 cell 从静止平衡态开始，只写本 cell 的槽位：奇数步之后下一次更新读的就是它们；
+    // 偶数步之后流入分布来自邻居的反向槽位，邻居每步都照常写回，那里本来就是有效值
+    type_[n] = cfg_.wind_tunnel && i == 0 ? CellType::Inlet
+               : cfg_.wind_tunnel && i == cfg_.nx - 1 ? CellType::Outlet
+               : CellType::Fluid;
+    for (int q = 0; q < kQ; ++q) dist(q)[n] = kW[q];
+}
+
+void LatticeBoltzmannSystem::addSphere(const vec3& center, float radius)
+{
+    for (int k = 0; k < cfg_.nz; ++k)
+        for (int j = 0; j < cfg_.ny; ++j)
+            for (int i = 0; i < cfg_.nx; ++i)
+            {
+                if (glm::length(grid_.cellCenter(i, j, k) - center) <= radius) setSolid(i, j, k);
+            }
+}
+
+void LatticeBoltzmannSystem::step(float dt)
+{
+    acc_ += dt;
+    while (acc_ >= cfg_.lattice_dt)
+    {
+        acc_ -= cfg_.lattice_dt;
+        if (odd_next_) update<true>();
+        else update<false>();
+        odd_next_ = !odd_next_;
+        ++steps_;
+    }
+}
+
+template <bool Odd>
+void LatticeBoltzmannSystem::update()
+{
+    const float omega = 1.0f / cfg_.tau;
+    const vec3  u_in  = cfg_.inflow;
+    const int   nx    = cfg_.nx;
+
+    // 逐行处理：先把一行的 19 个分布读进行缓冲，矩和碰撞都是沿 x 的连续循环，便于向量化；
+    // cell 类型只在取数/写回时做 select，没有分支。行缓冲每个线程一份、跨步保留：
+    // 按线程数分块，第 c 块总由第 c 个线程处理，它的缓冲也由它首次触碰
+    const int    chunks = std::min(SlabPool::instance().threadCount(), cfg_.nz);
+    const size_t stride = static_cast<size_t>(kQ + 4) * nx;
+    if (row_buf_.size() != chunks * stride) row_buf_.assign(chunks * stride, 0.0f);
+    parallelForSlabs(0, chunks, [&](i64 c0, i64 c1)
+    {
+        for (int c = static_cast<int>(c0); c < static_cast<int>(c1); ++c)
+        {
+            float* buf = row_buf_.data() + c * stride;
+            float* fin[kQ];
+            for (int q = 0; q < kQ; ++q) fin[q] = buf + static_cast<size_t>(q) * nx;
+            float* rho = buf + static_cast<size_t>(kQ) * nx;
+            float* ux  = rho + nx;
+            float* uy  = ux + nx;
+            float* uz  = uy + nx;
+
+            const int k0 = cfg_.nz * c / chunks, k1 = cfg_.nz * (c + 1) / chunks;
+            for (int k = k0; k < k1; ++k)
+                for (int j = 0; j < cfg_.ny; ++j)
+                {
+                    const size_t    row  = cellIndex(0, j, k);
+                    const CellType* type = type_.data() + row;
+
+                    // 取流入分布：偶数步在本 cell 的同向槽位；奇数步在上游邻居的反向槽位，上游是固壁时为本 cell 的同向槽位（反弹）
+                    for (int q = 0; q < kQ; ++q)
+                    {
+                        const float* own = dist(q) + row;
+                        if constexpr (Odd)
+                        {
+                            const i64       off  = offsets_[q];
+                            const float*    up   = dist(opposite(q)) + row - off;
+                            const CellType* upty = type - off;
+                            for (int i = 0; i < nx; ++i) fin[q][i] = upty[i] == CellType::Solid ? own[i] : up[i];
+                        }
+                        else
+                        {
+                            for (int i = 0; i < nx; ++i) fin[q][i] = own[i];
+                        }
+                    }
+
+                    for (int i = 0; i < nx; ++i) rho[i] = ux[i] = uy[i] = uz[i] = 0.0f;
+                    for (int q = 0; q < kQ; ++q)
+                    {
+                        const float cx = static_cast<float>(kC[q][0]), cy = static_cast<float>(kC[q][1]), cz = static_cast<float>(kC[q][2]);
+                        for (int i = 0; i < nx; ++i)
+                        {
+                            rho[i] += fin[q][i];
+                            ux[i] += cx * fin[q][i];
+                            uy[i] += cy * fin[q][i];
+                            uz[i] += cz * fin[q][i];
+                        }
+                    }
+                    for (int i = 0; i < nx; ++i)
+                    {
+                        // 入口：ρ = 1、u = 入口速度；出口：ρ = 1、保留本地速度；固壁 cell 的结果不会写回
+                        const float r  = rho[i] > 0.0f ? rho[i] : 1.0f;
+                        const bool  in = type[i] == CellType::Inlet;
+                        ux[i]          = in ? u_in.x : ux[i] / r;
+                        uy[i]          = in ? u_in.y : uy[i] / r;
+                        uz[i]          = in ? u_in.z : uz[i] / r;
+                        rho[i]         = type[i] == CellType::Fluid ? r : 1.0f;
+                    }
+
+                    for (int q = 0; q < kQ; ++q)
+                    {
+                        const float cx = static_cast<float>(kC[q][0]), cy = static_cast<float>(kC[q][1]), cz = static_cast<float>(kC[q][2]);
+                        const i64   off = offsets_[q];
+                        float*      fwd = dist(q) + row + off;        // 奇数步：推到下游邻居的同向槽位
+                        float*      bck = dist(opposite(q)) + row;    // 偶数步 / 下游是固壁：本 cell 的反向槽位
+                        const CellType* dnty = type + off;
+                        for (int i = 0; i < nx; ++i)
+                        {
+                            const float cu  = cx * ux[i] + cy * uy[i] + cz * uz[i];
+                            const float usq = ux[i] * ux[i] + uy[i] * uy[i] + uz[i] * uz[i];
+                            const float feq = kW[q] * rho[i] * (1.0f + 3.0f * cu + 4.5f * cu * cu - 1.5f * usq);
+                            const float out = type[i] == CellType::Fluid ? fin[q][i] + omega * (feq - fin[q][i]) : feq;
+                            if (type[i] == CellType::Solid) continue;
+                            if constexpr (Odd) (dnty[i] == CellType::Solid ? bck[i] : fwd[i]) = out;
+                            else bck[i] = out;
+                        }
+                    }
+                }
+        }
+    });
+}
+
+void LatticeBoltzmannSystem::moments(size_t n, float& rho, vec3& u) const
+{
+    // 取下一次更新的流入分布：奇数步之后就在本 cell；偶数步之后按奇数步的取法从上游邻居收集
+    float fin[kQ];
+    for (int q = 0; q < kQ; ++q)
+    {
+        const size_t up = n - offsets_[q];
+        fin[q]          = odd_next_ && type_[up] != CellType::Solid ? dist(opposite(q))[up] : dist(q)[n];
+    }
+    momentsOf(fin, rho, u);
+}
+
+float LatticeBoltzmannSystem::density(int i, int j, int k) const
+{
+    const size_t n = cellIndex(i, j, k);
+    if (type_[n] == CellType::Solid) return 1.0f;
+    float rho;
+    vec3  u;
+    moments(n, rho, u);
+    return rho;
+}
+
+vec3 LatticeBoltzmannSystem::velocity(int i, int j, int k) const
+{
+    const size_t n = cellIndex(i, j, k);
+    if (type_[n] == CellType::Solid) return vec3(0.0f);
+    float rho;
+    vec3  u;
+    moments(n, rho, u);
+    return u;
+}
+
+const MacGrid& LatticeBoltzmannSystem::grid() const
+{
+    if (exported_ == steps_) return grid_;
+    exported_ = steps_;
+
+    const float      scale = cfg_.h / cfg_.lattice_dt; // 格子速度 -> m/s
+    const glm::ivec3 n(cfg_.nx, cfg_.ny, cfg_.nz);
+    Field&           ucell = grid_.u_tmp(); // cell 速度的三个分量暂存到 scratch
+    Field&           vcell = grid_.v_tmp();
+    Field&           wcell = grid_.w_tmp();
+    ucell.resize(grid_.fieldSize(MacGrid::FieldKind::Center));
+    vcell.resize(ucell.size());
+    wcell.resize(ucell.size());
+
+    parallelForGrid<3>(n, [&](int i, int j, int k)
+    {
+        const size_t c     = grid_.idxP(i, j, k);
+        const size_t m     = cellIndex(i, j, k);
+        const bool   solid = type_[m] == CellType::Solid;
+        float        rho   = 1.0f;
+        vec3         u(0.0f);
+        if (!solid) moments(m, rho, u);
+        ucell[c]             = u.x * scale;
+        vcell[c]             = u.y * scale;
+        wcell[c]             = u.z * scale;
+        grid_.P(i, j, k)     = (rho - 1.0f) / 3.0f * scale * scale;
+        grid_.Dye(i, j, k)   = solid ? 1.0f : 0.0f;
+    });
+
+    // 面速度取两侧 cell 的平均，域边界面取内侧 cell
+    auto face = [&](const Field& cell, int a, int i, int j, int k)
+    {
+        glm::ivec3 lo(i, j, k), hi(i, j, k);
+        lo[a] -= 1;
+        lo[a] = std::max(lo[a], 0);
+        hi[a] = std::min(hi[a], n[a] - 1);
+        return 0.5f * (cell[grid_.idxP(lo.x, lo.y, lo.z)] + cell[grid_.idxP(hi.x, hi.y, hi.z)]);
+    };
+    parallelForGrid<3>(grid_.fieldDims(MacGrid::FieldKind::U), [&](int i, int j, int k) { grid_.U(i, j, k) = face(ucell, 0, i, j, k); });
+    parallelForGrid<3>(grid_.fieldDims(MacGrid::FieldKind::V), [&](int i, int j, int k) { grid_.V(i, j, k) = face(vcell, 1, i, j, k); });
+    parallelForGrid<3>(grid_.fieldDims(MacGrid::FieldKind::W), [&](int i, int j, int k) { grid_.W(i, j, k) = face(wcell, 2, i, j, k); });
+    return grid_;
+}
+}
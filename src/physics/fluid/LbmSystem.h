@@ -0,0 +1,99 @@
+// fluid/LbmSystem.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "World.h"
+#include "data/MacGrid.h"
+
+namespace dk {
+/**
+ * D3Q19 格子 Boltzmann 流体（BGK 碰撞），用于风洞类的外流问题.
+ * 每个 cell 的更新只读写自己和 18 个邻居，没有全局迭代，随核数与内存带宽几乎线性扩展。
+ *
+ * - 分布函数按方向 SoA 存放（19 个连续数组），外面补一圈固壁幽灵 cell，内层循环没有越界判断
+ * - AA 模式就地更新：偶数步只读写本 cell 的 19 个槽位（碰撞后按反方向写回）；
+ *   奇数步从邻居取来、碰撞后推回邻居，每个槽位恰好被一个 cell 读写，无需第二份分布数组，线程间也不冲突
+ * - 固壁为半程反弹（half-way bounce-back），在奇数步按邻居类型选取槽位完成
+ * - 按 z 切 slab 并行
+ * 速度在格子单位下求解；grid() 把它换算成物理单位导出到一个 MacGrid（面心 u/v/w，压力放在 p），
+ * 现有的 MacGrid 点/矢量渲染器不用改就能显示。
+ */
+class LatticeBoltzmannSystem : public ISystem
+{
+public:
+    static constexpr int kQ = 19;
+
+    struct Config
+    {
+        int   nx = 64, ny = 32, nz = 32;
+        float h          = 0.02f;
+        vec3  origin     = vec3(0);
+        float tau        = 0.56f;          // BGK 松弛时间（格子单位），运动黏度 ν = (τ - 0.5) / 3，须 > 0.5
+        float lattice_dt = 1.0f / 200.0f;  // 一个格子步对应的物理时间 (s)
+        bool  wind_tunnel = true;          // x- 面为速度入口、x+ 面为压力出口；否则六面都是固壁
+        vec3  inflow      = vec3(0.05f, 0.0f, 0.0f); // 入口速度，也是初始速度（格子单位，|u| 宜小于 0.1）
+    };
+
+    // cell 类型
+    enum class CellType : std::uint8_t
+    {
+        Fluid,
+        Solid,
+        Inlet,  // 每步重置为入口速度的平衡态
+        Outlet  // 每步重置为 ρ = 1、本地速度的平衡态
+    };
+
+    explicit LatticeBoltzmannSystem(const Config& cfg = Config{});
+
+    // 按 lattice_dt 累计时间，每满一个格子步更新一次
+    void step(float dt) override;
+    // 速度场的显示走 grid() + MacGrid 渲染器，这里不导出点
+    void getRenderData(std::vector<PointData>& out_data) const override { out_data.clear(); }
+
+    // 障碍物：把 cell 设为固壁（或恢复为流体）；球心与半径为世界坐标
+    void setSolid(int i, int j, int k, bool solid = true);
+    void addSphere(const vec3& center, float radius);
+    bool isSolid(int i, int j, int k) const { return type_[cellIndex(i, j, k)] == CellType::Solid; }
+
+    // 格子单位的宏观量
+    float density(int i, int j, int k) const;
+    vec3  velocity(int i, int j, int k) const;
+
+    // 最近一次导出后若又走过格子步则重新导出：u/v/w 为物理速度（相邻 cell 平均到面），
+    // p 为运动学压力 (ρ - 1) c_s² 的物理单位，固壁 cell 的 dye 为 1（方便渲染障碍物）
+    const MacGrid& grid() const;
+
+    const Config& config() const { return cfg_; }
+    i64           latticeSteps() const { return steps_; }
+
+private:
+    // 补幽灵层后的线性下标
+    size_t cellIndex(int i, int j, int k) const
+    {
+        return (static_cast<size_t>(k + 1) * pdims_.y + (j + 1)) * pdims_.x + (i + 1);
+    }
+    float*       dist(int q) { return f_.data() + static_cast<size_t>(q) * cells_; }
+    const float* dist(int q) const { return f_.data() + static_cast<size_t>(q) * cells_; }
+
+    template <bool Odd>
+    void update();
+    // cell n 在下一次更新前的流入分布的矩（与双缓冲推送格式在同一时刻的状态一致）
+    void moments(size_t n, float& rho, vec3& u) const;
+    void initEquilibrium();
+
+    Config                cfg_;
+    glm::ivec3            pdims_{0}; // 含幽灵层
+    size_t                cells_ = 0;
+    Field                 f_;        // 19 个方向依次排列，每段 cells_ 个
+    std::vector<CellType> type_;
+    i64                   offsets_[kQ]{}; // 各方向邻居的线性偏移
+    std::vector<float>    row_buf_;       // update 的行缓冲，每个线程 (kQ + 4) * nx 个
+    bool                  odd_next_ = false;
+    i64                   steps_    = 0;
+    float                 acc_      = 0.0f;
+
+    mutable MacGrid grid_;
+    mutable i64     exported_ = -1;
+};
+}
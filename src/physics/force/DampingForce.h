@@ -16,7 +16,7 @@ public:
         const size_t count = data.size();
         for (size_t i = 0; i < count; ++i)
         {
-            if (!data.is_fixed[i])
+            if (data.isActive(i))
             {
                 data.force[i] -= _constant_factor * data.velocity[i];
             }
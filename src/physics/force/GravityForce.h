@@ -16,7 +16,7 @@ public:
         const size_t count = data.size();
         for (size_t i = 0; i < count; ++i)
         {
-            if (!data.is_fixed[i])
+            if (data.isActive(i))
             {
                 data.force[i] += data.mass[i] * gravity;
                 //data.acceleration[i] += gravity;
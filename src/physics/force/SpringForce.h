@@ -16,6 +16,9 @@ public:
     {
         for (size_t i = 0; i < _topology.size(); ++i)
         {
+            // 两端都固定或休眠时没有人受力
+            if (!data.isActive(_topology.index_a[i]) && !data.isActive(_topology.index_b[i])) continue;
+
             glm::vec3& posA = data.position[_topology.index_a[i]];
             glm::vec3& posB = data.position[_topology.index_b[i]];
 
@@ -26,11 +29,11 @@ public:
             float     forceMagnitude = -_topology.stiffness[i] * (distance - _topology.rest_length[i]);
             glm::vec3 force          = forceMagnitude * (direction / distance);
 
-            if (!data.is_fixed[_topology.index_a[i]])
+            if (data.isActive(_topology.index_a[i]))
             {
                 data.force[_topology.index_a[i]] -= force;
             }
-            if (!data.is_fixed[_topology.index_b[i]])
+            if (data.isActive(_topology.index_b[i]))
             {
                 data.force[_topology.index_b[i]] += force;
             }
@@ -10,7 +10,7 @@ namespace dk {
 inline i64 makeKey(int ix, int iy, int iz)
 {
     // pack with large primes to reduce collisions
-    constexpr constexpr constexpr i64 p1 = 73856093, p2 = 19349663, p3 = 83492791;
+    constexpr i64 p1 = 73856093, p2 = 19349663, p3 = 83492791;
     return (ix * p1) ^ (iy * p2) ^ (iz * p3);
 }
 
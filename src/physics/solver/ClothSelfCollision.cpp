@@ -0,0 +1,344 @@
+// solver/ClothSelfCollision.cpp
+#include "solver/ClothSelfCollision.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "Parallel.h"
+#include "collider/Distance.h"
+
+namespace dk {
+namespace {
+vec3 lerpPosition(const ParticleData& data, uint32_t i, float t)
+{
+    return data.previous_position[i] + (data.position[i] - data.previous_position[i]) * t;
+}
+
+float weight(const ParticleData& data, uint32_t i)
+{
+    return data.is_fixed[i] ? 0.0f : data.inv_mass[i];
+}
+
+// f 在 [0,1] 上是三次多项式：由 t = 0, 1/3, 2/3, 1 的取值得到系数，在导数零点处分段，
+// 每段有变号就二分求根；返回最早的根，没有时返回 -1
+template <class Fn>
+float earliestCubicRoot(Fn&& f)
+{
+    const float f0 = f(0.0f), f1 = f(1.0f / 3.0f), f2 = f(2.0f / 3.0f), f3 = f(1.0f);
+    if (f0 == 0.0f) return 0.0f;
+
+    // u = 3t 下的牛顿前向差分
+    const float d1 = f1 - f0, d2 = f2 - 2.0f * f1 + f0, d3 = f3 - 3.0f * f2 + 3.0f * f1 - f0;
+    const float a3 = d3 / 6.0f, a2 = 0.5f * (d2 - d3), a1 = d1 - 0.5f * d2 + d3 / 3.0f;
+
+    // f'(u) = 3 a3 u² + 2 a2 u + a1 的零点把 [0, 3] 切成单调段
+    float cuts[4] = {0.0f, 3.0f, 3.0f, 3.0f};
+    int   ncut    = 1;
+    const float qa = 3.0f * a3, qb = 2.0f * a2, qc = a1;
+    if (std::fabs(qa) > 1e-20f)
+    {
+        const float disc = qb * qb - 4.0f * qa * qc;
+        if (disc >= 0.0f)
+        {
+            const float sq = std::sqrt(disc);
+            float       r0 = (-qb - sq) / (2.0f * qa), r1 = (-qb + sq) / (2.0f * qa);
+            if (r0 > r1) std::swap(r0, r1);
+            if (r0 > 0.0f && r0 < 3.0f) cuts[ncut++] = r0;
+            if (r1 > 0.0f && r1 < 3.0f) cuts[ncut++] = r1;
+        }
+    }
+    else if (std::fabs(qb) > 1e-20f)
+    {
+        const float r = -qc / qb;
+        if (r > 0.0f && r < 3.0f) cuts[ncut++] = r;
+    }
+    cuts[ncut++] = 3.0f;
+
+    for (int s = 0; s + 1 < ncut; ++s)
+    {
+        float lo = cuts[s] / 3.0f, hi = cuts[s + 1] / 3.0f;
+        float flo = f(lo), fhi = f(hi);
+        if (flo == 0.0f) return lo;
+        if ((flo < 0.0f) == (fhi < 0.0f) && fhi != 0.0f) continue;
+        for (int it = 0; it < 32; ++it)
+        {
+            const float mid  = 0.5f * (lo + hi);
+            const float fmid = f(mid);
+            if ((fmid < 0.0f) == (flo < 0.0f) && fmid != 0.0f)
+            {
+                lo  = mid;
+                flo = fmid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return hi;
+    }
+    return -1.0f;
+}
+
+// 顶点 v 与三角形 (a, b, c) 在子步内是否相交：共面时刻落在三角形内
+bool vertexTriangleCcd(const ParticleData& data, uint32_t v, uint32_t a, uint32_t b, uint32_t c)
+{
+    auto coplanar = [&](float t)
+    {
+        const vec3 pa = lerpPosition(data, a, t);
+        return dot(cross(lerpPosition(data, b, t) - pa, lerpPosition(data, c, t) - pa), lerpPosition(data, v, t) - pa);
+    };
+    const float t = earliestCubicRoot(coplanar);
+    if (t < 0.0f) return false;
+
+    constexpr float tol = 1e-3f;
+    const vec3      w   = triangleBarycentric(lerpPosition(data, v, t), lerpPosition(data, a, t), lerpPosition(data, b, t),
+                                              lerpPosition(data, c, t));
+    return w.x >= -tol && w.y >= -tol && w.z >= -tol;
+}
+
+// 两条边在子步内是否相交：共面时刻两线段最近点重合
+bool edgeEdgeCcd(const ParticleData& data, uint32_t p1, uint32_t p2, uint32_t q1, uint32_t q2)
+{
+    auto coplanar = [&](float t)
+    {
+        const vec3 a = lerpPosition(data, p1, t), c = lerpPosition(data, q1, t);
+        return dot(c - a, cross(lerpPosition(data, p2, t) - a, lerpPosition(data, q2, t) - c));
+    };
+    const float t = earliestCubicRoot(coplanar);
+    if (t < 0.0f) return false;
+
+    const vec3 a = lerpPosition(data, p1, t), b = lerpPosition(data, p2, t);
+    const vec3 c = lerpPosition(data, q1, t), d = lerpPosition(data, q2, t);
+    float      s, u;
+    closestPointsOnSegments(a, b, c, d, s, u);
+    const vec3  gap   = (a + (b - a) * s) - (c + (d - c) * u);
+    const float scale = std::max(length(b - a), length(d - c));
+    return dot(gap, gap) <= 1e-6f * scale * scale;
+}
+}
+
+void ClothSelfCollision::rebuild(const TriangleTopology& triangles)
+{
+    indices_ = triangles.indices;
+    version_ = triangles.version;
+
+    edges_.clear();
+    edges_.reserve(indices_.size());
+    for (size_t t = 0; t < triangles.size(); ++t)
+    {
+        for (int e = 0; e < 3; ++e)
+        {
+            uint32_t a = indices_[3 * t + e], b = indices_[3 * t + (e + 1) % 3];
+            if (a > b) std::swap(a, b);
+            edges_.push_back({a, b});
+        }
+    }
+    std::sort(edges_.begin(), edges_.end());
+    edges_.erase(std::unique(edges_.begin(), edges_.end()), edges_.end());
+
+    vertices_ = indices_;
+    std::sort(vertices_.begin(), vertices_.end());
+    vertices_.erase(std::unique(vertices_.begin(), vertices_.end()), vertices_.end());
+
+    tri_boxes_.assign(triangles.size(), AABB{});
+    edge_boxes_.assign(edges_.size(), AABB{});
+}
+
+void ClothSelfCollision::refit(const ParticleData& data)
+{
+    const vec3 pad(params_.thickness);
+    auto       swept = [&](AABB& box, uint32_t i)
+    {
+        box.expand(data.previous_position[i]);
+        box.expand(data.position[i]);
+    };
+    parallelForSlabs(0, static_cast<i64>(tri_boxes_.size()), [&](i64 b, i64 e)
+    {
+        for (i64 t = b; t < e; ++t)
+        {
+            AABB box;
+            for (int v = 0; v < 3; ++v) swept(box, indices_[3 * t + v]);
+            tri_boxes_[t] = AABB{box.min - pad, box.max + pad};
+        }
+    });
+    parallelForSlabs(0, static_cast<i64>(edge_boxes_.size()), [&](i64 b, i64 e)
+    {
+        for (i64 k = b; k < e; ++k)
+        {
+            AABB box;
+            swept(box, edges_[k][0]);
+            swept(box, edges_[k][1]);
+            edge_boxes_[k] = AABB{box.min - pad, box.max + pad};
+        }
+    });
+}
+
+void ClothSelfCollision::detect(const ParticleData& data, const TriangleTopology& triangles)
+{
+    vt_.clear();
+    ee_.clear();
+    if (triangles.empty()) return;
+
+    const bool topology_changed = triangles.version != version_;
+    if (topology_changed) rebuild(triangles);
+    refit(data);
+    if (topology_changed)
+    {
+        tri_bvh_.build(tri_boxes_);
+        edge_bvh_.build(edge_boxes_);
+    }
+    else
+    {
+        tri_bvh_.refit(tri_boxes_);
+        edge_bvh_.refit(edge_boxes_);
+    }
+
+    const float     h    = params_.thickness;
+    const vec3      pad(h);
+    std::mutex      merge;
+
+    // 顶点-三角形
+    parallelForSlabs(0, static_cast<i64>(vertices_.size()), [&](i64 b, i64 e)
+    {
+        std::vector<VertexTriangle> found;
+        for (i64 k = b; k < e; ++k)
+        {
+            const uint32_t v = vertices_[k];
+            AABB           box;
+            box.expand(data.previous_position[v]);
+            box.expand(data.position[v]);
+            box = AABB{box.min - pad, box.max + pad};
+
+            tri_bvh_.query(box, [&](int t)
+            {
+                const uint32_t a = indices_[3 * t], bb = indices_[3 * t + 1], c = indices_[3 * t + 2];
+                if (v == a || v == bb || v == c) return;
+                // 四个点都固定或休眠时不会相对运动
+                if (!(data.isActive(v) || data.isActive(a) || data.isActive(bb) || data.isActive(c))) return;
+
+                const vec3 p1   = data.position[v];
+                const vec3 near = closestPointOnTriangle(p1, data.position[a], data.position[bb], data.position[c]);
+                const bool close = dot(p1 - near, p1 - near) < 4.0f * h * h;
+                if (!close && !vertexTriangleCcd(data, v, a, bb, c)) return;
+
+                // 起点时顶点在哪一侧
+                const vec3& a0   = data.previous_position[a];
+                const vec3  n0   = cross(data.previous_position[bb] - a0, data.previous_position[c] - a0);
+                const float side = dot(n0, data.previous_position[v] - a0);
+                found.push_back({v, static_cast<uint32_t>(t), side < 0.0f ? -1.0f : 1.0f});
+            });
+        }
+        std::lock_guard lock(merge);
+        vt_.insert(vt_.end(), found.begin(), found.end());
+    });
+
+    // 边-边
+    parallelForSlabs(0, static_cast<i64>(edges_.size()), [&](i64 b, i64 e)
+    {
+        std::vector<EdgeEdge> found;
+        for (i64 k = b; k < e; ++k)
+        {
+            const auto [p1, p2] = edges_[k];
+            edge_bvh_.query(edge_boxes_[k], [&](int other)
+            {
+                if (other <= k) return;
+                const auto [q1, q2] = edges_[other];
+                if (p1 == q1 || p1 == q2 || p2 == q1 || p2 == q2) return;
+                if (!(data.isActive(p1) || data.isActive(p2) || data.isActive(q1) || data.isActive(q2))) return;
+
+                float s, t;
+                closestPointsOnSegments(data.position[p1], data.position[p2], data.position[q1], data.position[q2], s, t);
+                const vec3 gap   = mix(data.position[p1], data.position[p2], s) - mix(data.position[q1], data.position[q2], t);
+                const bool close = dot(gap, gap) < 4.0f * h * h;
+                if (!close && !edgeEdgeCcd(data, p1, p2, q1, q2)) return;
+
+                // 起点时的分离方向：两边叉积，朝向从边 b 指向边 a；近乎平行时退化为最近点连线
+                const vec3& a0 = data.previous_position[p1];
+                const vec3& b0 = data.previous_position[p2];
+                const vec3& c0 = data.previous_position[q1];
+                const vec3& d0 = data.previous_position[q2];
+                closestPointsOnSegments(a0, b0, c0, d0, s, t);
+                const vec3 sep = mix(a0, b0, s) - mix(c0, d0, t);
+                vec3       n   = cross(b0 - a0, d0 - c0);
+                const float nl = length(n);
+                if (nl > 1e-6f * length(b0 - a0) * length(d0 - c0))
+                {
+                    n /= nl;
+                    if (dot(n, sep) < 0.0f) n = -n;
+                }
+                else
+                {
+                    const float sl = length(sep);
+                    if (sl <= 0.0f) return;
+                    n = sep / sl;
+                }
+                found.push_back({static_cast<uint32_t>(k), static_cast<uint32_t>(other), n});
+            });
+        }
+        std::lock_guard lock(merge);
+        ee_.insert(ee_.end(), found.begin(), found.end());
+    });
+
+    // 合并顺序取决于线程调度，排序后投影顺序固定，结果可复现
+    std::sort(vt_.begin(), vt_.end(), [](const VertexTriangle& x, const VertexTriangle& y)
+    {
+        return x.vertex != y.vertex ? x.vertex < y.vertex : x.triangle < y.triangle;
+    });
+    std::sort(ee_.begin(), ee_.end(), [](const EdgeEdge& x, const EdgeEdge& y) { return x.a != y.a ? x.a < y.a : x.b < y.b; });
+}
+
+void ClothSelfCollision::project(ParticleData& data) const
+{
+    const float h = params_.thickness;
+
+    for (const VertexTriangle& c : vt_)
+    {
+        const uint32_t v = c.vertex, a = indices_[3 * c.triangle], b = indices_[3 * c.triangle + 1], t = indices_[3 * c.triangle + 2];
+        vec3&          p  = data.position[v];
+        vec3&          pa = data.position[a];
+        vec3&          pb = data.position[b];
+        vec3&          pc = data.position[t];
+
+        vec3        n  = cross(pb - pa, pc - pa);
+        const float nl = length(n);
+        if (nl <= 0.0f) continue;
+        n *= c.side / nl;
+
+        // 只有投影落在三角形内时才是顶点-三角形接触，落在外面交给边-边
+        const vec3 w = triangleBarycentric(p, pa, pb, pc);
+        if (w.x < 0.0f || w.y < 0.0f || w.z < 0.0f) continue;
+
+        const float C = dot(p - pa, n) - h;
+        if (C >= 0.0f) continue;
+
+        const float wv = weight(data, v), wa = weight(data, a), wb = weight(data, b), wc = weight(data, t);
+        const float denom = wv + w.x * w.x * wa + w.y * w.y * wb + w.z * w.z * wc;
+        if (denom <= 0.0f) continue;
+        const float lambda = -C / denom;
+        p += (wv * lambda) * n;
+        pa -= (wa * w.x * lambda) * n;
+        pb -= (wb * w.y * lambda) * n;
+        pc -= (wc * w.z * lambda) * n;
+    }
+
+    for (const EdgeEdge& c : ee_)
+    {
+        const uint32_t p1 = edges_[c.a][0], p2 = edges_[c.a][1], q1 = edges_[c.b][0], q2 = edges_[c.b][1];
+        float          s, t;
+        closestPointsOnSegments(data.position[p1], data.position[p2], data.position[q1], data.position[q2], s, t);
+
+        const vec3  gap = mix(data.position[p1], data.position[p2], s) - mix(data.position[q1], data.position[q2], t);
+        const float C   = dot(gap, c.normal) - h;
+        if (C >= 0.0f) continue;
+
+        const float w1 = weight(data, p1), w2 = weight(data, p2), w3 = weight(data, q1), w4 = weight(data, q2);
+        const float denom = w1 * (1 - s) * (1 - s) + w2 * s * s + w3 * (1 - t) * (1 - t) + w4 * t * t;
+        if (denom <= 0.0f) continue;
+        const float lambda = -C / denom;
+        data.position[p1] += (w1 * (1 - s) * lambda) * c.normal;
+        data.position[p2] += (w2 * s * lambda) * c.normal;
+        data.position[q1] -= (w3 * (1 - t) * lambda) * c.normal;
+        data.position[q2] -= (w4 * t * lambda) * c.normal;
+    }
+}
+}
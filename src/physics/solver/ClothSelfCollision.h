@@ -0,0 +1,69 @@
+// solver/ClothSelfCollision.h
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "BVH/BVH.hpp"
+#include "data/Particle.h"
+
+namespace dk {
+/**
+ * 布料三角形级自碰撞（顶点-三角形 VT 与边-边 EE），给 PBD 的约束迭代用.
+ * - 三角形与边各一棵 BVH（core/BVH），图元包围盒取子步起点 previous_position 到预测位置 position 的扫掠盒，
+ *   每个子步只 refit，三角形拓扑变化时才重建
+ * - detect() 按顶点 / 边并行遍历 BVH，扫掠盒相交后再用连续碰撞检测（共面三次方程求根）与终点距离筛选，
+ *   得到的候选对记下子步起点时的相对朝向
+ * - project() 在每次约束迭代中把候选对推回起点时所在的一侧，间距至少 thickness，按逆质量与重心权重分摊
+ * 子步内的穿越由 CCD 发现，约束方向取起点时的朝向，所以大步长下也不会把顶点推到错误的一侧。
+ */
+class ClothSelfCollision
+{
+public:
+    struct Params
+    {
+        float thickness = 0.01f; // 布料两面之间保持的最小距离
+    };
+
+    explicit ClothSelfCollision(const Params& p = Params{}) : params_(p) {}
+
+    void          setParams(const Params& p) { params_ = p; }
+    const Params& params() const { return params_; }
+
+    // 预测位置之后调用一次
+    void detect(const ParticleData& data, const TriangleTopology& triangles);
+    // 约束迭代中调用
+    void project(ParticleData& data) const;
+
+    size_t vertexTriangleCount() const { return vt_.size(); }
+    size_t edgeEdgeCount() const { return ee_.size(); }
+
+private:
+    struct VertexTriangle
+    {
+        uint32_t vertex, triangle;
+        float    side; // 起点时顶点在三角形法线的哪一侧（±1）
+    };
+
+    struct EdgeEdge
+    {
+        uint32_t a, b;   // 边下标，a < b
+        vec3     normal; // 起点时从边 b 指向边 a 的分离方向
+    };
+
+    void rebuild(const TriangleTopology& triangles);
+    void refit(const ParticleData& data);
+
+    Params params_;
+
+    std::vector<uint32_t>                indices_;  // 建树时的三角形拓扑
+    std::uint64_t                        version_ = 0; // 建树时 TriangleTopology 的版本号，变了就重建
+    std::vector<std::array<uint32_t, 2>> edges_;    // 去重后的边
+    std::vector<uint32_t>                vertices_; // 出现在三角形里的顶点
+    std::vector<AABB>                    tri_boxes_, edge_boxes_;
+    BVH                                  tri_bvh_, edge_bvh_;
+
+    std::vector<VertexTriangle> vt_;
+    std::vector<EdgeEdge>       ee_;
+};
+}
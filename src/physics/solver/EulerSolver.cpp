@@ -10,7 +10,7 @@ void EulerSolver::solve(dk::ISimulationState& state, const float dt)
     const size_t count = data.size();
     for (size_t i = 0; i < count; ++i)
     {
-        if (data.is_fixed[i] || data.mass[i] == 0.0f) continue;
+        if (!data.isActive(i) || data.mass[i] == 0.0f) continue;
 
         data.acceleration[i] = data.force[i] / data.mass[i];
         data.velocity[i] += data.acceleration[i] * dt;
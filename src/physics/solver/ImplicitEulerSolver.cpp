@@ -0,0 +1,195 @@
+// solver/ImplicitEulerSolver.cpp
+#include "solver/ImplicitEulerSolver.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Parallel.h"
+#include "PhysicsStats.h"
+
+namespace dk {
+namespace {
+constexpr i64 kDotBlock = 4096;
+
+// 固定、休眠或没有质量的质点不参与求解
+bool pinned(const ParticleData& data, size_t i)
+{
+    return !data.isActive(i) || data.mass[i] == 0.0f;
+}
+
+template <class Fn>
+void forEachIndex(size_t n, Fn&& fn)
+{
+    parallelForSlabs(0, static_cast<i64>(n), [&](i64 b, i64 e)
+    {
+        for (i64 i = b; i < e; ++i) fn(static_cast<size_t>(i));
+    });
+}
+}
+
+void ImplicitEulerSolver::gather(std::vector<vec3>& out) const
+{
+    forEachIndex(out.size(), [&](size_t i)
+    {
+        vec3 sum(0.0f);
+        for (size_t k = adjacency_.offset[i]; k < adjacency_.offset[i + 1]; ++k)
+            sum += adjacency_.sign[k] * spring_out_[adjacency_.spring[k]];
+        out[i] = sum;
+    });
+}
+
+void ImplicitEulerSolver::springProduct(const Spring& springs, const std::vector<float>& alpha, const std::vector<float>& beta,
+                                        const std::vector<vec3>& x, std::vector<vec3>& out)
+{
+    forEachIndex(springs.size(), [&](size_t s)
+    {
+        const vec3  u   = x[springs.index_a[s]] - x[springs.index_b[s]];
+        const vec3& d   = dir_[s];
+        const vec3  par = d * glm::dot(d, u);
+        spring_out_[s]  = alpha[s] * par + beta[s] * (u - par);
+    });
+    gather(out);
+}
+
+void ImplicitEulerSolver::multiply(const ParticleData& data, const Spring& springs, const std::vector<vec3>& x,
+                                   std::vector<vec3>& out)
+{
+    springProduct(springs, alpha_, beta_, x, out);
+    forEachIndex(out.size(), [&](size_t i) { out[i] = pinned(data, i) ? vec3(0.0f) : out[i] + data.mass[i] * x[i]; });
+}
+
+double ImplicitEulerSolver::dot(const std::vector<vec3>& a, const std::vector<vec3>& b)
+{
+    const i64 n      = static_cast<i64>(a.size());
+    const i64 blocks = (n + kDotBlock - 1) / kDotBlock;
+    partial_.assign(blocks, 0.0);
+    parallelForSlabs(0, blocks, [&](i64 b0, i64 b1)
+    {
+        for (i64 blk = b0; blk < b1; ++blk)
+        {
+            double    sum = 0.0;
+            const i64 end = std::min(n, (blk + 1) * kDotBlock);
+            for (i64 i = blk * kDotBlock; i < end; ++i) sum += glm::dot(a[i], b[i]);
+            partial_[blk] = sum;
+        }
+    });
+    double total = 0.0;
+    for (double s : partial_) total += s;
+    return total;
+}
+
+void ImplicitEulerSolver::solve(ISimulationState& state, const float dt)
+{
+    auto&         particle_state = dynamic_cast<ParticleSystemState&>(state);
+    ParticleData& data           = particle_state.particles;
+    const Spring& springs        = particle_state.springs;
+    const size_t  n              = data.size();
+    const size_t  m              = springs.size();
+    const float   h              = dt;
+    const float   c              = params_.spring_damping;
+
+    if (!adjacency_.matches(springs, n)) adjacency_.build(springs, n);
+
+    dir_.resize(m);
+    alpha_.resize(m);
+    beta_.resize(m);
+    k_par_.resize(m);
+    k_perp_.resize(m);
+    spring_out_.resize(m);
+    for (auto* v : {&rhs_, &dv_, &r_, &z_, &p_, &ap_, &inv_diag_}) v->assign(n, vec3(0.0f));
+
+    // 1. 每根弹簧的方向、雅可比系数与弹簧力（弹性 + 沿弹簧的阻尼），力先放在 spring_out_
+    forEachIndex(m, [&](size_t s)
+    {
+        const size_t a = springs.index_a[s], b = springs.index_b[s];
+        const vec3   x = data.position[a] - data.position[b];
+        const float  l = glm::length(x);
+        if (l <= 0.0f)
+        {
+            dir_[s]        = vec3(0.0f);
+            spring_out_[s] = vec3(0.0f);
+            alpha_[s] = beta_[s] = k_par_[s] = k_perp_[s] = 0.0f;
+            return;
+        }
+        const vec3  d    = x / l;
+        const float k    = springs.stiffness[s];
+        const float perp = std::max(0.0f, 1.0f - springs.rest_length[s] / l); // 压缩时截断，保持正定
+        const float vrel = glm::dot(d, data.velocity[a] - data.velocity[b]);
+        dir_[s]          = d;
+        k_par_[s]        = k;
+        k_perp_[s]       = k * perp;
+        alpha_[s]        = h * h * k + h * c;
+        beta_[s]         = h * h * k * perp;
+        spring_out_[s]   = -(k * (l - springs.rest_length[s]) + c * vrel) * d;
+    });
+
+    // 2. 右端项 b = h·(f_ext + f_spring) + h²·K·v，K·v = -Σ±(k·d·dᵀ + k(1 - L/l)(I - d·dᵀ))(v_a - v_b)
+    gather(rhs_);
+    springProduct(springs, k_par_, k_perp_, data.velocity, ap_);
+    forEachIndex(n, [&](size_t i)
+    {
+        if (pinned(data, i))
+        {
+            rhs_[i] = vec3(0.0f);
+            return;
+        }
+        rhs_[i] = h * (data.force[i] + rhs_[i]) - h * h * ap_[i];
+    });
+
+    // 3. Jacobi 预条件：对角元 m + Σ(α·d_c² + β·(1 - d_c²))
+    forEachIndex(n, [&](size_t i)
+    {
+        if (pinned(data, i)) return;
+        vec3 diag(data.mass[i]);
+        for (size_t k = adjacency_.offset[i]; k < adjacency_.offset[i + 1]; ++k)
+        {
+            const size_t s  = adjacency_.spring[k];
+            const vec3   d2 = dir_[s] * dir_[s];
+            diag += alpha_[s] * d2 + beta_[s] * (vec3(1.0f) - d2);
+        }
+        inv_diag_[i] = vec3(1.0f) / diag;
+    });
+
+    // 4. 预条件共轭梯度，Δv 从 0 开始
+    r_ = rhs_;
+    forEachIndex(n, [&](size_t i) { p_[i] = z_[i] = inv_diag_[i] * r_[i]; });
+    double       rz    = dot(r_, z_);
+    const double bnorm = std::sqrt(dot(rhs_, rhs_));
+    double       rnorm = bnorm;
+    int          it    = 0;
+    while (it < params_.max_iterations && rnorm > params_.tolerance * bnorm)
+    {
+        multiply(data, springs, p_, ap_);
+        const double pap = dot(p_, ap_);
+        if (pap <= 0.0) break;
+        const float step = static_cast<float>(rz / pap);
+        forEachIndex(n, [&](size_t i)
+        {
+            dv_[i] += step * p_[i];
+            r_[i] -= step * ap_[i];
+            z_[i] = inv_diag_[i] * r_[i];
+        });
+        ++it;
+        rnorm = std::sqrt(dot(r_, r_));
+
+        const double rz_next = dot(r_, z_);
+        const float  beta    = static_cast<float>(rz_next / rz);
+        rz                   = rz_next;
+        forEachIndex(n, [&](size_t i) { p_[i] = z_[i] + beta * p_[i]; });
+    }
+    last_iterations_ = it;
+    last_residual_   = bnorm > 0.0 ? static_cast<float>(rnorm / bnorm) : 0.0f;
+    PhysicsStats::instance().addCount("pcg iterations", it);
+    PhysicsStats::instance().setValue("pcg residual", last_residual_);
+
+    // 5. 更新速度与位置
+    forEachIndex(n, [&](size_t i)
+    {
+        data.previous_position[i] = data.position[i];
+        if (pinned(data, i)) return;
+        data.velocity[i] += dv_[i];
+        data.acceleration[i] = dv_[i] / h;
+        data.position[i] += h * data.velocity[i];
+    });
+}
+}
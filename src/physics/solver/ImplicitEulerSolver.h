@@ -0,0 +1,66 @@
+// solver/ImplicitEulerSolver.h
+#pragma once
+#include <vector>
+
+#include "ISolver.h"
+#include "data/Particle.h"
+#include "solver/SpringAdjacency.h"
+
+namespace dk {
+/**
+ * 质点弹簧的隐式（向后）欧拉积分，线性化一次（Baraff-Witkin）:
+ *   (M - h·D - h²·K) Δv = h·(f + h·K·v)
+ * K、D 为弹簧力对位置、速度的雅可比；压缩弹簧的横向刚度截断为 0，保证系统矩阵对称正定。
+ * 用 Jacobi 预条件共轭梯度求解，不组装矩阵：每次矩阵向量乘按弹簧并行算出每根弹簧的贡献，
+ * 再按质点并行从邻接表（CSR）累加，没有写冲突，结果与线程数无关。
+ * 弹簧力由求解器自己根据拓扑计算，data.force 只应包含外力（重力、阻尼等），不要再加 SpringForce。
+ * 刚度很大的布料和绳子可以用比显式积分大一个数量级的步长。
+ */
+class ImplicitEulerSolver : public ISolver
+{
+public:
+    struct Params
+    {
+        int   max_iterations = 100;  // CG 最大迭代次数
+        float tolerance      = 1e-5f; // 相对残差 |r| / |b|
+        float spring_damping = 0.0f;  // 沿弹簧方向的阻尼系数
+    };
+
+    explicit ImplicitEulerSolver(const Params& p = Params{}) : params_(p) {}
+
+    void solve(ISimulationState& state, float dt) override;
+
+    void          setParams(const Params& p) { params_ = p; }
+    const Params& params() const { return params_; }
+
+    // 上一次求解的 CG 迭代次数与相对残差
+    int   lastIterations() const { return last_iterations_; }
+    float lastResidual() const { return last_residual_; }
+
+private:
+    // 每根弹簧的 q_s = (α·d·dᵀ + β·(I - d·dᵀ))·(x_a - x_b) 写进 spring_out_，再累加 out_i = Σ±q_s
+    void springProduct(const Spring& springs, const std::vector<float>& alpha, const std::vector<float>& beta,
+                       const std::vector<vec3>& x, std::vector<vec3>& out);
+    // out_i = Σ±spring_out_，a 端取正、b 端取负
+    void gather(std::vector<vec3>& out) const;
+    // out = A·x，固定点所在的行列为 0
+    void multiply(const ParticleData& data, const Spring& springs, const std::vector<vec3>& x, std::vector<vec3>& out);
+    // 按固定大小的块求部分和再串行相加，结果与线程数无关
+    double dot(const std::vector<vec3>& a, const std::vector<vec3>& b);
+
+    Params params_;
+    int    last_iterations_ = 0;
+    float  last_residual_   = 0.0f;
+
+    SpringAdjacency adjacency_; // 拓扑变了才重建
+
+    // 每根弹簧的方向与雅可比系数
+    std::vector<vec3>  dir_;
+    std::vector<float> alpha_, beta_;     // 系统矩阵里的 h²k + h·c 与 h²k(1 - L/l)
+    std::vector<float> k_par_, k_perp_;   // K 本身的系数，用于右端项 h²·K·v
+    std::vector<vec3>  spring_out_;       // 每根弹簧的乘积结果
+
+    std::vector<vec3>  rhs_, dv_, r_, z_, p_, ap_, inv_diag_;
+    std::vector<double> partial_; // dot 的块部分和
+};
+}
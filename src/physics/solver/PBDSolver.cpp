@@ -1,25 +1,87 @@
 #include "PBDSolver.h"
 
+#include <algorithm>
+
+#include "Parallel.h"
+#include "PhysicsStats.h"
+#include "solver/Chebyshev.h"
+
 namespace dk {
 void PBDSolver::solve(dk::ISimulationState& state, const float dt)
 {
     auto particle_state = dynamic_cast<ParticleSystemState*>(&state);
-    auto data = particle_state->particles;
-    auto springs = particle_state->springs;
+    auto& data = particle_state->particles;
+    auto& springs = particle_state->springs;
+    const bool cloth = particle_state->triangles && !particle_state->triangles->empty();
+    PhysicsStats& stats = PhysicsStats::instance();
+    using Timer         = PhysicsStats::StageTimer;
     // Step 1: 预测位置
-    predictPositions(data, springs, dt);
+    {
+        Timer timer("predict");
+        predictPositions(data, springs, dt);
+    }
 
-    m_grid.build(data); // 更新空间哈希网格
+    {
+        Timer timer("broad phase");
+        if (cloth)
+            m_selfCollision.detect(data, *particle_state->triangles); // previous_position -> position 的扫掠内找候选对
+        else
+        {
+            m_grid.build(data, false); // 更新空间哈希网格（只放醒着的粒子）
+            stats.addCount("grid rebuilds", 1);
+            // 休眠粒子不动，它们的网格只在休眠集合或质点本身（增删、压实）变化时重建
+            if (m_sleepVersion != data.sleep_version || m_sleepParticlesVersion != data.version)
+            {
+                m_sleepVersion          = data.sleep_version;
+                m_sleepParticlesVersion = data.version;
+                m_sleepingCount = static_cast<size_t>(std::count(data.is_sleeping.begin(), data.is_sleeping.end(), true));
+                m_sleepGrid.build(data, true);
+                stats.addCount("sleep grid rebuilds", 1);
+            }
+        }
+    }
+
+    const bool jacobi = m_params.mode == ConstraintMode::Jacobi;
+    // 需要估计谱半径时这一步不加速，记录每次迭代的更新量
+    const bool estimate = jacobi && m_params.chebyshev && spectralRadius() <= 0.0f;
+    ChebyshevSchedule cheb(jacobi && m_params.chebyshev ? spectralRadius() : 0.0f, m_params.chebyshev_delay);
+    if (jacobi)
+    {
+        if (!m_adjacency.matches(springs, data.size())) m_adjacency.build(springs, data.size());
+        m_springCorrection.resize(springs.size());
+        m_prevPosition = data.position;
+    }
+    double last_update = 0.0, update = 0.0;
 
     // Step 2: 约束求解循环
-    for (int i = 0; i < m_solverIterations; ++i)
     {
-        projectSpringConstraints(data, springs);
-        // 未来可以在这里调用 projectCollisionConstraints(data);
-        projectCollisionConstraints(data);
+        Timer timer("constraints");
+        for (int i = 0; i < m_solverIterations; ++i)
+        {
+            if (jacobi)
+            {
+                last_update = update;
+                update      = projectSpringConstraintsJacobi(data, springs, cheb.next(), estimate);
+            }
+            else
+            {
+                projectSpringConstraints(data, springs);
+            }
+            if (cloth)
+                m_selfCollision.project(data);
+            else
+                projectCollisionConstraints(data);
+        }
     }
+    stats.addCount("iterations", m_solverIterations);
+    if (jacobi) stats.setValue("jacobi update", update);
+
+    // 线性收敛时相邻两次更新量之比趋于谱半径
+    if (estimate && m_solverIterations >= 3 && last_update > 0.0)
+        m_estimatedRadius = std::clamp(static_cast<float>(std::sqrt(update / last_update)), 0.0f, 0.999f);
 
     // Step 3: 更新速度和最终位置
+    Timer timer("update");
     updateVelocitiesAndPositions(data, springs, dt);
 }
 
@@ -29,7 +91,7 @@ void PBDSolver::predictPositions(ParticleData& data, Spring& springs, const floa
 
     for (size_t i = 0; i < count; ++i)
     {
-        if (data.is_fixed[i]) continue;
+        if (!data.isActive(i)) continue;
         // 计算速度并施加外力，假设 force 已经被累加好了
         data.velocity[i] += data.force[i] * data.inv_mass[i] * dt;
 
@@ -45,6 +107,7 @@ void PBDSolver::projectSpringConstraints(ParticleData& data, Spring& springs)
     {
         size_t i1 = springs.index_a[i];
         size_t i2 = springs.index_b[i];
+        if (!data.isActive(i1) && !data.isActive(i2)) continue; // 整岛休眠
 
         vec3& p1 = data.position[i1];
         vec3& p2 = data.position[i2];
@@ -70,45 +133,104 @@ void PBDSolver::projectSpringConstraints(ParticleData& data, Spring& springs)
     }
 }
 
+double PBDSolver::projectSpringConstraintsJacobi(ParticleData& data, const Spring& springs, const float omega, const bool measure)
+{
+    auto weight = [&](size_t i) { return data.is_fixed[i] ? 0.0f : data.inv_mass[i]; };
+
+    // 所有弹簧读同一份位置，各自算出完整的投影修正
+    parallelForSlabs(0, static_cast<i64>(springs.size()), [&](i64 b, i64 e)
+    {
+        for (i64 s = b; s < e; ++s)
+        {
+            const size_t i1 = springs.index_a[s], i2 = springs.index_b[s];
+            const float  w  = data.isActive(i1) || data.isActive(i2) ? weight(i1) + weight(i2) : 0.0f;
+            const vec3   diff = data.position[i1] - data.position[i2];
+            const float  dist = length(diff);
+            m_springCorrection[s] = w == 0.0f || dist == 0.0f ? vec3(0.0f) : (diff / dist) * ((dist - springs.rest_length[s]) / w);
+        }
+    });
+
+    // 每个质点取相连弹簧修正的平均，再做 Chebyshev 外推：m_prevPosition 是上上次迭代，写回后变成上一次
+    const i64 n = static_cast<i64>(data.size());
+    parallelForSlabs(0, n, [&](i64 b, i64 e)
+    {
+        for (i64 i = b; i < e; ++i)
+        {
+            const size_t first = m_adjacency.offset[i], last = m_adjacency.offset[i + 1];
+            if (!data.isActive(i) || first == last) continue;
+            vec3 delta(0.0f);
+            for (size_t k = first; k < last; ++k) delta -= m_adjacency.sign[k] * m_springCorrection[m_adjacency.spring[k]];
+            const vec3 x_hat  = data.position[i] + (weight(i) / static_cast<float>(last - first)) * delta;
+            const vec3 x_next = ChebyshevSchedule::blend(omega, x_hat, m_prevPosition[i]);
+            m_prevPosition[i] = data.position[i];
+            data.position[i]  = x_next;
+        }
+    });
+
+    if (!measure) return 0.0;
+    double sum = 0.0;
+    for (i64 i = 0; i < n; ++i)
+    {
+        const vec3 d = data.position[i] - m_prevPosition[i];
+        sum += dot(d, d);
+    }
+    return sum;
+}
+
 void PBDSolver::projectCollisionConstraints(ParticleData& data)
 {
     constexpr float     thickness    = 0.1f; // 布料厚度
     const float         thickness_sq = thickness * thickness;
     std::vector<size_t> candidates;
 
-    for (size_t i = 0; i < data.size(); ++i)
+    auto project = [&](size_t i, size_t j_idx)
     {
-        // 1. 使用空间哈希获取候选粒子
-        m_grid.query(data, i, candidates);
+        // 两个都不动（固定或休眠）时不用管；休眠的一方被推动后，下一步整岛被唤醒
+        if (!data.isActive(i) && !data.isActive(j_idx)) return;
 
-        for (size_t j_idx : candidates)
-        {
-            // 2. 避免重复计算和自我检测
-            if (i >= j_idx) continue;
+        vec3& p1 = data.position[i];
+        vec3& p2 = data.position[j_idx];
 
-            // 3. 精确检测和投影
-            vec3& p1 = data.position[i];
-            vec3& p2 = data.position[j_idx];
+        vec3  diff    = p1 - p2;
+        float dist_sq = dot(diff, diff);
 
-            vec3  diff    = p1 - p2;
-            float dist_sq = dot(diff, diff);
+        if (dist_sq < thickness_sq)
+        {
+            // 发生碰撞，进行投影
+            float dist       = std::sqrt(dist_sq);
+            vec3  correction = (diff / dist) * (thickness - dist);
 
-            if (dist_sq < thickness_sq)
-            {
-                // 发生碰撞，进行投影
-                float dist       = std::sqrt(dist_sq);
-                vec3  correction = (diff / dist) * (thickness - dist);
+            float w1 = data.is_fixed[i] ? 0.0f : data.inv_mass[i];
+            float w2 = data.is_fixed[j_idx] ? 0.0f : data.inv_mass[j_idx];
+            if (w1 + w2 == 0.0f) return;
 
-                float w1 = data.is_fixed[i] ? 0.0f : data.inv_mass[i];
-                float w2 = data.is_fixed[j_idx] ? 0.0f : data.inv_mass[j_idx];
-                if (w1 + w2 == 0.0f) continue;
+            // 与弹簧约束完全相同的投影逻辑！
+            p1 += (w1 / (w1 + w2)) * correction;
+            p2 -= (w2 / (w1 + w2)) * correction;
+        }
+    };
 
-                // 与弹簧约束完全相同的投影逻辑！
-                p1 += (w1 / (w1 + w2)) * correction;
-                p2 -= (w2 / (w1 + w2)) * correction;
-            }
+    size_t neighbors = 0;
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        if (data.is_sleeping[i] || data.is_dead[i]) continue;
+
+        // 1. 使用空间哈希获取候选粒子：醒着的粒子之间每对只算一次
+        m_grid.query(data.position[i], candidates);
+        neighbors += candidates.size();
+        for (size_t j_idx : candidates)
+        {
+            // 2. 避免重复计算和自我检测
+            if (i < j_idx) project(i, j_idx);
         }
+
+        // 3. 与休眠粒子的接触
+        if (m_sleepingCount == 0) continue;
+        m_sleepGrid.query(data.position[i], candidates);
+        neighbors += candidates.size();
+        for (size_t j_idx : candidates) project(i, j_idx);
     }
+    PhysicsStats::instance().addCount("neighbor candidates", static_cast<double>(neighbors));
 }
 
 void PBDSolver::updateVelocitiesAndPositions(ParticleData& data, Spring& springs, float dt)
@@ -116,7 +238,8 @@ void PBDSolver::updateVelocitiesAndPositions(ParticleData& data, Spring& springs
     const size_t count = data.size();
     for (size_t i = 0; i < count; ++i)
     {
-        if (data.is_fixed[i]) continue;
+        // 休眠粒子被接触推动时 position 与 previous_position 不再相等，留给 SleepIslands 唤醒
+        if (!data.isActive(i)) continue;
 
         // 用投影后的最终位置 p_i 和之前帧的位置 p_prev_i 来计算最终速度
         data.velocity[i] = (data.position[i] - data.previous_position[i]) / dt;
@@ -3,24 +3,52 @@
 #include "ISolver.h"
 #include "data/Particle.h" // PBD求解器需要知道弹簧的连接关系
 #include "data/SpatialGrid.h"
+#include "solver/ClothSelfCollision.h"
+#include "solver/SpringAdjacency.h"
 
 namespace dk {
 class PBDSolver : public ISolver
 {
 public:
+    enum class ConstraintMode
+    {
+        GaussSeidel, // 逐根弹簧顺序投影，立即生效（默认）
+        Jacobi       // 所有弹簧按同一份位置并行投影，每个质点取相连约束修正的平均
+    };
+
+    struct Params
+    {
+        ConstraintMode mode = ConstraintMode::GaussSeidel;
+        // Jacobi 模式下用 Chebyshev 外推加速弹簧投影
+        bool  chebyshev       = false;
+        float spectral_radius = 0.0f; // 迭代的谱半径；<= 0 时由第一次求解的未加速迭代估计
+        int   chebyshev_delay = 2;    // 前几次迭代不外推
+    };
+
     PBDSolver(int solver_iterations = 5, float cell_size = 0.1f)
-        : m_solverIterations(solver_iterations), m_grid(cell_size)
+        : m_solverIterations(solver_iterations), m_grid(cell_size), m_sleepGrid(cell_size)
     {
         
     }
 
     void solve(dk::ISimulationState& state, const float dt) override;
 
+    void          setParams(const Params& p) { m_params = p; m_estimatedRadius = 0.0f; }
+    const Params& params() const { return m_params; }
+    // Chebyshev 实际使用的谱半径（给定的或估计出的），还没有时为 0
+    float spectralRadius() const { return m_params.spectral_radius > 0.0f ? m_params.spectral_radius : m_estimatedRadius; }
+
+    // 状态带三角形拓扑时用三角形级自碰撞代替粒子间的点-点碰撞
+    void setSelfCollisionParams(const ClothSelfCollision::Params& p) { m_selfCollision.setParams(p); }
+    const ClothSelfCollision& selfCollision() const { return m_selfCollision; }
+
 private:
     void predictPositions(ParticleData& data, dk::Spring& springs, float dt);
 
 
     void projectSpringConstraints(ParticleData& data, dk::Spring& springs);
+    // Jacobi 模式的一次迭代；返回本次位置更新量的平方和（仅在 measure 时计算）
+    double projectSpringConstraintsJacobi(ParticleData& data, const dk::Spring& springs, float omega, bool measure);
 
     void projectCollisionConstraints(ParticleData& data);
 
@@ -29,5 +57,15 @@ private:
 
     int           m_solverIterations;
     SpatialGrid m_grid;
+    SpatialGrid       m_sleepGrid;         // 休眠粒子
+    std::uint64_t     m_sleepVersion = 0, m_sleepParticlesVersion = 0; // m_sleepGrid 建立时的 sleep_version 与 version
+    size_t            m_sleepingCount = 0;
+    ClothSelfCollision m_selfCollision;
+
+    Params            m_params;
+    float             m_estimatedRadius = 0.0f;
+    SpringAdjacency   m_adjacency;
+    std::vector<vec3> m_springCorrection; // Jacobi：每根弹簧的修正 / (w_a + w_b)
+    std::vector<vec3> m_prevPosition;     // Chebyshev：上上次迭代的位置
 };
 }
@@ -0,0 +1,154 @@
+// solver/ProjectiveDynamicsSolver.cpp
+#include "solver/ProjectiveDynamicsSolver.h"
+
+#include <stdexcept>
+
+#include "Parallel.h"
+#include "PhysicsStats.h"
+
+namespace dk {
+namespace {
+// 固定、死槽位或没有质量的质点不是未知量；它们只随 ParticleData::version 变化，决定矩阵的结构
+bool pinned(const ParticleData& data, size_t i)
+{
+    return data.is_fixed[i] || data.is_dead[i] || data.mass[i] == 0.0f;
+}
+
+// 位置不动的质点：pinned 之外还有休眠的。休眠按整个弹簧连通块进行（见 SleepIslands），
+// 休眠块与醒着的未知量之间没有矩阵元，所以它们留在矩阵里照常求解、结果不写回即可，休眠集合变化不用重新分解
+bool frozen(const ParticleData& data, size_t i)
+{
+    return pinned(data, i) || data.is_sleeping[i];
+}
+
+template <class Fn>
+void forEachIndex(size_t n, Fn&& fn)
+{
+    parallelForSlabs(0, static_cast<i64>(n), [&](i64 b, i64 e)
+    {
+        for (i64 i = b; i < e; ++i) fn(static_cast<size_t>(i));
+    });
+}
+}
+
+bool ProjectiveDynamicsSolver::needsFactorization(const ParticleData& data, const Spring& springs, const float dt) const
+{
+    return !factored_ || dt != dt_ || !adjacency_.matches(springs, data.size()) || particles_version_ != data.version
+           || springs_version_ != springs.version;
+}
+
+void ProjectiveDynamicsSolver::factorize(const ParticleData& data, const Spring& springs, const float dt)
+{
+    const size_t n = data.size();
+    adjacency_.build(springs, n);
+    particles_version_ = data.version;
+    springs_version_   = springs.version;
+    dt_                = dt;
+
+    unknown_.assign(n, -1);
+    int count = 0;
+    for (size_t i = 0; i < n; ++i)
+        if (!pinned(data, i)) unknown_[i] = count++;
+
+    // M/h² + Σ k·AᵀA，只保留未知量之间的项
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(count + 4 * springs.size());
+    const double inv_h2 = 1.0 / (static_cast<double>(dt) * dt);
+    for (size_t i = 0; i < n; ++i)
+        if (unknown_[i] >= 0) triplets.emplace_back(unknown_[i], unknown_[i], data.mass[i] * inv_h2);
+    for (size_t s = 0; s < springs.size(); ++s)
+    {
+        const int    a = unknown_[springs.index_a[s]], b = unknown_[springs.index_b[s]];
+        const double k = springs.stiffness[s];
+        if (a >= 0) triplets.emplace_back(a, a, k);
+        if (b >= 0) triplets.emplace_back(b, b, k);
+        if (a >= 0 && b >= 0)
+        {
+            triplets.emplace_back(a, b, -k);
+            triplets.emplace_back(b, a, -k);
+        }
+    }
+
+    Eigen::SparseMatrix<double> A(count, count);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    llt_.compute(A);
+    if (llt_.info() != Eigen::Success) throw std::runtime_error("ProjectiveDynamicsSolver: Cholesky factorization failed");
+    factored_ = true;
+    ++factorizations_;
+
+    rhs_.resize(count, 3);
+    x_.resize(count, 3);
+}
+
+void ProjectiveDynamicsSolver::solve(ISimulationState& state, const float dt)
+{
+    auto&         particle_state = dynamic_cast<ParticleSystemState&>(state);
+    ParticleData& data           = particle_state.particles;
+    const Spring& springs        = particle_state.springs;
+    const size_t  n              = data.size();
+    const float   h              = dt;
+
+    if (needsFactorization(data, springs, dt))
+    {
+        PhysicsStats::StageTimer timer("factorization");
+        factorize(data, springs, dt);
+        PhysicsStats::instance().addCount("factorizations", 1);
+    }
+
+    // 惯性目标 y = x + h·v + h²·f/m，同时作为第一次迭代的初值
+    y_.resize(n);
+    d_.resize(springs.size());
+    forEachIndex(n, [&](size_t i)
+    {
+        data.previous_position[i] = data.position[i];
+        y_[i] = frozen(data, i) ? data.position[i] : data.position[i] + h * data.velocity[i] + (h * h * data.inv_mass[i]) * data.force[i];
+        if (!frozen(data, i)) data.position[i] = y_[i];
+    });
+
+    const float inv_h2 = 1.0f / (h * h);
+    PhysicsStats::instance().addCount("pd iterations", params_.iterations);
+    for (int it = 0; it < params_.iterations; ++it)
+    {
+        // 局部步：每根弹簧投影到自然长度
+        forEachIndex(springs.size(), [&](size_t s)
+        {
+            const vec3  x = data.position[springs.index_a[s]] - data.position[springs.index_b[s]];
+            const float l = glm::length(x);
+            d_[s]         = l > 0.0f ? x * (springs.rest_length[s] / l) : vec3(0.0f);
+        });
+
+        // 全局步：右端项 M·y/h² + Σ±k·d_s，固定端的位置移到右端
+        forEachIndex(n, [&](size_t i)
+        {
+            const int row = unknown_[i];
+            if (row < 0) return;
+            vec3 b = (data.mass[i] * inv_h2) * y_[i];
+            for (size_t k = adjacency_.offset[i]; k < adjacency_.offset[i + 1]; ++k)
+            {
+                const size_t s     = adjacency_.spring[k];
+                const float  sign  = adjacency_.sign[k];
+                const size_t other = sign > 0.0f ? springs.index_b[s] : springs.index_a[s];
+                b += (sign * springs.stiffness[s]) * d_[s];
+                if (unknown_[other] < 0) b += springs.stiffness[s] * data.position[other];
+            }
+            rhs_.row(row) = Eigen::RowVector3d(b.x, b.y, b.z);
+        });
+        x_ = llt_.solve(rhs_);
+
+        forEachIndex(n, [&](size_t i)
+        {
+            const int row = unknown_[i];
+            if (row >= 0 && !data.is_sleeping[i])
+                data.position[i] = vec3(static_cast<float>(x_(row, 0)), static_cast<float>(x_(row, 1)), static_cast<float>(x_(row, 2)));
+        });
+    }
+
+    forEachIndex(n, [&](size_t i)
+    {
+        if (frozen(data, i)) return;
+        const vec3 v         = (data.position[i] - data.previous_position[i]) / h;
+        data.acceleration[i] = (v - data.velocity[i]) / h;
+        data.velocity[i]     = v;
+    });
+}
+}
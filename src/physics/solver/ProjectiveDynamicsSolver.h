@@ -0,0 +1,62 @@
+// solver/ProjectiveDynamicsSolver.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include "ISolver.h"
+#include "data/Particle.h"
+#include "solver/SpringAdjacency.h"
+
+namespace dk {
+/**
+ * 质点弹簧的 Projective Dynamics 求解器（Liu et al. 2013 的局部/全局交替）.
+ * 隐式欧拉的增量势能 |x - y|²_M / 2h² + Σ k/2 |x_a - x_b - d_s|² 对 x 是二次的，
+ * 系统矩阵 M/h² + Σ k·AᵀA 与位置无关，只在弹簧或质点的版本号（拓扑、刚度、质量、固定点、死槽位）
+ * 或步长变化时用 Eigen 的稀疏 Cholesky 分解一次；三个坐标共用同一个矩阵。
+ * - 局部步：按弹簧并行把 x_a - x_b 投影到自然长度，得到 d_s
+ * - 全局步：按质点并行汇总右端项，一次前代回代得到新位置
+ * 固定点不进入未知量，它们对弹簧的贡献移到右端项；休眠的质点仍是未知量，只是求解结果不写回。弹簧力由求解器自己处理，data.force 只放外力。
+ */
+class ProjectiveDynamicsSolver : public ISolver
+{
+public:
+    struct Params
+    {
+        int iterations = 10; // 每步的局部/全局交替次数
+    };
+
+    explicit ProjectiveDynamicsSolver(const Params& p = Params{}) : params_(p) {}
+
+    void solve(ISimulationState& state, float dt) override;
+
+    void          setParams(const Params& p) { params_ = p; }
+    const Params& params() const { return params_; }
+
+    // 累计分解次数，用来确认没有重复分解
+    int factorizations() const { return factorizations_; }
+
+private:
+    // 系统矩阵的输入有变化时重新组装并分解
+    bool needsFactorization(const ParticleData& data, const Spring& springs, float dt) const;
+    void factorize(const ParticleData& data, const Spring& springs, float dt);
+
+    Params params_;
+    int    factorizations_ = 0;
+
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> llt_;
+    bool                                              factored_ = false;
+
+    // 分解时的输入
+    std::uint64_t particles_version_ = 0, springs_version_ = 0;
+    float         dt_                = 0.0f;
+
+    SpringAdjacency  adjacency_;
+    std::vector<int> unknown_; // 质点 -> 未知量下标，固定点为 -1
+
+    std::vector<vec3> y_, d_;
+    Eigen::MatrixX3d  rhs_, x_;
+};
+}
@@ -0,0 +1,55 @@
+// solver/SpringAdjacency.h
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "data/Particle.h"
+
+namespace dk {
+/**
+ * 质点 -> 相连弹簧的 CSR 邻接表.
+ * 逐弹簧并行算出的量按质点并行汇总时用它代替散射写，没有写冲突，累加顺序也固定。
+ * sign 为 +1 表示质点是弹簧的 a 端，-1 为 b 端。
+ */
+struct SpringAdjacency
+{
+    std::vector<size_t> offset; // 质点 i 的弹簧在 [offset[i], offset[i + 1])
+    std::vector<size_t> spring;
+    std::vector<float>  sign;
+
+    // 弹簧的版本号和质点数都没变时不需要重建
+    bool matches(const Spring& springs, size_t particle_count) const
+    {
+        return offset.size() == particle_count + 1 && version_ == springs.version;
+    }
+
+    void build(const Spring& springs, size_t particle_count)
+    {
+        version_ = springs.version;
+
+        offset.assign(particle_count + 1, 0);
+        for (size_t s = 0; s < springs.size(); ++s)
+        {
+            ++offset[springs.index_a[s] + 1];
+            ++offset[springs.index_b[s] + 1];
+        }
+        for (size_t i = 0; i < particle_count; ++i) offset[i + 1] += offset[i];
+
+        spring.resize(offset.back());
+        sign.resize(offset.back());
+        std::vector<size_t> cursor(offset.begin(), offset.end() - 1);
+        for (size_t s = 0; s < springs.size(); ++s)
+        {
+            const size_t a = cursor[springs.index_a[s]]++;
+            spring[a]      = s;
+            sign[a]        = 1.0f;
+            const size_t b = cursor[springs.index_b[s]]++;
+            spring[b]      = s;
+            sign[b]        = -1.0f;
+        }
+    }
+
+private:
+    std::uint64_t version_ = 0;
+};
+}
@@ -1,7 +1,15 @@
 // solver/StableFluidSolver.cpp
 #include "solver/StableFliuidsSolver.h"
+#include "Parallel.h"
+#include "PhysicsStats.h"
+#include "distributed/HaloExchange.h"
+#include "solver/Chebyshev.h"
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string>
 using namespace dk;
 
 void StableFluidSolver::solve(ISimulationState& state, const float dt)
@@ -9,225 +17,809 @@ void StableFluidSolver::solve(ISimulationState& state, const float dt)
     auto* grid = dynamic_cast<MacGrid*>(&state);
     if (!grid) return;
 
-    addForces(*grid, dt);
-    diffuse(*grid, dt);
-    advect(*grid, dt);
-    project(*grid);
-    applyBoundary(*grid);
+    // nz == 1 走 2D 特化：双线性采样 + 5 点模板，不再读写 z 邻居和 W 分量
+    if (grid->nz() == 1)
+    {
+        solveDim<2>(*grid, dt);
+    }
+    else
+    {
+        solveDim<3>(*grid, dt);
+    }
+}
+
+template <int Dim>
+void StableFluidSolver::solveDim(MacGrid& g, const float dt)
+{
+    using Timer = PhysicsStats::StageTimer;
+    {
+        Timer timer("active tiles");
+        updateActiveTiles<Dim>(g, dt);
+    }
+    {
+        Timer timer("forces");
+        addForces<Dim>(g, dt);
+    }
+    {
+        Timer timer("diffusion");
+        diffuse<Dim>(g, dt);
+    }
+    if (halo_) checkHaloCfl(g, dt);
+    {
+        Timer timer("advection");
+        advect<Dim>(g, dt);
+    }
+    {
+        Timer timer("projection");
+        project<Dim>(g);
+    }
+    {
+        Timer timer("boundary");
+        applyBoundary(g);
+    }
+}
+
+void StableFluidSolver::checkHaloCfl(const MacGrid& g, const float dt)
+{
+    // 幽灵层只在切分轴上，回溯点在该轴上的位移由该轴的面速度分量的最大值界定；
+    // 切分轴最慢，每个平面在内存里连续
+    const SlabDecomposition& d     = halo_->decomposition();
+    const int                axis  = d.axis();
+    const MacGrid::FieldKind kind  = axis == 2 ? MacGrid::FieldKind::W : MacGrid::FieldKind::V;
+    const Field&             vel   = axis == 2 ? g.w() : g.v();
+    const glm::ivec3         dims  = g.fieldDims(kind);
+    const size_t             plane = g.fieldSize(kind) / static_cast<size_t>(dims[axis]);
+    plane_max_.assign(dims[axis], 0.0f);
+    parallelForSlabs(0, dims[axis], [&](i64 p0, i64 p1)
+    {
+        for (i64 p = p0; p < p1; ++p)
+        {
+            float m = 0.0f;
+            for (size_t n = p * plane; n < (p + 1) * plane; ++n) m = std::max(m, std::fabs(vel[n]));
+            plane_max_[p] = m;
+        }
+    });
+    const float vmax  = *std::max_element(plane_max_.begin(), plane_max_.end());
+    const float cells = vmax * dt / g.h();
+    if (cells > static_cast<float>(d.halo - 2))
+    {
+        throw std::runtime_error("StableFluidSolver: backtrace of " + std::to_string(cells) + " cells on rank "
+                                 + std::to_string(halo_->rank()) + " exceeds halo - 2 = " + std::to_string(d.halo - 2)
+                                 + "; increase SlabDecomposition::halo or reduce dt");
+    }
+}
+
+void StableFluidSolver::exchangeHalo(const MacGrid& g, const std::vector<HaloField>& fields)
+{
+    if (halo_) halo_->exchange(g, fields);
+}
+
+template <int Dim>
+void StableFluidSolver::exchangeVelocity(MacGrid& g)
+{
+    if (!halo_) return;
+    if constexpr (Dim == 3)
+    {
+        halo_->exchange(g, {{&g.u(), MacGrid::FieldKind::U}, {&g.v(), MacGrid::FieldKind::V}, {&g.w(), MacGrid::FieldKind::W}});
+    }
+    else
+    {
+        halo_->exchange(g, {{&g.u(), MacGrid::FieldKind::U}, {&g.v(), MacGrid::FieldKind::V}});
+    }
+}
+
+namespace {
+constexpr int kTile = StableFluidSolver::kTileSize;
+
+glm::ivec3 tileCoord(int t, const glm::ivec3& tile_dims)
+{
+    return {t % tile_dims.x, (t / tile_dims.x) % tile_dims.y, t / (tile_dims.x * tile_dims.y)};
+}
+
+// tile tc 在 kind 布局下拥有的下标区间 [lo, hi)：交错轴上多出的最后一层面归最后一个 tile
+void tileRange(const MacGrid& g, MacGrid::FieldKind kind, const glm::ivec3& tile_dims, const glm::ivec3& tc,
+               glm::ivec3& lo, glm::ivec3& hi)
+{
+    const glm::ivec3 d = g.fieldDims(kind);
+    for (int a = 0; a < 3; ++a)
+    {
+        lo[a] = tc[a] * kTile;
+        hi[a] = tc[a] + 1 == tile_dims[a] ? d[a] : std::min((tc[a] + 1) * kTile, d[a]);
+    }
+}
+
+// 可分离的盒形膨胀（半径 radius 个 tile）：非零值向邻居扩散为 1，原有的非零值保留
+void dilateTiles(std::vector<std::uint8_t>& mask, std::vector<std::uint8_t>& tmp, const glm::ivec3& dims,
+                 int axes, int radius)
+{
+    const int stride[3] = {1, dims.x, dims.x * dims.y};
+    for (int a = 0; a < axes; ++a)
+    {
+        tmp = mask;
+        for (int t = 0; t < static_cast<int>(mask.size()); ++t)
+        {
+            if (mask[t]) continue;
+            const int c  = tileCoord(t, dims)[a];
+            const int c0 = std::max(0, c - radius), c1 = std::min(dims[a] - 1, c + radius);
+            for (int q = c0; q <= c1 && !mask[t]; ++q)
+            {
+                if (tmp[t + (q - c) * stride[a]]) mask[t] = 1;
+            }
+        }
+    }
+}
 }
 
+template <int Dim>
+void StableFluidSolver::updateActiveTiles(const MacGrid& g, float dt)
+{
+    tile_dims_ = glm::ivec3((g.nx() + kTile - 1) / kTile, (g.ny() + kTile - 1) / kTile,
+                            Dim == 3 ? (g.nz() + kTile - 1) / kTile : 1);
+    const int total    = tile_dims_.x * tile_dims_.y * tile_dims_.z;
+    stats_.total_tiles = total;
+
+    // 分块时各 rank 的活跃区不一致会让 halo 交换错位，整块计算
+    tracking_                = false;
+    stats_.tracking_fallback = params_.track_active_tiles && halo_;
+    if (stats_.tracking_fallback && !fallback_warned_)
+    {
+        fmt::print(stderr, "Warning: active-tile tracking is disabled under domain decomposition; solving the full slab.\n");
+        fallback_warned_ = true;
+    }
+    if (!params_.track_active_tiles || halo_)
+    {
+        stats_.active_tiles    = total;
+        stats_.active_fraction = 1.0f;
+        return;
+    }
+
+    // 种子：扫一遍每个 tile 拥有的面和 cell，记下最大速度分量
+    tile_mask_.assign(total, 0);
+    tile_speed_.assign(total, 0.0f);
+    parallelForSlabs(0, total, [&](i64 b, i64 e)
+    {
+        for (i64 t = b; t < e; ++t)
+        {
+            const glm::ivec3 tc     = tileCoord(static_cast<int>(t), tile_dims_);
+            float            speed  = 0.0f;
+            bool             scalar = false;
+            auto scan = [&](MacGrid::FieldKind kind, const Field& f, bool velocity)
+            {
+                glm::ivec3 lo, hi;
+                tileRange(g, kind, tile_dims_, tc, lo, hi);
+                for (int k = lo.z; k < hi.z; ++k)
+                    for (int j = lo.y; j < hi.y; ++j)
+                        for (int i = lo.x; i < hi.x; ++i)
+                        {
+                            const float a = std::abs(f[g.fieldIdx(kind, i, j, k)]);
+                            if (velocity) speed = std::max(speed, a);
+                            else scalar = scalar || a > params_.active_scalar_eps;
+                        }
+            };
+            scan(MacGrid::FieldKind::U, g.u(), true);
+            scan(MacGrid::FieldKind::V, g.v(), true);
+            if constexpr (Dim == 3) scan(MacGrid::FieldKind::W, g.w(), true);
+            if (params_.advect_dye) scan(MacGrid::FieldKind::Center, g.dye(), false);
+            for (int c = 0; c < g.scalarChannelCount(); ++c) scan(MacGrid::FieldKind::Center, g.scalar(c), false);
+
+            tile_speed_[t] = speed;
+            tile_mask_[t]  = scalar || speed > params_.active_velocity_eps ? 3 : 0;
+        }
+    });
+
+    // 膨胀半径：本步最远回溯距离（含重力加速）再加插值模板的两层 cell
+    const float max_speed = *std::max_element(tile_speed_.begin(), tile_speed_.end()) * std::sqrt(float(Dim));
+    const float reach     = (max_speed + glm::length(params_.gravity) * dt) * dt / g.h() + 2.0f;
+    const int   radius    = std::max(1, static_cast<int>(std::ceil(reach / kTile)));
+    dilateTiles(tile_mask_, tile_tmp_, tile_dims_, Dim, radius);
+
+    // 3 = 种子，2 = 膨胀出来的活跃 tile，1 = 外围
+    active_tiles_.clear();
+    seed_tiles_.clear();
+    for (int t = 0; t < total; ++t)
+    {
+        if (tile_mask_[t] == 3) seed_tiles_.push_back(t);
+        if (tile_mask_[t])
+        {
+            active_tiles_.push_back(t);
+            tile_mask_[t] = std::max<std::uint8_t>(tile_mask_[t], 2);
+        }
+    }
+    stats_.active_tiles    = static_cast<i64>(active_tiles_.size());
+    stats_.active_fraction = static_cast<float>(active_tiles_.size()) / static_cast<float>(total);
+    // 全部活跃时走整场路径（与未开启跟踪逐位一致）
+    if (static_cast<int>(active_tiles_.size()) == total) return;
+    tracking_ = true;
+
+    // 外围一圈：活跃区的回溯与模板可能读到的范围，其中的临时缓存要填成静止值
+    dilateTiles(tile_mask_, tile_tmp_, tile_dims_, Dim, radius);
+    shell_tiles_.clear();
+    for (int t = 0; t < total; ++t)
+    {
+        if (tile_mask_[t] == 1) shell_tiles_.push_back(t);
+    }
+}
+
+template <int Dim, class Fn>
+void StableFluidSolver::forTiles(const MacGrid&          g,
+                                 const std::vector<int>& tiles,
+                                 MacGrid::FieldKind      kind,
+                                 const glm::ivec3&       lo,
+                                 const glm::ivec3&       hi,
+                                 Fn&&                    fn) const
+{
+    // tile 列表按内存顺序排列，静态分段后每个线程拿到的大致就是自己首次触碰的那些 slab
+    parallelForSlabs(0, static_cast<i64>(tiles.size()), [&](i64 b, i64 e)
+    {
+        for (i64 n = b; n < e; ++n)
+        {
+            glm::ivec3 tlo, thi;
+            tileRange(g, kind, tile_dims_, tileCoord(tiles[n], tile_dims_), tlo, thi);
+            tlo = glm::max(tlo, lo);
+            thi = glm::min(thi, hi);
+            for (int k = tlo.z; k < thi.z; ++k)
+                for (int j = tlo.y; j < thi.y; ++j)
+                    for (int i = tlo.x; i < thi.x; ++i) fn(i, j, k);
+        }
+    });
+}
+
+template <int Dim, class Fn>
+void StableFluidSolver::forCells(const MacGrid&     g,
+                                 MacGrid::FieldKind kind,
+                                 const glm::ivec3&  lo,
+                                 const glm::ivec3&  hi,
+                                 Fn&&               fn) const
+{
+    if (tracking_)
+    {
+        forTiles<Dim>(g, active_tiles_, kind, lo, hi, fn);
+    }
+    else
+    {
+        parallelForGrid<Dim>(lo, hi, fn);
+    }
+}
+
+template <int Dim, class Fn>
+void StableFluidSolver::forElements(const MacGrid& g, MacGrid::FieldKind kind, Fn&& fn) const
+{
+    if (tracking_)
+    {
+        forTiles<Dim>(g, active_tiles_, kind, glm::ivec3(0), g.fieldDims(kind),
+                      [&](int i, int j, int k) { fn(g.fieldIdx(kind, i, j, k)); });
+    }
+    else
+    {
+        parallelForSlabs(0, static_cast<i64>(g.fieldSize(kind)), [&](i64 b, i64 e)
+        {
+            for (i64 n = b; n < e; ++n) fn(static_cast<size_t>(n));
+        });
+    }
+}
+
+template <int Dim>
+void StableFluidSolver::fillShell(const MacGrid& g, MacGrid::FieldKind kind, Field& scratch, const Field& src) const
+{
+    if (!tracking_) return;
+    if (scratch.size() != g.fieldSize(kind)) g.initField(scratch, kind);
+    forTiles<Dim>(g, shell_tiles_, kind, glm::ivec3(0), g.fieldDims(kind), [&](int i, int j, int k)
+    {
+        const size_t n = g.fieldIdx(kind, i, j, k);
+        scratch[n]     = src[n];
+    });
+}
+
+template <int Dim>
+void StableFluidSolver::commit(const MacGrid& g, MacGrid::FieldKind kind, Field& field, Field& result) const
+{
+    if (!tracking_)
+    {
+        field.swap(result);
+        return;
+    }
+    forTiles<Dim>(g, active_tiles_, kind, glm::ivec3(0), g.fieldDims(kind), [&](int i, int j, int k)
+    {
+        const size_t n = g.fieldIdx(kind, i, j, k);
+        field[n]       = result[n];
+    });
+}
+
+template <int Dim>
 void StableFluidSolver::addForces(MacGrid& g, float dt)
 {
     // 重力只作用在 V 分量（y）上
-    if (params_.gravity.y != 0.0f)
+    if (params_.gravity.y == 0.0f) return;
+    auto gravity = [&](int i, int j, int k) { g.V(i, j, k) += params_.gravity.y * dt; };
+    if (tracking_)
     {
-        for (int k = 0; k < g.nz(); ++k)
-            for (int j = 0; j < g.ny() + 1; ++j)
-                for (int i = 0; i < g.nx(); ++i)
-                {
-                    g.V(i, j, k) += params_.gravity.y * dt;
-                }
+        // 静止空气里的均匀重力视为由静水压平衡，只在种子 tile（有流动或染料处）加重力，
+        // 否则膨胀出来的那圈空气会被重力带动，活跃区每步外扩。与整场模式不同，见 Params 的说明
+        forTiles<Dim>(g, seed_tiles_, MacGrid::FieldKind::V, glm::ivec3(0), g.fieldDims(MacGrid::FieldKind::V), gravity);
+    }
+    else
+    {
+        parallelForGrid<Dim>(g.fieldDims(MacGrid::FieldKind::V), gravity);
     }
     // 你可以在此添加外力场/鼠标吸力/湍流等
 }
 
+template <int Dim>
 void StableFluidSolver::diffuse(MacGrid& g, float dt)
 {
     if (params_.viscosity <= 0.0f) return;
 
-    const float a = params_.viscosity * dt / (g.h() * g.h());
+    const float a     = params_.viscosity * dt / (g.h() * g.h());
+    const float rbeta = 1.0f / (1.0f + 2.0f * Dim * a); // 3D 6 邻居 / 2D 4 邻居
+    exchangeVelocity<Dim>(g);
     // u: (nx+1, ny, nz)
-    jacobiDiffuseComponent(g.u_tmp(), g.u(), g.nx() + 1, g.ny(), g.nz(), a, 1.0f / (1.0f + 6.0f * a),
-                           params_.jacobi_iters);
-    g.u().swap(g.u_tmp());
+    jacobiDiffuseComponent<Dim>(g, MacGrid::FieldKind::U, g.u_tmp(), g.u(), a, rbeta, params_.jacobi_iters);
+    commit<Dim>(g, MacGrid::FieldKind::U, g.u(), g.u_tmp());
     // v: (nx, ny+1, nz)
-    jacobiDiffuseComponent(g.v_tmp(), g.v(), g.nx(), g.ny() + 1, g.nz(), a, 1.0f / (1.0f + 6.0f * a),
-                           params_.jacobi_iters);
-    g.v().swap(g.v_tmp());
-    // w: (nx, ny, nz+1)
-    jacobiDiffuseComponent(g.w_tmp(), g.w(), g.nx(), g.ny(), g.nz() + 1, a, 1.0f / (1.0f + 6.0f * a),
-                           params_.jacobi_iters);
-    g.w().swap(g.w_tmp());
+    jacobiDiffuseComponent<Dim>(g, MacGrid::FieldKind::V, g.v_tmp(), g.v(), a, rbeta, params_.jacobi_iters);
+    commit<Dim>(g, MacGrid::FieldKind::V, g.v(), g.v_tmp());
+    // w: (nx, ny, nz+1)；2D 时 W 恒为 0，不参与
+    if constexpr (Dim == 3)
+    {
+        jacobiDiffuseComponent<Dim>(g, MacGrid::FieldKind::W, g.w_tmp(), g.w(), a, rbeta, params_.jacobi_iters);
+        commit<Dim>(g, MacGrid::FieldKind::W, g.w(), g.w_tmp());
+    }
 }
 
-void StableFluidSolver::jacobiDiffuseComponent(std::vector<float>&       dst,
-                                               const std::vector<float>& src,
-                                               int                       sx, int  sy, int    sz,
-                                               float                     a, float rbeta, int iters)
+template <int Dim>
+void StableFluidSolver::jacobiDiffuseComponent(const MacGrid&     g,
+                                               MacGrid::FieldKind kind,
+                                               Field&             dst,
+                                               const Field&       src,
+                                               float              a, float rbeta, int iters)
 {
-    std::vector<float> x = src; // 初值
-    dst.resize(src.size());
+    const glm::ivec3 dims = g.fieldDims(kind);
+    const int        sx   = dims.x, sy = dims.y;
+    auto idx = [&](int i, int j, int k) { return (static_cast<size_t>(k) * sy + j) * sx + i; };
+
+    // 边界取全局边界的本地下标；分块时只更新 owned 区间，幽灵层每次迭代后交换
+    const glm::ivec3 blo = -g.globalOffset();
+    const glm::ivec3 bhi = g.globalFieldDims(kind) - g.globalOffset() - 1;
 
-    auto idx = [&](int i, int j, int k) { return (k * sy + j) * sx + i; };
+    // 初值 x = src；x 与 dst 乒乓。每个分量有自己的 x，尺寸固定，交换只在同尺寸的两份之间进行；
+    // 两份都是常驻缓存，第一次用时由 initField 按 slab 首次触碰
+    Field& x = diffuse_x_[static_cast<int>(kind)];
+    if (x.size() != src.size()) g.initField(x, kind);
+    if (dst.size() != src.size()) g.initField(dst, kind);
+    if (tracking_)
+    {
+        // 跟踪时只需活跃区和外围；外围在两份缓存里都保持 src，迭代只改写活跃区
+        forTiles<Dim>(g, active_tiles_, kind, glm::ivec3(0), dims, [&](int i, int j, int k) { x[idx(i, j, k)] = src[idx(i, j, k)]; });
+        fillShell<Dim>(g, kind, x, src);
+        fillShell<Dim>(g, kind, dst, src);
+    }
+    else
+    {
+        parallelForGrid<Dim>(dims, [&](int i, int j, int k) { x[idx(i, j, k)] = src[idx(i, j, k)]; });
+    }
 
+    // 未知量是全局边界以内的面
+    ChebyshevSchedule cheb(params_.chebyshev ? jacobiSpectralRadius<Dim>(g.globalFieldDims(kind) - 2, a, 1.0f) : 0.0f);
     for (int it = 0; it < iters; ++it)
     {
-        for (int k = 0; k < sz; ++k)
-            for (int j = 0; j < sy; ++j)
-                for (int i = 0; i < sx; ++i)
-                {
-                    // 边界：直接抄原值（免得访问越界）；可将其改为无滑移等
-                    if (i == 0 || j == 0 || k == 0 || i == sx - 1 || j == sy - 1 || k == sz - 1)
-                    {
-                        dst[idx(i, j, k)] = 0.0f; // 粘墙
-                        continue;
-                    }
-                    float sumN = x[idx(i - 1, j, k)] + x[idx(i + 1, j, k)]
-                                 + x[idx(i, j - 1, k)] + x[idx(i, j + 1, k)]
-                                 + x[idx(i, j, k - 1)] + x[idx(i, j, k + 1)];
-                    // Jacobi: (x - a*laplace x = src) -> x = (src + a*sumN) * rbeta
-                    dst[idx(i, j, k)] = (src[idx(i, j, k)] + a * sumN) * rbeta;
-                }
+        // dst 里是上上次迭代的结果，外推后原地写回
+        const float omega = cheb.next();
+        forCells<Dim>(g, kind, g.ownedBegin(kind), g.ownedEnd(kind), [&](int i, int j, int k)
+        {
+            // 边界：直接抄原值（免得访问越界）；可将其改为无滑移等（2D 不看 k）
+            bool boundary = i == blo.x || j == blo.y || i == bhi.x || j == bhi.y;
+            if constexpr (Dim == 3) boundary = boundary || k == blo.z || k == bhi.z;
+            if (boundary)
+            {
+                dst[idx(i, j, k)] = 0.0f; // 粘墙
+                return;
+            }
+            float sumN = x[idx(i - 1, j, k)] + x[idx(i + 1, j, k)]
+                         + x[idx(i, j - 1, k)] + x[idx(i, j + 1, k)];
+            if constexpr (Dim == 3) sumN = sumN + x[idx(i, j, k - 1)] + x[idx(i, j, k + 1)];
+            // Jacobi: (x - a*laplace x = src) -> x = (src + a*sumN) * rbeta
+            dst[idx(i, j, k)] = ChebyshevSchedule::blend(omega, (src[idx(i, j, k)] + a * sumN) * rbeta, dst[idx(i, j, k)]);
+        });
+        exchangeHalo(g, {{&dst, kind}});
         x.swap(dst);
     }
     // 结果在 x 中
-    dst = x;
+    dst.swap(x);
 }
 
+template <int Dim>
 void StableFluidSolver::advect(MacGrid& g, float dt)
 {
-    semiLagrangianAdvectU(g, dt);
-    semiLagrangianAdvectV(g, dt);
-    semiLagrangianAdvectW(g, dt);
-    if (params_.advect_dye)
+    // 三个分量都沿同一份旧速度场回溯，全部算完再交换
+    exchangeVelocity<Dim>(g);
+    advectField<Dim>(g, g.u(), g.u_tmp(), MacGrid::FieldKind::U, params_.velocity_advection, dt);
+    advectField<Dim>(g, g.v(), g.v_tmp(), MacGrid::FieldKind::V, params_.velocity_advection, dt);
+    if constexpr (Dim == 3)
     {
-        semiLagrangianAdvectDye(g, dt);
+        advectField<Dim>(g, g.w(), g.w_tmp(), MacGrid::FieldKind::W, params_.velocity_advection, dt);
     }
+    commit<Dim>(g, MacGrid::FieldKind::U, g.u(), g.u_tmp());
+    commit<Dim>(g, MacGrid::FieldKind::V, g.v(), g.v_tmp());
+    if constexpr (Dim == 3) commit<Dim>(g, MacGrid::FieldKind::W, g.w(), g.w_tmp());
+    // 标量回溯和之后的散度都要读新速度的幽灵层
+    exchangeVelocity<Dim>(g);
+
+    advectScalars<Dim>(g, dt);
 }
 
-void StableFluidSolver::semiLagrangianAdvectU(MacGrid& g, float dt)
+template <int Dim>
+void StableFluidSolver::advectScalars(MacGrid& g, float dt)
 {
-    // 回溯每个 u-face 的中心，沿全速度场跟踪
-    for (int k = 0; k < g.nz(); ++k)
-        for (int j = 0; j < g.ny(); ++j)
-            for (int i = 0; i < g.nx() + 1; ++i)
+    // 染料与注册的标量通道都在 cell center 上，共享同一次回溯
+    sc_src_.clear();
+    if (params_.advect_dye) sc_src_.push_back(&g.dye());
+    for (int c = 0; c < g.scalarChannelCount(); ++c) sc_src_.push_back(&g.scalar(c));
+    if (sc_src_.empty()) return;
+
+    const size_t channels = sc_src_.size();
+    // 各通道的幽灵层一次交换完
+    auto exchangeChannels = [&](const std::vector<const Field*>& fields)
+    {
+        if (!halo_) return;
+        std::vector<HaloField> list;
+        for (const Field* f : fields) list.push_back({const_cast<Field*>(f), MacGrid::FieldKind::Center});
+        halo_->exchange(g, list);
+    };
+    exchangeChannels(sc_src_);
+
+    const bool   limit    = params_.advection_limiter;
+    auto*        lo       = limit ? &sc_lo_ : nullptr;
+    auto*        hi       = limit ? &sc_hi_ : nullptr;
+
+    std::vector<const Field*> fwd_src;
+    switch (params_.dye_advection)
+    {
+    case AdvectionScheme::MacCormack:
+    {
+        semiLagrangianAdvectScalars<Dim>(g, sc_src_, sc_fwd_, dt, lo, hi);
+        for (size_t c = 0; c < channels; ++c)
+        {
+            fillShell<Dim>(g, MacGrid::FieldKind::Center, sc_fwd_[c], *sc_src_[c]);
+            fwd_src.push_back(&sc_fwd_[c]);
+        }
+        exchangeChannels(fwd_src);
+        semiLagrangianAdvectScalars<Dim>(g, fwd_src, sc_back_, -dt);
+
+        sc_out_.resize(channels);
+        for (size_t c = 0; c < channels; ++c)
+        {
+            const auto& src = *sc_src_[c];
+            auto&       out = sc_out_[c];
+            out.resize(src.size());
+            forElements<Dim>(g, MacGrid::FieldKind::Center, [&](size_t n)
+            {
+                float corrected = sc_fwd_[c][n] + 0.5f * (src[n] - sc_back_[c][n]);
+                if (limit && (corrected < sc_lo_[c][n] || corrected > sc_hi_[c][n]))
+                {
+                    corrected = sc_fwd_[c][n];
+                }
+                out[n] = corrected;
+            });
+        }
+        break;
+    }
+    case AdvectionScheme::BFECC:
+    {
+        semiLagrangianAdvectScalars<Dim>(g, sc_src_, sc_fwd_, dt, lo, hi);
+        for (size_t c = 0; c < channels; ++c)
+        {
+            fillShell<Dim>(g, MacGrid::FieldKind::Center, sc_fwd_[c], *sc_src_[c]);
+            fwd_src.push_back(&sc_fwd_[c]);
+        }
+        exchangeChannels(fwd_src);
+        semiLagrangianAdvectScalars<Dim>(g, fwd_src, sc_back_, -dt);
+
+        std::vector<const Field*> corrected;
+        for (size_t c = 0; c < channels; ++c)
+        {
+            const auto& src  = *sc_src_[c];
+            auto&       back = sc_back_[c];
+            // 外围没有回溯，补偿后的值就是 src
+            fillShell<Dim>(g, MacGrid::FieldKind::Center, back, src);
+            forElements<Dim>(g, MacGrid::FieldKind::Center, [&](size_t n) { back[n] = src[n] + 0.5f * (src[n] - back[n]); });
+            corrected.push_back(&back);
+        }
+        exchangeChannels(corrected);
+        semiLagrangianAdvectScalars<Dim>(g, corrected, sc_out_, dt);
+
+        if (limit)
+        {
+            for (size_t c = 0; c < channels; ++c)
             {
-                vec3 x                     = g.uFacePos(i, j, k);
-                vec3 v                     = g.sampleVelocity(x);
-                vec3 xp                    = g.clampToDomain(x - v * dt);
-                g.u_tmp()[g.idxU(i, j, k)] = g.sampleU(xp);
+                forElements<Dim>(g, MacGrid::FieldKind::Center, [&](size_t n)
+                {
+                    sc_out_[c][n] = std::clamp(sc_out_[c][n], sc_lo_[c][n], sc_hi_[c][n]);
+                });
             }
-    g.u().swap(g.u_tmp());
+        }
+        break;
+    }
+    default: semiLagrangianAdvectScalars<Dim>(g, sc_src_, sc_out_, dt);
+        break;
+    }
+
+    size_t c = 0;
+    if (params_.advect_dye) commit<Dim>(g, MacGrid::FieldKind::Center, g.dye(), sc_out_[c++]);
+    for (int ch = 0; ch < g.scalarChannelCount(); ++ch) commit<Dim>(g, MacGrid::FieldKind::Center, g.scalar(ch), sc_out_[c++]);
 }
 
-void StableFluidSolver::semiLagrangianAdvectV(MacGrid& g, float dt)
+template <int Dim>
+void StableFluidSolver::semiLagrangianAdvectScalars(const MacGrid&                   g,
+                                                    const std::vector<const Field*>& src,
+                                                    std::vector<Field>&              dst,
+                                                    float                            dt,
+                                                    std::vector<Field>*              lo,
+                                                    std::vector<Field>*              hi)
 {
-    for (int k = 0; k < g.nz(); ++k)
-        for (int j = 0; j < g.ny() + 1; ++j)
-            for (int i = 0; i < g.nx(); ++i)
+    const size_t channels = src.size();
+    auto ensure = [&](std::vector<Field>& fields)
+    {
+        // 新通道的缓存按 slab 首次触碰；已有的 resize 不会改变大小
+        fields.resize(channels);
+        for (auto& f : fields)
+        {
+            if (f.size() != g.fieldSize(MacGrid::FieldKind::Center)) g.initField(f, MacGrid::FieldKind::Center);
+        }
+    };
+    ensure(dst);
+    if (lo && hi)
+    {
+        ensure(*lo);
+        ensure(*hi);
+    }
+
+    forCells<Dim>(g, MacGrid::FieldKind::Center, g.ownedBegin(MacGrid::FieldKind::Center),
+                  g.ownedEnd(MacGrid::FieldKind::Center), [&](int i, int j, int k)
+    {
+        const size_t n  = g.idxP(i, j, k);
+        vec3         x  = g.cellCenter(i, j, k);
+        vec3         v  = g.sampleVelocity<Dim>(x);
+        vec3         xp = g.clampToDomain<Dim>(x - v * dt);
+
+        // 回溯与权重只算一次，之后每个通道只剩 8 次读取
+        const MacGrid::SampleStencil st = g.sampleStencil<Dim>(MacGrid::FieldKind::Center, xp);
+        for (size_t c = 0; c < channels; ++c)
+        {
+            if (lo && hi)
             {
-                vec3 x                     = g.vFacePos(i, j, k);
-                vec3 v                     = g.sampleVelocity(x);
-                vec3 xp                    = g.clampToDomain(x - v * dt);
-                g.v_tmp()[g.idxV(i, j, k)] = g.sampleV(xp);
+                dst[c][n] = MacGrid::applyStencil<Dim>(st, *src[c], &(*lo)[c][n], &(*hi)[c][n]);
             }
-    g.v().swap(g.v_tmp());
+            else
+            {
+                dst[c][n] = MacGrid::applyStencil<Dim>(st, *src[c]);
+            }
+        }
+    });
 }
 
-void StableFluidSolver::semiLagrangianAdvectW(MacGrid& g, float dt)
+template <int Dim>
+void StableFluidSolver::advectField(const MacGrid&     g,
+                                    const Field&       src,
+                                    Field&             dst,
+                                    MacGrid::FieldKind kind,
+                                    AdvectionScheme    scheme,
+                                    float              dt)
 {
-    for (int k = 0; k < g.nz() + 1; ++k)
-        for (int j = 0; j < g.ny(); ++j)
-            for (int i = 0; i < g.nx(); ++i)
-            {
-                vec3 x                     = g.wFacePos(i, j, k);
-                vec3 v                     = g.sampleVelocity(x);
-                vec3 xp                    = g.clampToDomain(x - v * dt);
-                g.w_tmp()[g.idxW(i, j, k)] = g.sampleW(xp);
-            }
-    g.w().swap(g.w_tmp());
+    switch (scheme)
+    {
+    case AdvectionScheme::MacCormack: macCormackAdvect<Dim>(g, src, dst, kind, dt);
+        break;
+    case AdvectionScheme::BFECC: bfeccAdvect<Dim>(g, src, dst, kind, dt);
+        break;
+    default: semiLagrangianAdvect<Dim>(g, src, dst, kind, dt);
+        break;
+    }
 }
 
-void StableFluidSolver::semiLagrangianAdvectDye(MacGrid& g, float dt)
+template <int Dim>
+void StableFluidSolver::semiLagrangianAdvect(const MacGrid&     g,
+                                             const Field&       src,
+                                             Field&             dst,
+                                             MacGrid::FieldKind kind,
+                                             float              dt,
+                                             Field*             lo,
+                                             Field*             hi)
 {
-    // 染料在 cell center 上
-    for (int k = 0; k < g.nz(); ++k)
-        for (int j = 0; j < g.ny(); ++j)
-            for (int i = 0; i < g.nx(); ++i)
-            {
-                vec3 x                     = g.cellCenter(i, j, k);
-                vec3 v                     = g.sampleVelocity(x);
-                vec3 xp                    = g.clampToDomain(x - v * dt);
-                g.p_tmp()[g.idxP(i, j, k)] = g.sampleCellScalar(g.dye(), xp);
-            }
-    g.dye().swap(g.p_tmp());
+    // 缓存第一次使用时按 slab 首次触碰
+    auto ensure = [&](Field& f)
+    {
+        if (f.size() != src.size()) g.initField(f, kind);
+    };
+    ensure(dst);
+    if (lo && hi)
+    {
+        ensure(*lo);
+        ensure(*hi);
+    }
+
+    // 回溯每个采样点（face 中心或 cell 中心），沿全速度场跟踪
+    forCells<Dim>(g, kind, g.ownedBegin(kind), g.ownedEnd(kind), [&](int i, int j, int k)
+    {
+        const size_t n  = g.fieldIdx(kind, i, j, k);
+        vec3         x  = g.fieldPos(kind, i, j, k);
+        vec3         v  = g.sampleVelocity<Dim>(x);
+        vec3         xp = g.clampToDomain<Dim>(x - v * dt);
+        if (lo && hi)
+        {
+            dst[n] = g.sampleField<Dim>(src, kind, xp, &(*lo)[n], &(*hi)[n]);
+        }
+        else
+        {
+            dst[n] = g.sampleField<Dim>(src, kind, xp);
+        }
+    });
+}
+
+template <int Dim>
+void StableFluidSolver::macCormackAdvect(const MacGrid&     g,
+                                         const Field&       src,
+                                         Field&             dst,
+                                         MacGrid::FieldKind kind,
+                                         float              dt)
+{
+    const bool limit = params_.advection_limiter;
+
+    // 前向：phi_hat = SL(phi, dt)；反向：phi_bar = SL(phi_hat, -dt)
+    semiLagrangianAdvect<Dim>(g, src, adv_fwd_, kind, dt, limit ? &adv_lo_ : nullptr, limit ? &adv_hi_ : nullptr);
+    fillShell<Dim>(g, kind, adv_fwd_, src);
+    exchangeHalo(g, {{&adv_fwd_, kind}}); // 反向回溯会读到幽灵层里的前向结果
+    semiLagrangianAdvect<Dim>(g, adv_fwd_, adv_back_, kind, -dt);
+
+    // 误差补偿：phi = phi_hat + (phi - phi_bar) / 2
+    if (dst.size() != src.size()) g.initField(dst, kind);
+    forElements<Dim>(g, kind, [&](size_t n)
+    {
+        float corrected = adv_fwd_[n] + 0.5f * (src[n] - adv_back_[n]);
+        // 越出回溯点邻域极值时退回一阶结果（Selle et al. 2008）
+        if (limit && (corrected < adv_lo_[n] || corrected > adv_hi_[n]))
+        {
+            corrected = adv_fwd_[n];
+        }
+        dst[n] = corrected;
+    });
 }
 
+template <int Dim>
+void StableFluidSolver::bfeccAdvect(const MacGrid&     g,
+                                    const Field&       src,
+                                    Field&             dst,
+                                    MacGrid::FieldKind kind,
+                                    float              dt)
+{
+    const bool limit = params_.advection_limiter;
+
+    // 前向 + 反向得到误差估计：e = (phi - SL(SL(phi, dt), -dt)) / 2
+    semiLagrangianAdvect<Dim>(g, src, adv_fwd_, kind, dt, limit ? &adv_lo_ : nullptr, limit ? &adv_hi_ : nullptr);
+    fillShell<Dim>(g, kind, adv_fwd_, src);
+    exchangeHalo(g, {{&adv_fwd_, kind}}); // 反向回溯会读到幽灵层里的前向结果
+    semiLagrangianAdvect<Dim>(g, adv_fwd_, adv_back_, kind, -dt);
+
+    // 先补偿再前向对流：phi = SL(phi + e, dt)（外围没有回溯，补偿后的值就是 src）
+    fillShell<Dim>(g, kind, adv_back_, src);
+    forElements<Dim>(g, kind, [&](size_t n) { adv_back_[n] = src[n] + 0.5f * (src[n] - adv_back_[n]); });
+    exchangeHalo(g, {{&adv_back_, kind}});
+    semiLagrangianAdvect<Dim>(g, adv_back_, dst, kind, dt);
+
+    if (limit)
+    {
+        forElements<Dim>(g, kind, [&](size_t n) { dst[n] = std::clamp(dst[n], adv_lo_[n], adv_hi_[n]); });
+    }
+}
+
+template <int Dim>
 void StableFluidSolver::computeDivergence(MacGrid& g)
 {
     const float invh = 1.0f / g.h();
-    for (int k = 0; k < g.nz(); ++k)
-        for (int j = 0; j < g.ny(); ++j)
-            for (int i = 0; i < g.nx(); ++i)
-            {
-                float du       = g.U(i + 1, j, k) - g.U(i, j, k);
-                float dv       = g.V(i, j + 1, k) - g.V(i, j, k);
-                float dw       = g.W(i, j, k + 1) - g.W(i, j, k);
-                g.Div(i, j, k) = invh * (du + dv + dw);
-            }
+    forCells<Dim>(g, MacGrid::FieldKind::Center, g.ownedBegin(MacGrid::FieldKind::Center),
+                  g.ownedEnd(MacGrid::FieldKind::Center), [&](int i, int j, int k)
+    {
+        float du = g.U(i + 1, j, k) - g.U(i, j, k);
+        float dv = g.V(i, j + 1, k) - g.V(i, j, k);
+        float dw = 0.0f;
+        if constexpr (Dim == 3) dw = g.W(i, j, k + 1) - g.W(i, j, k);
+        g.Div(i, j, k) = invh * (du + dv + dw);
+    });
 }
 
+template <int Dim>
 void StableFluidSolver::jacobiPressure(MacGrid& g, int iters)
 {
-    // 解: laplace(p) = div, 6 点模板
+    // 解: laplace(p) = div, 3D 7 点模板 / 2D 5 点模板
+    // 全局边界 cell 的本地下标（分块时可能落在本块之外）
+    const glm::ivec3 blo = -g.globalOffset();
+    const glm::ivec3 bhi = g.globalDims() - g.globalOffset() - 1;
+    exchangeHalo(g, {{&g.p(), MacGrid::FieldKind::Center}});
+    // 跟踪时活跃区外的压力不变，作为活跃区的 Dirichlet 边界
+    fillShell<Dim>(g, MacGrid::FieldKind::Center, g.p_tmp(), g.p());
+    ChebyshevSchedule cheb(params_.chebyshev ? jacobiSpectralRadius<Dim>(g.globalDims() - 2, 1.0f, 0.0f) : 0.0f);
     for (int it = 0; it < iters; ++it)
     {
-        for (int k = 0; k < g.nz(); ++k)
-            for (int j = 0; j < g.ny(); ++j)
-                for (int i = 0; i < g.nx(); ++i)
-                {
-                    // 边界：设 p=0（可改 Neumann）
-                    if (i == 0 || j == 0 || k == 0 || i == g.nx() - 1 || j == g.ny() - 1 || k == g.nz() - 1)
-                    {
-                        g.p_tmp()[g.idxP(i, j, k)] = 0.0f;
-                        continue;
-                    }
-
-                    float sumN = g.P(i - 1, j, k) + g.P(i + 1, j, k)
-                                 + g.P(i, j - 1, k) + g.P(i, j + 1, k)
-                                 + g.P(i, j, k - 1) + g.P(i, j, k + 1);
-                    // Jacobi: p_new = (sumN - h^2 * div) / 6
-                    g.p_tmp()[g.idxP(i, j, k)] = (sumN - g.h() * g.h() * g.Div(i, j, k)) / 6.0f;
-                }
+        // p_tmp 里是上上次迭代的结果，外推后原地写回
+        const float omega = cheb.next();
+        forCells<Dim>(g, MacGrid::FieldKind::Center, g.ownedBegin(MacGrid::FieldKind::Center),
+                      g.ownedEnd(MacGrid::FieldKind::Center), [&](int i, int j, int k)
+        {
+            // 边界：设 p=0（可改 Neumann）
+            bool boundary = i == blo.x || j == blo.y || i == bhi.x || j == bhi.y;
+            if constexpr (Dim == 3) boundary = boundary || k == blo.z || k == bhi.z;
+            if (boundary)
+            {
+                g.p_tmp()[g.idxP(i, j, k)] = 0.0f;
+                return;
+            }
+
+            float sumN = g.P(i - 1, j, k) + g.P(i + 1, j, k)
+                         + g.P(i, j - 1, k) + g.P(i, j + 1, k);
+            if constexpr (Dim == 3) sumN = sumN + g.P(i, j, k - 1) + g.P(i, j, k + 1);
+            // Jacobi: p_new = (sumN - h^2 * div) / (2 * Dim)
+            float& out = g.p_tmp()[g.idxP(i, j, k)];
+            out        = ChebyshevSchedule::blend(omega, (sumN - g.h() * g.h() * g.Div(i, j, k)) / (2.0f * Dim), out);
+        });
+        g.p().swap(g.p_tmp());
+        exchangeHalo(g, {{&g.p(), MacGrid::FieldKind::Center}});
+    }
+    // 奇数次交换后 p 是原来的 p_tmp，活跃区外是旧值：把活跃区拷回原缓冲再换回来
+    if (tracking_ && iters % 2 == 1)
+    {
+        commit<Dim>(g, MacGrid::FieldKind::Center, g.p_tmp(), g.p());
         g.p().swap(g.p_tmp());
     }
 }
 
+template <int Dim>
 void StableFluidSolver::subtractPressureGradient(MacGrid& g)
 {
     const float invh = 1.0f / g.h();
 
+    // 只更新内部面（全局边界面在 applyBoundary）与本块 owned 区间的交集
+    auto interior = [&](MacGrid::FieldKind kind, glm::ivec3& lo, glm::ivec3& hi)
+    {
+        const int  axis = MacGrid::staggeredAxis(kind);
+        glm::ivec3 glo(0), ghi = g.globalDims();
+        glo[axis] = 1;
+        lo        = glm::max(g.ownedBegin(kind), glo - g.globalOffset());
+        hi        = glm::min(g.ownedEnd(kind), ghi - g.globalOffset());
+    };
+    glm::ivec3 lo, hi;
+
     // u
-    for (int k = 0; k < g.nz(); ++k)
-        for (int j = 0; j < g.ny(); ++j)
-            for (int i = 1; i < g.nx(); ++i)
-            { // 注意 i=0 与 i=nx 的边界在 applyBoundary
-                float gradp = g.P(i, j, k) - g.P(i - 1, j, k);
-                g.U(i, j, k) -= invh * gradp;
-            }
+    interior(MacGrid::FieldKind::U, lo, hi);
+    forCells<Dim>(g, MacGrid::FieldKind::U, lo, hi, [&](int i, int j, int k)
+    { // 注意 i=0 与 i=nx 的边界在 applyBoundary
+        float gradp = g.P(i, j, k) - g.P(i - 1, j, k);
+        g.U(i, j, k) -= invh * gradp;
+    });
     // v
-    for (int k = 0; k < g.nz(); ++k)
-        for (int j = 1; j < g.ny(); ++j)
-            for (int i = 0; i < g.nx(); ++i)
-            {
-                float gradp = g.P(i, j, k) - g.P(i, j - 1, k);
-                g.V(i, j, k) -= invh * gradp;
-            }
-    // w
-    for (int k = 1; k < g.nz(); ++k)
-        for (int j = 0; j < g.ny(); ++j)
-            for (int i = 0; i < g.nx(); ++i)
-            {
-                float gradp = g.P(i, j, k) - g.P(i, j, k - 1);
-                g.W(i, j, k) -= invh * gradp;
-            }
+    interior(MacGrid::FieldKind::V, lo, hi);
+    forCells<Dim>(g, MacGrid::FieldKind::V, lo, hi, [&](int i, int j, int k)
+    {
+        float gradp = g.P(i, j, k) - g.P(i, j - 1, k);
+        g.V(i, j, k) -= invh * gradp;
+    });
+    // w（2D 时 nz == 1，没有内部 w 面）
+    if constexpr (Dim == 3)
+    {
+        interior(MacGrid::FieldKind::W, lo, hi);
+        forCells<Dim>(g, MacGrid::FieldKind::W, lo, hi, [&](int i, int j, int k)
+        {
+            float gradp = g.P(i, j, k) - g.P(i, j, k - 1);
+            g.W(i, j, k) -= invh * gradp;
+        });
+    }
 }
 
+template <int Dim>
 void StableFluidSolver::project(MacGrid& g)
 {
-    computeDivergence(g);
-    jacobiPressure(g, params_.jacobi_iters);
-    subtractPressureGradient(g);
+    computeDivergence<Dim>(g);
+    jacobiPressure<Dim>(g, params_.jacobi_iters);
+    PhysicsStats::instance().addCount("pressure iterations", params_.jacobi_iters);
+    subtractPressureGradient<Dim>(g);
 }
 
 void StableFluidSolver::applyBoundary(MacGrid& g)
@@ -237,25 +829,29 @@ void StableFluidSolver::applyBoundary(MacGrid& g)
     // 粘墙：边界法向速度为0
     const int nx = g.nx(), ny = g.ny(), nz = g.nz();
 
+    // 全局边界面的本地下标；分块时只处理落在本块里的那些
+    const glm::ivec3 lo = -g.globalOffset();
+    const glm::ivec3 hi = g.globalDims() - g.globalOffset();
+
     // u on x faces
     for (int j = 0; j < ny; ++j)
         for (int k = 0; k < nz; ++k)
         {
-            g.U(0, j, k)  = 0.0f;
-            g.U(nx, j, k) = 0.0f;
+            if (lo.x >= 0) g.U(lo.x, j, k) = 0.0f;
+            if (hi.x <= nx) g.U(hi.x, j, k) = 0.0f;
         }
     // v on y faces
     for (int i = 0; i < nx; ++i)
         for (int k = 0; k < nz; ++k)
         {
-            g.V(i, 0, k)  = 0.0f;
-            g.V(i, ny, k) = 0.0f;
+            if (lo.y >= 0) g.V(i, lo.y, k) = 0.0f;
+            if (hi.y <= ny) g.V(i, hi.y, k) = 0.0f;
         }
     // w on z faces
     for (int i = 0; i < nx; ++i)
         for (int j = 0; j < ny; ++j)
         {
-            g.W(i, j, 0)  = 0.0f;
-            g.W(i, j, nz) = 0.0f;
+            if (lo.z >= 0) g.W(i, j, lo.z) = 0.0f;
+            if (hi.z <= nz) g.W(i, j, hi.z) = 0.0f;
         }
 }
@@ -4,18 +4,53 @@
 #include "data/MacGrid.h"
 
 namespace dk {
+class HaloExchange;
+struct HaloField;
 
 class StableFluidSolver : public ISolver
 {
 public:
+    // 对流格式：高阶格式在同等网格下耗散更小，可以用更粗的网格得到相近的细节
+    enum class AdvectionScheme
+    {
+        SemiLagrangian, // 一阶半拉格朗日：1 次回溯
+        MacCormack,     // 前向 + 反向估计误差再补偿：2 次回溯
+        BFECC           // 前向 + 反向 + 补偿后再前向：3 次回溯
+    };
+
     struct Params
     {
         float    viscosity     = 0.0005f;      // 黏性系数 (m^2/s)
         dk::vec3 gravity       = dk::vec3(0, -9.8f, 0);
         int      jacobi_iters  = 60;           // 压力/扩散迭代次数
+        bool     chebyshev     = false;        // 压力/扩散的 Jacobi 迭代用 Chebyshev 加速，达到同样残差的迭代次数少几倍
         bool     clamp_sides   = true;         // 盒边界“粘墙”
-        bool     advect_dye    = true;         // 是否对流染料
+        bool     advect_dye    = true;         // 是否对流染料（注册的标量通道总是对流）
         float    vorticity_eps = 0.0f;         // 涡度加强(0关闭)
+
+        AdvectionScheme velocity_advection = AdvectionScheme::SemiLagrangian; // 速度场对流格式
+        AdvectionScheme dye_advection      = AdvectionScheme::SemiLagrangian; // 染料及标量通道对流格式
+        bool            advection_limiter  = true; // 高阶格式把结果限制在回溯点邻域极值内，防止过冲振荡
+
+        // 活跃区跟踪：每步只在“有东西在动”的 tile 上计算，其余区域保持不变。
+        // 静止空气视为与重力静水平衡，重力只加在种子 tile 上；不跟踪时重力加在整个 V 场，
+        // 两种模式下远处空气的速度因此不同。有重力时压力投影很快把运动传遍封闭盒子，
+        // 活跃区几步内就会铺满全域，跟踪主要适合无重力（烟雾、浮力驱动）的场景。
+        // 分块（域分解）模式下不生效，退回整场计算并在 Stats::tracking_fallback 里标出
+        bool  track_active_tiles  = false;
+        float active_velocity_eps = 0.05f; // 任一速度分量 |u| 超过它的 tile 为活跃 (m/s)
+        float active_scalar_eps   = 1e-3f; // 染料或标量通道 |c| 超过它的 tile 为活跃
+    };
+
+    // 活跃区边长（cell），2D 时 z 方向只有一层
+    static constexpr int kTileSize = 8;
+
+    struct Stats
+    {
+        i64   active_tiles      = 0;
+        i64   total_tiles       = 0;
+        float active_fraction   = 1.0f;  // 本步参与计算的 tile 比例（未开启跟踪时为 1）
+        bool  tracking_fallback = false; // 开启了跟踪但因分块退回整场计算
     };
 
     explicit StableFluidSolver(const Params& p = Params{}) : params_(p)
@@ -27,31 +62,137 @@ public:
     void          setParams(const Params& p) { params_ = p; }
     const Params& params() const { return params_; }
 
+    // 域分解模式：网格是 SlabDecomposition::makeLocalGrid 建的分块，每个阶段前后经 halo 交换幽灵层。
+    // 传 nullptr 回到单进程；halo 对象由调用方持有
+    void          setHaloExchange(HaloExchange* halo) { halo_ = halo; }
+    HaloExchange* haloExchange() const { return halo_; }
+
+    // 上一次 solve 的统计
+    const Stats& stats() const { return stats_; }
+
 private:
-    // pipeline
+    // pipeline；Dim = 2 / 3 在编译期展开（nz == 1 的网格走 2D）
+    template <int Dim>
+    void solveDim(dk::MacGrid& g, float dt);
+    template <int Dim>
     void addForces(dk::MacGrid& g, float dt);
+    template <int Dim>
     void diffuse(dk::MacGrid& g, float dt);
+    template <int Dim>
     void advect(dk::MacGrid& g, float dt);
+    template <int Dim>
     void project(dk::MacGrid& g);
     void applyBoundary(dk::MacGrid& g);
 
+    // 活跃区：按阈值标记种子 tile，再按 CFL 距离膨胀；全部活跃时退回整场路径
+    template <int Dim>
+    void updateActiveTiles(const dk::MacGrid& g, float dt);
+    // 在 tiles 中各 tile 与 [lo, hi) 的交集上并行调用 fn(i, j, k)；kind 的交错轴上最后一层面归最后一个 tile
+    template <int Dim, class Fn>
+    void forTiles(const dk::MacGrid&      g,
+                  const std::vector<int>& tiles,
+                  dk::MacGrid::FieldKind  kind,
+                  const glm::ivec3&       lo,
+                  const glm::ivec3&       hi,
+                  Fn&&                    fn) const;
+    // 在 [lo, hi) 上并行调用 fn(i, j, k)：跟踪时只走活跃 tile
+    template <int Dim, class Fn>
+    void forCells(const dk::MacGrid& g, dk::MacGrid::FieldKind kind, const glm::ivec3& lo, const glm::ivec3& hi,
+                  Fn&& fn) const;
+    // 对 kind 布局的每个元素下标调用 fn(n)：跟踪时只走活跃 tile，否则整段线性遍历
+    template <int Dim, class Fn>
+    void forElements(const dk::MacGrid& g, dk::MacGrid::FieldKind kind, Fn&& fn) const;
+    // 跟踪时把 src 抄到 scratch 的外围 tile 上，回溯读到活跃区外时得到的是静止值
+    template <int Dim>
+    void fillShell(const dk::MacGrid& g, dk::MacGrid::FieldKind kind, Field& scratch, const Field& src) const;
+    // 把 result 提交为 field：整场时交换，跟踪时只拷回活跃 tile（其余保持原值）
+    template <int Dim>
+    void commit(const dk::MacGrid& g, dk::MacGrid::FieldKind kind, Field& field, Field& result) const;
+
     // kernels
-    void jacobiDiffuseComponent(std::vector<float>&       dst,
-                                const std::vector<float>& src,
-                                int                       sx, int      sy, int sz,
-                                float                     alpha, float rbeta,
-                                int                       iters);
+    template <int Dim>
+    void jacobiDiffuseComponent(const dk::MacGrid&     g,
+                                dk::MacGrid::FieldKind kind,
+                                Field&                 dst,
+                                const Field&           src,
+                                float                  alpha, float rbeta,
+                                int                    iters);
+
+    // 对任意同布局数组做对流：src 沿当前速度场回溯，结果写入 dst（dst 不能与 src 相同）
+    template <int Dim>
+    void advectField(const dk::MacGrid&     g,
+                     const Field&           src,
+                     Field&                 dst,
+                     dk::MacGrid::FieldKind kind,
+                     AdvectionScheme        scheme,
+                     float                  dt);
 
-    void semiLagrangianAdvectU(dk::MacGrid& g, float dt);
-    void semiLagrangianAdvectV(dk::MacGrid& g, float dt);
-    void semiLagrangianAdvectW(dk::MacGrid& g, float dt);
-    void semiLagrangianAdvectDye(dk::MacGrid& g, float dt);
+    // lo/hi 非空时记录每个回溯点邻域的极值（供限制器使用）
+    template <int Dim>
+    void semiLagrangianAdvect(const dk::MacGrid&     g,
+                              const Field&           src,
+                              Field&                 dst,
+                              dk::MacGrid::FieldKind kind,
+                              float                  dt,
+                              Field*                 lo = nullptr,
+                              Field*                 hi = nullptr);
+    // 融合的 cell-centred 标量对流：每个 cell 只回溯一次，采样模板复用到所有通道
+    template <int Dim>
+    void advectScalars(dk::MacGrid& g, float dt);
+    template <int Dim>
+    void semiLagrangianAdvectScalars(const dk::MacGrid&               g,
+                                     const std::vector<const Field*>& src,
+                                     std::vector<Field>&              dst,
+                                     float                            dt,
+                                     std::vector<Field>*              lo = nullptr,
+                                     std::vector<Field>*              hi = nullptr);
 
+    template <int Dim>
+    void macCormackAdvect(const dk::MacGrid&     g,
+                          const Field&           src,
+                          Field&                 dst,
+                          dk::MacGrid::FieldKind kind,
+                          float                  dt);
+    template <int Dim>
+    void bfeccAdvect(const dk::MacGrid&     g,
+                     const Field&           src,
+                     Field&                 dst,
+                     dk::MacGrid::FieldKind kind,
+                     float                  dt);
+
+    template <int Dim>
     void computeDivergence(dk::MacGrid& g);
+    template <int Dim>
     void jacobiPressure(dk::MacGrid& g, int iters);
+    template <int Dim>
     void subtractPressureGradient(dk::MacGrid& g);
 
-    Params params_;
+    // 分块时检查本步的回溯不超出幽灵层（见 SlabDecomposition），超出抛 std::runtime_error
+    void checkHaloCfl(const dk::MacGrid& g, float dt);
+    // 未分解时为空操作
+    void exchangeHalo(const dk::MacGrid& g, const std::vector<HaloField>& fields);
+    template <int Dim>
+    void exchangeVelocity(dk::MacGrid& g);
+
+    Params        params_;
+    HaloExchange* halo_ = nullptr;
+    Stats         stats_;
+
+    // 活跃区：tile 网格尺寸、本步的种子 tile、活跃 tile 与其外围一圈（均为 tile 线性下标，按内存顺序）
+    bool                      tracking_        = false;
+    bool                      fallback_warned_ = false; // 分块退回整场的警告只打一次
+    glm::ivec3                tile_dims_{0};
+    std::vector<int>          seed_tiles_, active_tiles_, shell_tiles_;
+    std::vector<std::uint8_t> tile_mask_, tile_tmp_;
+    std::vector<float>        tile_speed_;
+
+    // 扩散迭代与高阶对流的中间结果（常驻缓存，首次使用时按 slab 首次触碰，避免每步分配）
+    Field diffuse_x_[3]; // 按分量 U/V/W 各一份
+    Field adv_fwd_, adv_back_, adv_lo_, adv_hi_;
+    // 标量通道的对应缓存（每通道一份）
+    std::vector<const Field*> sc_src_;
+    std::vector<Field>        sc_out_, sc_fwd_, sc_back_, sc_lo_, sc_hi_;
+    std::vector<float>        plane_max_; // checkHaloCfl 的逐平面最大值
 };
 
 }
\ No newline at end of file
@@ -14,7 +14,7 @@ void VerletSolver::solve(ISimulationState& state, const float dt)
 
     for (int i = 0; i < count; ++i)
     {
-        if (data.is_fixed[i] || data.mass[i] == 0.0f) continue;
+        if (!data.isActive(i) || data.mass[i] == 0.0f) continue;
 
         // 1. 计算加速度
         // 注意: 在Verlet中，我们不改变全局的 data.accelerations
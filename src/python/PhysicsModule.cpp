@@ -0,0 +1,367 @@
+// python/PhysicsModule.cpp
+// decker_physics：无界面驱动物理部分的 Python 模块，不依赖 Vulkan / SDL.
+// 网格字段与质点数组以 NumPy 视图返回，不拷贝，写入视图就是写入仿真数据。
+// 视图只在下一次 step / tick 之前有效：求解器会交换字段缓冲，质点增删会让数组重新分配；
+// 每步之后重新取一次属性即可，取属性本身只是包一层指针。
+// 网格字段按 [k, j, i]（z 最慢）索引，与 MacGrid 的存储顺序一致。
+#include <pybind11/functional.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "Generator.h"
+#include "MassSpring.h"
+#include "World.h"
+#include "data/MACInit.h"
+#include "fluid/FluidSystem.h"
+#include "force/DampingForce.h"
+#include "force/GravityForce.h"
+#include "force/SpringForce.h"
+#include "solver/EulerSolver.h"
+#include "solver/ImplicitEulerSolver.h"
+#include "solver/PBDSolver.h"
+#include "solver/ProjectiveDynamicsSolver.h"
+#include "solver/VerletSolver.h"
+
+namespace py = pybind11;
+
+// vec3 与长度为 3 的序列（tuple、list、ndarray）互转
+namespace pybind11::detail {
+template <>
+struct type_caster<glm::vec3>
+{
+    PYBIND11_TYPE_CASTER(glm::vec3, const_name("tuple[float, float, float]"));
+
+    bool load(handle src, bool)
+    {
+        if (!isinstance<sequence>(src)) return false;
+        const auto seq = reinterpret_borrow<sequence>(src);
+        if (seq.size() != 3) return false;
+        for (size_t c = 0; c < 3; ++c) value[static_cast<int>(c)] = seq[c].cast<float>();
+        return true;
+    }
+
+    static handle cast(const glm::vec3& v, return_value_policy, handle)
+    {
+        return make_tuple(v.x, v.y, v.z).release();
+    }
+};
+}
+
+namespace dk {
+namespace {
+static_assert(sizeof(vec3) == 3 * sizeof(float) && sizeof(vec4) == 4 * sizeof(float), "vec3/vec4 must be tightly packed to be viewed as float arrays");
+
+// 不拷贝的 C 顺序视图；owner 是持有数据的 Python 对象，视图存活期间它不会被回收
+template <class T>
+py::array_t<T> view(py::handle owner, T* data, std::vector<py::ssize_t> shape)
+{
+    std::vector<py::ssize_t> strides(shape.size());
+    py::ssize_t              stride = sizeof(T);
+    for (size_t d = shape.size(); d-- > 0;)
+    {
+        strides[d] = stride;
+        stride *= shape[d];
+    }
+    return py::array_t<T>(std::move(shape), std::move(strides), data, owner);
+}
+
+py::array_t<float> fieldView(py::handle owner, const MacGrid& g, MacGrid::FieldKind kind, Field& f)
+{
+    const glm::ivec3 d = g.fieldDims(kind);
+    return view(owner, f.data(), {d.z, d.y, d.x});
+}
+
+template <class V>
+py::array_t<float> vecView(py::handle owner, std::vector<V>& v)
+{
+    return view(owner, reinterpret_cast<float*>(v.data()), {static_cast<py::ssize_t>(v.size()), V::length()});
+}
+
+py::array_t<float> scalarView(py::handle owner, std::vector<float>& v)
+{
+    return view(owner, v.data(), {static_cast<py::ssize_t>(v.size())});
+}
+
+std::unique_ptr<ISolver> makeSolver(const std::string& kind, int iterations)
+{
+    if (kind == "euler") return std::make_unique<EulerSolver>();
+    if (kind == "verlet") return std::make_unique<VerletSolver>();
+    if (kind == "pbd") return iterations > 0 ? std::make_unique<PBDSolver>(iterations) : std::make_unique<PBDSolver>();
+    if (kind == "implicit_euler")
+    {
+        ImplicitEulerSolver::Params p;
+        if (iterations > 0) p.max_iterations = iterations;
+        return std::make_unique<ImplicitEulerSolver>(p);
+    }
+    if (kind == "projective_dynamics")
+    {
+        ProjectiveDynamicsSolver::Params p;
+        if (iterations > 0) p.iterations = iterations;
+        return std::make_unique<ProjectiveDynamicsSolver>(p);
+    }
+    throw std::runtime_error("unknown solver '" + kind + "' (euler, verlet, pbd, implicit_euler, projective_dynamics)");
+}
+
+template <class T>
+T* checkAdded(T* system, const std::string& name)
+{
+    if (!system) throw std::runtime_error("system '" + name + "' already exists");
+    return system;
+}
+
+// 其他绑定的默认参数和基类要用到的类型先注册
+void bindSystemTypes(py::module_& m)
+{
+    py::class_<WorldSettings>(m, "WorldSettings")
+        .def(py::init([](float fixed_dt, int substeps, float collision_radius)
+        {
+            return WorldSettings{fixed_dt, substeps, collision_radius};
+        }), py::arg("fixed_dt") = WorldSettings{}.fixed_dt, py::arg("substeps") = WorldSettings{}.substeps,
+            py::arg("collision_radius") = WorldSettings{}.collision_radius)
+        .def_readwrite("fixed_dt", &WorldSettings::fixed_dt)
+        .def_readwrite("substeps", &WorldSettings::substeps)
+        .def_readwrite("collision_radius", &WorldSettings::collision_radius);
+
+    py::class_<SystemRate>(m, "SystemRate")
+        .def(py::init([](float fixed_dt, int substeps) { return SystemRate{fixed_dt, substeps}; }),
+             py::arg("fixed_dt") = 0.0f, py::arg("substeps") = 0)
+        .def_readwrite("fixed_dt", &SystemRate::fixed_dt)
+        .def_readwrite("substeps", &SystemRate::substeps);
+
+    py::class_<ISystem>(m, "System")
+        .def("step", &ISystem::step, py::arg("dt"), py::call_guard<py::gil_scoped_release>());
+}
+
+void bindWorld(py::module_& m)
+{
+    py::class_<World>(m, "World")
+        .def(py::init<const WorldSettings&>(), py::arg("settings") = WorldSettings{})
+        .def("tick", &World::tick, py::arg("real_dt"), py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("time", &World::time)
+        .def_property_readonly("settings", &World::settings)
+        .def("add_fluid", [](World& w, const std::string& name, const FluidSystem::Config& cfg)
+        {
+            return checkAdded(w.addSystem<FluidSystem>(name, cfg), name);
+        }, py::arg("name"), py::arg("config") = FluidSystem::Config{}, py::return_value_policy::reference_internal)
+        .def("add_spring_mass", [](World& w, const std::string& name, const std::string& solver, int iterations)
+        {
+            return checkAdded(w.addSystem<SpringMassSystem>(name, makeSolver(solver, iterations)), name);
+        }, py::arg("name"), py::arg("solver") = "pbd", py::arg("iterations") = 0, py::return_value_policy::reference_internal)
+        .def("get_system", py::overload_cast<const std::string_view&>(&World::getSystem), py::arg("name"),
+             py::return_value_policy::reference_internal)
+        .def("set_system_rate", &World::setSystemRate, py::arg("name"), py::arg("rate"))
+        .def("system_rate", &World::systemRate, py::arg("name"))
+        .def("system_time", &World::systemTime, py::arg("name"));
+}
+
+void bindFluid(py::module_& m)
+{
+    py::enum_<StableFluidSolver::AdvectionScheme>(m, "AdvectionScheme")
+        .value("SemiLagrangian", StableFluidSolver::AdvectionScheme::SemiLagrangian)
+        .value("MacCormack", StableFluidSolver::AdvectionScheme::MacCormack)
+        .value("BFECC", StableFluidSolver::AdvectionScheme::BFECC);
+
+    using SolverParams = StableFluidSolver::Params;
+    py::class_<SolverParams>(m, "StableFluidParams")
+        .def(py::init<>())
+        .def_readwrite("viscosity", &SolverParams::viscosity)
+        .def_readwrite("gravity", &SolverParams::gravity)
+        .def_readwrite("jacobi_iters", &SolverParams::jacobi_iters)
+        .def_readwrite("chebyshev", &SolverParams::chebyshev)
+        .def_readwrite("clamp_sides", &SolverParams::clamp_sides)
+        .def_readwrite("advect_dye", &SolverParams::advect_dye)
+        .def_readwrite("vorticity_eps", &SolverParams::vorticity_eps)
+        .def_readwrite("velocity_advection", &SolverParams::velocity_advection)
+        .def_readwrite("dye_advection", &SolverParams::dye_advection)
+        .def_readwrite("advection_limiter", &SolverParams::advection_limiter)
+        .def_readwrite("track_active_tiles", &SolverParams::track_active_tiles)
+        .def_readwrite("active_velocity_eps", &SolverParams::active_velocity_eps)
+        .def_readwrite("active_scalar_eps", &SolverParams::active_scalar_eps);
+
+    using Config = FluidSystem::Config;
+    py::class_<Config>(m, "FluidConfig")
+        .def(py::init<>())
+        .def_readwrite("nx", &Config::nx)
+        .def_readwrite("ny", &Config::ny)
+        .def_readwrite("nz", &Config::nz)
+        .def_readwrite("h", &Config::h)
+        .def_readwrite("origin", &Config::origin)
+        .def_readwrite("solver_params", &Config::solver_params);
+
+    using Kind = MacGrid::FieldKind;
+    py::class_<MacGrid>(m, "MacGrid")
+        .def(py::init<int, int, int, float, const vec3&>(), py::arg("nx"), py::arg("ny"), py::arg("nz"), py::arg("h"),
+             py::arg("origin") = vec3(0.0f))
+        .def_property_readonly("nx", &MacGrid::nx)
+        .def_property_readonly("ny", &MacGrid::ny)
+        .def_property_readonly("nz", &MacGrid::nz)
+        .def_property_readonly("h", &MacGrid::h)
+        .def_property_readonly("u", [](py::object self) { MacGrid& g = self.cast<MacGrid&>(); return fieldView(self, g, Kind::U, g.u()); })
+        .def_property_readonly("v", [](py::object self) { MacGrid& g = self.cast<MacGrid&>(); return fieldView(self, g, Kind::V, g.v()); })
+        .def_property_readonly("w", [](py::object self) { MacGrid& g = self.cast<MacGrid&>(); return fieldView(self, g, Kind::W, g.w()); })
+        .def_property_readonly("p", [](py::object self) { MacGrid& g = self.cast<MacGrid&>(); return fieldView(self, g, Kind::Center, g.p()); })
+        .def_property_readonly("div", [](py::object self) { MacGrid& g = self.cast<MacGrid&>(); return fieldView(self, g, Kind::Center, g.div()); })
+        .def_property_readonly("dye", [](py::object self) { MacGrid& g = self.cast<MacGrid&>(); return fieldView(self, g, Kind::Center, g.dye()); })
+        // 注册新通道会使之前取得的通道视图失效
+        .def("add_scalar_channel", &MacGrid::addScalarChannel, py::arg("name"), py::arg("init") = 0.0f)
+        .def("scalar_channel_id", &MacGrid::scalarChannelId, py::arg("name"))
+        .def_property_readonly("scalar_channel_count", &MacGrid::scalarChannelCount)
+        .def("scalar", [](py::object self, const std::string& name)
+        {
+            MacGrid&  g  = self.cast<MacGrid&>();
+            const int id = g.scalarChannelId(name);
+            if (id < 0) throw std::runtime_error("scalar channel '" + name + "' does not exist");
+            return fieldView(self, g, Kind::Center, g.scalar(id));
+        }, py::arg("name"));
+
+    py::class_<FluidSystem, ISystem>(m, "FluidSystem")
+        .def_property_readonly("grid", py::overload_cast<>(&FluidSystem::grid), py::return_value_policy::reference_internal);
+}
+
+void bindSpringMass(py::module_& m)
+{
+    py::class_<ParticleData>(m, "ParticleData")
+        .def("__len__", &ParticleData::size)
+        .def_property_readonly("position", [](py::object self) { return vecView(self, self.cast<ParticleData&>().position); })
+        .def_property_readonly("previous_position", [](py::object self) { return vecView(self, self.cast<ParticleData&>().previous_position); })
+        .def_property_readonly("velocity", [](py::object self) { return vecView(self, self.cast<ParticleData&>().velocity); })
+        .def_property_readonly("acceleration", [](py::object self) { return vecView(self, self.cast<ParticleData&>().acceleration); })
+        .def_property_readonly("force", [](py::object self) { return vecView(self, self.cast<ParticleData&>().force); })
+        .def_property_readonly("color", [](py::object self) { return vecView(self, self.cast<ParticleData&>().color); })
+        .def_property_readonly("mass", [](py::object self) { return scalarView(self, self.cast<ParticleData&>().mass); })
+        .def_property_readonly("inv_mass", [](py::object self) { return scalarView(self, self.cast<ParticleData&>().inv_mass); })
+        .def_property_readonly("density", [](py::object self) { return scalarView(self, self.cast<ParticleData&>().density); })
+        .def_property_readonly("pressure", [](py::object self) { return scalarView(self, self.cast<ParticleData&>().pressure); })
+        // std::vector<bool> 是按位打包的，没法给出视图，这两个是拷贝。
+        // 写 fixed 时同步 inv_mass：固定点为 0，解除固定的恢复为 1 / mass，与求解器里固定点的权重一致
+        .def_property("fixed", [](const ParticleData& d)
+        {
+            py::array_t<bool> out(static_cast<py::ssize_t>(d.size()));
+            auto              o = out.mutable_unchecked<1>();
+            for (size_t i = 0; i < d.size(); ++i) o(i) = d.is_fixed[i];
+            return out;
+        }, [](ParticleData& d, const py::array_t<bool, py::array::c_style | py::array::forcecast>& mask)
+        {
+            if (static_cast<size_t>(mask.size()) != d.size()) throw std::runtime_error("fixed mask size does not match particle count");
+            auto in = mask.unchecked<1>();
+            for (size_t i = 0; i < d.size(); ++i)
+            {
+                const bool fixed = in(i);
+                if (fixed) d.inv_mass[i] = 0.0f;
+                else if (d.is_fixed[i]) d.inv_mass[i] = 1.0f / d.mass[i];
+                d.is_fixed[i] = fixed;
+            }
+            d.markChanged();
+        })
+        .def_property_readonly("sleeping", [](const ParticleData& d)
+        {
+            py::array_t<bool> out(static_cast<py::ssize_t>(d.size()));
+            auto              o = out.mutable_unchecked<1>();
+            for (size_t i = 0; i < d.size(); ++i) o(i) = d.is_sleeping[i];
+            return out;
+        })
+        // 通过视图改了 mass / inv_mass 之后调用，让求解器丢掉按旧值建立的缓存（例如 PD 的矩阵分解）
+        .def("mark_changed", &ParticleData::markChanged);
+
+    py::class_<Spring>(m, "Springs")
+        .def("__len__", &Spring::size)
+        .def_property_readonly("index_a", [](py::object self)
+        {
+            auto& s = self.cast<Spring&>().index_a;
+            return view(self, s.data(), {static_cast<py::ssize_t>(s.size())});
+        })
+        .def_property_readonly("index_b", [](py::object self)
+        {
+            auto& s = self.cast<Spring&>().index_b;
+            return view(self, s.data(), {static_cast<py::ssize_t>(s.size())});
+        })
+        .def_property_readonly("stiffness", [](py::object self) { return scalarView(self, self.cast<Spring&>().stiffness); })
+        .def_property_readonly("rest_length", [](py::object self) { return scalarView(self, self.cast<Spring&>().rest_length); })
+        // 通过视图改了下标、刚度或自然长度之后调用
+        .def("mark_changed", &Spring::markChanged);
+
+    py::class_<TriangleTopology>(m, "Triangles")
+        .def("__len__", &TriangleTopology::size)
+        .def_property_readonly("indices", [](py::object self)
+        {
+            auto& t = self.cast<TriangleTopology&>();
+            return view(self, t.indices.data(), {static_cast<py::ssize_t>(t.size()), 3});
+        })
+        // 通过视图改了下标之后调用
+        .def("mark_changed", &TriangleTopology::markChanged);
+
+    py::class_<SpringMassSystem, ISystem>(m, "SpringMassSystem")
+        .def_property_readonly("particles", &SpringMassSystem::getParticles_mut, py::return_value_policy::reference_internal)
+        .def_property_readonly("springs", &SpringMassSystem::getTopology_mut, py::return_value_policy::reference_internal)
+        .def_property_readonly("triangles", &SpringMassSystem::getTriangles_mut, py::return_value_policy::reference_internal)
+        .def("add_gravity", [](SpringMassSystem& s, const vec3& g) { s.addForce(std::make_unique<GravityForce>(g)); },
+             py::arg("gravity") = vec3(0.0f, -9.8f, 0.0f))
+        .def("add_damping", [](SpringMassSystem& s, float c) { s.addForce(std::make_unique<DampingForce>(c)); }, py::arg("coefficient"))
+        // 显式积分器（euler / verlet）的弹簧力；pbd / implicit_euler / projective_dynamics 自己处理弹簧
+        .def("add_spring_force", [](SpringMassSystem& s) { s.addForce(std::make_unique<SpringForce>(s.getTopology_mut())); });
+
+    py::class_<ClothProperties>(m, "ClothProperties")
+        .def(py::init<>())
+        .def_readwrite("width_segments", &ClothProperties::width_segments)
+        .def_readwrite("height_segments", &ClothProperties::height_segments)
+        .def_readwrite("width", &ClothProperties::width)
+        .def_readwrite("height", &ClothProperties::height)
+        .def_readwrite("start_position", &ClothProperties::start_position)
+        .def_readwrite("stiffness_structural", &ClothProperties::stiffness_structural)
+        .def_readwrite("stiffness_shear", &ClothProperties::stiffness_shear)
+        .def_readwrite("stiffness_bend", &ClothProperties::stiffness_bend)
+        .def_readwrite("mass_per_particle", &ClothProperties::mass_per_particle)
+        .def_readwrite("pin_top_corners", &ClothProperties::pin_top_corners);
+
+    py::class_<RopeProperties>(m, "RopeProperties")
+        .def(py::init<>())
+        .def_readwrite("start_position", &RopeProperties::start_position)
+        .def_readwrite("end_position", &RopeProperties::end_position)
+        .def_readwrite("num_segments", &RopeProperties::num_segments)
+        .def_readwrite("stiffness", &RopeProperties::stiffness)
+        .def_readwrite("mass_per_particle", &RopeProperties::mass_per_particle)
+        .def_readwrite("pin_start", &RopeProperties::pin_start)
+        .def_readwrite("pin_end", &RopeProperties::pin_end);
+
+    m.def("create_cloth", &create_cloth, py::arg("system"), py::arg("props") = ClothProperties{});
+    m.def("create_rope", &create_rope, py::arg("system"), py::arg("props") = RopeProperties{});
+}
+
+void bindGridInit(py::module_& m)
+{
+    py::module_ g = m.def_submodule("gridinit", "Initial MacGrid scenes, positions in world coordinates");
+    g.def("clear_all", &gridinit::ClearAll, py::arg("grid"));
+    g.def("fill_dye_box", &gridinit::FillDyeBox_World, py::arg("grid"), py::arg("min"), py::arg("max"), py::arg("value"));
+    g.def("fill_dye_sphere", &gridinit::FillDyeSphere_World, py::arg("grid"), py::arg("center"), py::arg("radius"), py::arg("value"));
+    g.def("fill_dye_cylinder", &gridinit::FillDyeCylinder_World, py::arg("grid"), py::arg("base_center"), py::arg("radius"),
+          py::arg("y_min"), py::arg("y_max"), py::arg("value"));
+    g.def("set_velocity_box", &gridinit::SetVelocityBox_World, py::arg("grid"), py::arg("min"), py::arg("max"), py::arg("velocity"));
+    g.def("dam_break", &gridinit::Scene_DamBreak, py::arg("grid"), py::arg("fill_ratio_x") = 0.35f,
+          py::arg("fill_height_ratio") = 0.6f, py::arg("dye_value") = 1.0f);
+    g.def("falling_water_column", &gridinit::Scene_FallingWaterColumn, py::arg("grid"), py::arg("column_radius"),
+          py::arg("top_height_ratio"), py::arg("init_vy") = -3.0f, py::arg("dye_value") = 1.0f);
+    g.def("faucet_inflow_once", &gridinit::Scene_FaucetInflowOnce, py::arg("grid"), py::arg("hole_min"), py::arg("hole_max"),
+          py::arg("velocity"), py::arg("dye_value") = 1.0f);
+    g.def("shear_layer", &gridinit::Scene_ShearLayer, py::arg("grid"), py::arg("v_top") = 1.0f, py::arg("v_bottom") = -1.0f,
+          py::arg("transition_thickness") = 0.0f);
+    g.def("vortex_spin", &gridinit::Scene_VortexSpin, py::arg("grid"), py::arg("center"), py::arg("omega"), py::arg("max_radius"));
+    // 谓词每个采样点回调一次 Python，只适合小网格；大网格直接写 NumPy 视图
+    g.def("paint_velocity", &gridinit::PaintVelocityByPredicate, py::arg("grid"), py::arg("inside"), py::arg("velocity"));
+    g.def("paint_dye", &gridinit::PaintDyeByPredicate, py::arg("grid"), py::arg("inside"), py::arg("value"));
+}
+}
+}
+
+PYBIND11_MODULE(decker_physics, m)
+{
+    m.doc() = "Decker physics: World, FluidSystem/MacGrid, SpringMassSystem with zero-copy NumPy views";
+    dk::bindSystemTypes(m);
+    dk::bindFluid(m);
+    dk::bindSpringMass(m);
+    dk::bindWorld(m);
+    dk::bindGridInit(m);
+}
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <limits>
 
 #include "BVH/Frustum.hpp"
 #include "gpu/render graph/renderpass/DebugAabbPass.h"
@@ -9,6 +10,7 @@
 #include "gpu/render graph/renderpass/UiGizmoPass.h"
 #include "render graph/renderpass/OpaquePass.h"
 #include "render/RenderTypes.h"
+#include "resource/cpu/MeshLoader.h"
 #include "Vulkan/CommandBuffer.h"
 #include "Vulkan/Texture.h"
 
@@ -117,6 +119,23 @@ void RenderSystem::prepareFrame(const Scene& scene,
     _ui_gizmo_pass->setFrameData(&_frame_ctx, &_ui_render_service);
 }
 
+void RenderSystem::setFluidSurface(const MeshData& mesh)
+{
+    FluidRenderData data = _fluid_data.value_or(FluidRenderData{});
+    _retired_fluid_surfaces[_retired_fluid_head] = std::move(data.surface);
+    _retired_fluid_head = (_retired_fluid_head + 1) % _retired_fluid_surfaces.size();
+
+    data.surface = _gpu_cache->uploadMesh(mesh);
+    AABB bounds;
+    for (const auto& pos : mesh.positions)
+    {
+        bounds.expand(pos);
+    }
+    data.bounds_min = bounds.min;
+    data.bounds_max = bounds.max;
+    _fluid_data     = std::move(data);
+}
+
 void RenderSystem::execute(dk::RenderGraphContext& ctx)
 {
     if (!_graph_built)
@@ -328,6 +347,24 @@ void RenderSystem::buildDrawLists()
         _draw_lists.opaque.push_back(item);
     }
 
+    // 流体表面不是场景节点，直接作为一个不透明绘制项，用默认材质
+    if (_fluid_data && _fluid_data->surface)
+    {
+        AABB bounds;
+        bounds.expand(_fluid_data->bounds_min);
+        bounds.expand(_fluid_data->bounds_max);
+        if (frustum.contains(bounds))
+        {
+            DrawItem item{};
+            item.proxy_index = std::numeric_limits<uint32_t>::max(); // 不对应任何 RenderProxy
+            item.mesh        = _fluid_data->surface;
+            item.material    = _gpu_cache->getDefaultMaterial();
+            const glm::vec4 view_pos = _frame_ctx.view * glm::vec4(bounds.center(), 1.0f);
+            item.depth = view_pos.z;
+            _draw_lists.opaque.push_back(item);
+        }
+    }
+
     // 关键入口：RenderSystem 根据选中节点筛选描边绘制列表。
     if (const auto selected_index = _render_world.findProxyIndex(_selected_node_id))
     {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <memory>
 #include <optional>
 
@@ -23,6 +24,10 @@ namespace dk {
 class RenderGraph;
 }
 
+namespace dk {
+struct MeshData;
+}
+
 namespace dk::render {
 class OpaquePass;
 class DebugAabbPass;
@@ -51,6 +56,8 @@ public:
     void execute(dk::RenderGraphContext& ctx);
 
     void setFluidData(const FluidRenderData& data) { _fluid_data = data; }
+    // 上传新提取的流体表面并替换上一份（每帧最多调用一次）；网格为空时隐藏表面
+    void setFluidSurface(const MeshData& mesh);
     void setVoxelData(const VoxelRenderData& data) { _voxel_data = data; }
     void setDebugDrawAabb(bool enabled) { _debug_draw_aabb = enabled; }
     void setSelectedNodeId(const UUID& id) { _selected_node_id = id; }
@@ -88,6 +95,9 @@ private:
     RGResource<ImageDesc, FrameGraphImage>* _rg_color{nullptr};
     RGResource<ImageDesc, FrameGraphImage>* _rg_depth{nullptr};
     std::optional<FluidRenderData>       _fluid_data;
+    // 被替换的表面可能还被在途的帧引用，留两份再释放
+    std::array<std::shared_ptr<GPUMesh>, 2> _retired_fluid_surfaces{};
+    size_t                               _retired_fluid_head{0};
     std::optional<VoxelRenderData>       _voxel_data;
     bool                                 _debug_draw_aabb{false};
     UUID                                 _selected_node_id{};
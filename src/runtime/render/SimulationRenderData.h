@@ -1,13 +1,19 @@
 #pragma once
 
+#include <memory>
+
 #include <glm/vec3.hpp>
 
+#include "resource/gpu/GPUMesh.h"
+
 namespace dk::render {
 struct FluidRenderData
 {
     // TODO: 接入 GPU 纹理/缓冲区句柄（密度/速度场、粒子数据）
     glm::vec3 bounds_min{0.0f};
     glm::vec3 bounds_max{0.0f};
+    // 染料等值面（世界坐标），按不透明网格绘制；为空时不画
+    std::shared_ptr<GPUMesh> surface{};
 };
 
 struct VoxelRenderData
@@ -154,4 +154,11 @@ ResourceLoader::ResourceLoader(const std::string& rawDir, AssetDB& db, ResourceC
     registerLoader<TextureData, TextureResourceLoader>(AssetType::Image, "Image", _dir, _db);
     registerLoader<MaterialData, MaterialResourceLoader>(AssetType::Material, "Material", _dir, _db, *this);
 }
+
+std::filesystem::path ResourceLoader::rawPath(UUID id) const
+{
+    auto meta = _db.get(id);
+    if (!meta) return {};
+    return _dir / meta->raw_path;
+}
 } // namespace dk
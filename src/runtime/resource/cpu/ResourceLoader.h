@@ -38,6 +38,9 @@ public:
     template <typename Res>
     std::vector<std::shared_ptr<Res>> loadBatch(const std::vector<UUID>& ids);
 
+    // 资产 raw 文件的完整路径（找不到时为空）；派生数据（如网格的 SDF 缓存）放在它旁边
+    std::filesystem::path rawPath(UUID id) const;
+
 private:
     struct RegisteredType
     {
@@ -113,6 +113,15 @@ std::shared_ptr<GPUMesh> GpuResourceManager::uploadMeshData(const MeshData& mesh
     return gpu_mesh;
 }
 
+std::shared_ptr<GPUMesh> GpuResourceManager::uploadMesh(const MeshData& mesh)
+{
+    if (mesh.vertex_count == 0 || mesh.index_count == 0)
+    {
+        return {};
+    }
+    return uploadMeshData(mesh);
+}
+
 std::shared_ptr<GPUTexture> GpuResourceManager::getDefaultWhiteTexture()
 {
     if (_default_white_texture)
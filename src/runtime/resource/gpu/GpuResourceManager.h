@@ -30,6 +30,8 @@ public:
     std::shared_ptr<GPUMesh>     loadMesh(UUID id);
     std::shared_ptr<GPUTexture>  loadTexture(UUID id);
     std::shared_ptr<GPUMaterial> loadMaterial(UUID id);
+    // 运行时生成的网格（流体等值面等）：不进缓存，直接上传；空网格返回 nullptr
+    std::shared_ptr<GPUMesh>     uploadMesh(const MeshData& mesh);
 
 private:
     std::shared_ptr<GPUMesh> uploadMeshData(const MeshData& mesh);
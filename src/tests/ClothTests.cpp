@@ -0,0 +1,84 @@
+// tests/ClothTests.cpp
+// 布料三角形级自碰撞（CCD）
+#include <algorithm>
+
+#include "physics/solver/PBDSolver.h"
+#include "tests/TestCommon.h"
+
+namespace {
+// 规则网格片：nx × nz 个格子，每格两个三角形
+void addSheet(dk::ParticleData& data, dk::TriangleTopology& tris, glm::vec3 origin, float cell, int nx, int nz, bool fixed)
+{
+    const size_t base = data.size();
+    for (int z = 0; z <= nz; ++z)
+        for (int x = 0; x <= nx; ++x) data.addParticle(origin + glm::vec3(x * cell, 0.0f, z * cell), 0.1f, fixed);
+    const auto id = [&](int x, int z) { return base + static_cast<size_t>(z * (nx + 1) + x); };
+    for (int z = 0; z < nz; ++z)
+        for (int x = 0; x < nx; ++x)
+        {
+            tris.addTriangle(id(x, z), id(x + 1, z), id(x, z + 1));
+            tris.addTriangle(id(x + 1, z), id(x + 1, z + 1), id(x, z + 1));
+        }
+}
+
+void testClothSelfCollision(TestContext& t)
+{
+    const float thickness = 0.01f;
+
+    // 顶点一个子步内整个穿过固定三角形：CCD 发现并把它留在起点一侧
+    {
+        dk::ParticleData     data;
+        dk::Spring           springs;
+        dk::TriangleTopology tris;
+        tris.addTriangle(data.addParticle(glm::vec3(0, 0, 0), 1.0f, true), data.addParticle(glm::vec3(1, 0, 0), 1.0f, true),
+                         data.addParticle(glm::vec3(0, 0, 1), 1.0f, true));
+        // 穿过去的是另一片小三角形，三个顶点都落在固定三角形内部
+        const size_t v = data.addParticle(glm::vec3(0.2f, 0.05f, 0.2f), 1.0f);
+        tris.addTriangle(v, data.addParticle(glm::vec3(0.3f, 0.05f, 0.2f), 1.0f), data.addParticle(glm::vec3(0.2f, 0.05f, 0.3f), 1.0f));
+        for (size_t i = v; i < data.size(); ++i) data.velocity[i] = glm::vec3(0.0f, -10.0f, 0.0f);
+
+        dk::ParticleSystemState state(data, springs, &tris);
+        dk::PBDSolver           solver;
+        solver.setSelfCollisionParams({thickness});
+        solver.solve(state, 0.02f);
+        bool above = true;
+        for (size_t i = v; i < data.size(); ++i) above = above && data.position[i].y > thickness - 1e-4f;
+        t.expect(solver.selfCollision().vertexTriangleCount() == 3 && above, "vertex tunnelling through a triangle is caught by CCD");
+    }
+
+    // 一小片布以大步长落向固定的大片布：顶点-三角形与边-边约束都不让它穿过
+    {
+        dk::ParticleData     data;
+        dk::Spring           springs;
+        dk::TriangleTopology tris;
+        addSheet(data, tris, glm::vec3(-0.5f, 0.0f, -0.5f), 0.5f, 4, 4, true);
+        const size_t first = data.size();
+        addSheet(data, tris, glm::vec3(0.013f, 0.05f, 0.021f), 0.037f, 8, 8, false);
+        for (size_t i = first; i < data.size(); ++i)
+        {
+            data.velocity[i] = glm::vec3(0.3f, -3.0f, 0.2f);
+            data.force[i]    = glm::vec3(0.0f, -9.8f, 0.0f) * data.mass[i];
+        }
+
+        dk::ParticleSystemState state(data, springs, &tris);
+        dk::PBDSolver           solver;
+        solver.setSelfCollisionParams({thickness});
+        bool   above = true;
+        size_t pairs = 0;
+        for (int step = 0; step < 30; ++step)
+        {
+            solver.solve(state, 0.01f);
+            pairs = std::max(pairs, solver.selfCollision().vertexTriangleCount() + solver.selfCollision().edgeEdgeCount());
+            for (size_t i = first; i < data.size(); ++i) above = above && data.position[i].y > 0.0f;
+        }
+        t.expect(above && pairs > 0, "falling cloth does not pass through a pinned cloth");
+    }
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testClothSelfCollision(t);
+    return t.finish();
+}
@@ -0,0 +1,277 @@
+// tests/CollisionTests.cpp
+// 碰撞体：批量碰撞核、BVH 宽相位和网格 SDF 碰撞体
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "physics/collider/AABBCollider.h"
+#include "physics/collider/CollisionPipeline.h"
+#include "physics/collider/PlaneCollider.h"
+#include "physics/collider/SdfCollider.h"
+#include "physics/collider/SphereCollider.h"
+#include "tests/TestCommon.h"
+
+namespace {
+// 只实现逐粒子接口的碰撞体，走 ICollider::testBatch 的默认实现
+class SlabCollider : public dk::ICollider
+{
+public:
+    dk::CollisionInfo testCollision(const glm::vec3& p, float r) const override
+    {
+        dk::CollisionInfo info;
+        if (std::fabs(p.x) < 0.25f + r)
+        {
+            info.hasCollided      = true;
+            info.normal           = glm::vec3(p.x >= 0.0f ? 1.0f : -1.0f, 0.0f, 0.0f);
+            info.penetrationDepth = 0.25f + r - std::fabs(p.x);
+        }
+        return info;
+    }
+    dk::AABB bounds() const override { return dk::AABB{glm::vec3(-0.25f, -1e3f, -1e3f), glm::vec3(0.25f, 1e3f, 1e3f)}; }
+};
+
+void testColliderBatchKernels(TestContext& t)
+{
+    std::mt19937                          rng(11);
+    std::uniform_real_distribution<float> uni(-1.0f, 1.0f);
+
+    const dk::PlaneCollider  plane(glm::vec3(0.3f, 1.0f, -0.2f), 0.1f);
+    const dk::AABBCollider   box(glm::vec3(-0.4f, -0.3f, -0.5f), glm::vec3(0.5f, 0.2f, 0.3f));
+    const dk::SphereCollider sphere(glm::vec3(0.1f, -0.2f, 0.05f), 0.45f);
+    const SlabCollider       slab;
+
+    // 随机点之外加上盒面上、球心上这些边界情况
+    dk::ParticleBatch batch;
+    for (int k = 0; k < dk::ParticleBatch::kCapacity; ++k) batch.setPosition(k, glm::vec3(uni(rng), uni(rng), uni(rng)));
+    batch.setPosition(0, glm::vec3(0.1f, -0.2f, 0.05f));
+    batch.setPosition(1, glm::vec3(0.5f, 0.0f, 0.0f));
+    batch.setPosition(2, glm::vec3(0.0f, -0.3f, 0.3f));
+    batch.count = 61;
+
+    for (const float radius : {0.0f, 0.05f})
+    {
+        bool same = true;
+        for (const dk::ICollider* c : std::initializer_list<const dk::ICollider*>{&plane, &box, &sphere, &slab})
+        {
+            dk::ContactList contacts;
+            c->testBatch(batch, radius, contacts);
+            int next = 0;
+            for (int k = 0; k < batch.count; ++k)
+            {
+                const dk::CollisionInfo info = c->testCollision(batch.position(k), radius);
+                if (!info.hasCollided) continue;
+                same = same && next < contacts.count && contacts.lane[next] == k && contacts.normal(next) == info.normal
+                       && contacts.depth[next] == info.penetrationDepth;
+                ++next;
+            }
+            same = same && next == contacts.count;
+        }
+        t.expect(same, radius == 0.0f ? "batched collider kernels match per-particle tests"
+                                      : "batched collider kernels match per-particle tests with particle radius");
+    }
+}
+
+void testColliderBroadphase(TestContext& t)
+{
+    std::mt19937                          rng(7);
+    std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+
+    // BVH 查询与暴力求交一致，refit 之后也一致
+    {
+        std::vector<dk::AABB> boxes(500);
+        auto                  scatter = [&]
+        {
+            for (auto& b : boxes)
+            {
+                b.min = glm::vec3(uni(rng), uni(rng), uni(rng)) * 10.0f;
+                b.max = b.min + glm::vec3(uni(rng), uni(rng), uni(rng));
+            }
+        };
+        scatter();
+        dk::BVH bvh;
+        bvh.build(boxes);
+
+        auto matches = [&]
+        {
+            for (int q = 0; q < 200; ++q)
+            {
+                dk::AABB query;
+                query.min = glm::vec3(uni(rng), uni(rng), uni(rng)) * 10.0f;
+                query.max = query.min + glm::vec3(1.5f);
+                std::vector<int> hit, expect;
+                bvh.query(query, [&](int i) { hit.push_back(i); });
+                for (int i = 0; i < static_cast<int>(boxes.size()); ++i)
+                    if (dk::overlap_aabbs(query, boxes[i])) expect.push_back(i);
+                std::sort(hit.begin(), hit.end());
+                if (hit != expect) return false;
+            }
+            return true;
+        };
+        const bool built = matches();
+        scatter();
+        bvh.refit(boxes);
+        t.expect(built && matches(), "BVH query matches brute force after build and refit");
+    }
+
+    // 数百个盒子加一个地面：流水线与逐对暴力求交结果逐位相同，且没有粒子留在碰撞体内
+    {
+        std::vector<std::unique_ptr<dk::ICollider>> owned;
+        std::vector<const dk::ICollider*>           colliders;
+        owned.push_back(std::make_unique<dk::PlaneCollider>(glm::vec3(0, 1, 0), 0.0f));
+        for (int k = 0; k < 8; ++k)
+            for (int j = 0; j < 5; ++j)
+                for (int i = 0; i < 8; ++i)
+                {
+                    const glm::vec3 lo(i * 1.0f, 0.5f + j * 1.0f, k * 1.0f);
+                    owned.push_back(std::make_unique<dk::AABBCollider>(lo, lo + glm::vec3(0.6f)));
+                }
+        for (int k = 0; k < 8; ++k)
+            for (int i = 0; i < 8; ++i) owned.push_back(std::make_unique<dk::SphereCollider>(glm::vec3(i + 0.5f, 5.8f, k + 0.5f), 0.3f));
+        for (const auto& c : owned) colliders.push_back(c.get());
+
+        dk::ParticleData data;
+        for (int n = 0; n < 20000; ++n)
+        {
+            const size_t p = data.addParticle(glm::vec3(uni(rng) * 8.0f, uni(rng) * 6.0f - 0.3f, uni(rng) * 8.0f), 1.0f, n % 97 == 0);
+            data.velocity[p] = glm::vec3(uni(rng), uni(rng), uni(rng)) - 0.5f;
+        }
+        dk::ParticleData reference = data;
+
+        const float            radius = 0.02f;
+        dk::CollisionPipeline  pipeline;
+        pipeline.setColliders(colliders);
+        pipeline.collide(data, radius);
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            if (reference.is_fixed[i]) continue;
+            for (const dk::ICollider* c : colliders)
+            {
+                const dk::CollisionInfo info = c->testCollision(reference.position[i], radius);
+                if (info.hasCollided) dk::CollisionPipeline::resolveCollision(reference, i, info);
+            }
+        }
+
+        bool same = true, outside = true;
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            same = same && data.position[i] == reference.position[i] && data.velocity[i] == reference.velocity[i];
+            if (data.is_fixed[i]) continue;
+            for (const dk::ICollider* c : colliders)
+            {
+                const dk::CollisionInfo info = c->testCollision(data.position[i], radius);
+                outside = outside && (!info.hasCollided || info.penetrationDepth < 1e-5f);
+            }
+        }
+        t.expect(pipeline.colliderCount() == colliders.size() && same, "collision pipeline matches brute-force collider loop");
+        t.expect(outside, "collision pipeline pushes particles out of colliders");
+    }
+}
+
+// 外法向的 UV 球面，成员名与 MeshData 相同
+struct SphereMesh
+{
+    std::vector<glm::vec3>     positions;
+    std::vector<std::uint32_t> indices;
+};
+
+SphereMesh makeSphereMesh(float radius, int rings, int segments)
+{
+    SphereMesh m;
+    m.positions.push_back(glm::vec3(0, radius, 0));
+    for (int r = 1; r < rings; ++r)
+    {
+        const float theta = 3.14159265f * r / rings;
+        for (int s = 0; s < segments; ++s)
+        {
+            const float phi = 2.0f * 3.14159265f * s / segments;
+            m.positions.push_back(radius * glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    m.positions.push_back(glm::vec3(0, -radius, 0));
+    const auto ring   = [&](int r, int s) { return static_cast<std::uint32_t>(1 + (r - 1) * segments + (s % segments)); };
+    const auto bottom = static_cast<std::uint32_t>(m.positions.size() - 1);
+    for (int s = 0; s < segments; ++s)
+    {
+        m.indices.insert(m.indices.end(), {0u, ring(1, s + 1), ring(1, s)});
+        for (int r = 1; r < rings - 1; ++r)
+        {
+            m.indices.insert(m.indices.end(), {ring(r, s), ring(r, s + 1), ring(r + 1, s)});
+            m.indices.insert(m.indices.end(), {ring(r, s + 1), ring(r + 1, s + 1), ring(r + 1, s)});
+        }
+        m.indices.insert(m.indices.end(), {bottom, ring(rings - 1, s), ring(rings - 1, s + 1)});
+    }
+    return m;
+}
+
+void testSdfCollider(TestContext& t)
+{
+    const float      R    = 0.3f;
+    const SphereMesh mesh = makeSphereMesh(R, 48, 96);
+    dk::SdfParams    params;
+    params.h    = 0.02f;
+    params.band = 4;
+
+    const std::filesystem::path raw = std::filesystem::temp_directory_path() / "dk_sdf_test.rawmesh";
+    std::filesystem::remove(std::filesystem::path(raw).concat(".sdf"));
+
+    bool cached = true;
+    auto sdf    = dk::loadOrBuildMeshSdf(mesh, raw, params, &cached);
+
+    // 窄带内与解析距离一致，带外被截断，内外符号正确
+    float err = 0.0f;
+    bool  clamped = true;
+    for (int k = 0; k < sdf->dims.z; ++k)
+        for (int j = 0; j < sdf->dims.y; ++j)
+            for (int i = 0; i < sdf->dims.x; ++i)
+            {
+                const glm::vec3 p     = sdf->origin + glm::vec3(i, j, k) * sdf->h;
+                const float     exact = glm::length(p) - R;
+                const float     phi   = sdf->at(i, j, k);
+                if (std::fabs(exact) < sdf->band - sdf->h) err = std::max(err, std::fabs(phi - exact));
+                if (std::fabs(exact) > sdf->band + sdf->h) clamped = clamped && phi == (exact < 0.0f ? -sdf->band : sdf->band);
+            }
+    t.expect(!cached && err < 2e-3f && clamped, "SDF built from a mesh matches the analytic distance in the band");
+
+    // 碰撞：球内的粒子沿径向推到表面
+    dk::SdfCollider         collider(sdf, glm::vec3(1.0f, 0.0f, 0.0f));
+    const dk::CollisionInfo hit  = collider.testCollision(glm::vec3(1.0f, 0.26f, 0.0f), 0.01f);
+    const dk::CollisionInfo miss = collider.testCollision(glm::vec3(1.0f, 0.35f, 0.0f), 0.01f);
+    t.expect(hit.hasCollided && nearlyEqual(hit.penetrationDepth, 0.05f, 3e-3f) && hit.normal.y > 0.99f && !miss.hasCollided
+                 && collider.bounded(),
+             "SDF collider pushes particles out along the gradient");
+
+    // 带旋转和等比缩放的变换：查询时变回局部空间，距离和法线换算回世界
+    const glm::mat4 transform = glm::scale(glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 1.0f, 0.0f)),
+                                                       glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f)),
+                                           glm::vec3(2.0f));
+    dk::SdfCollider         placed(sdf, transform);
+    const dk::CollisionInfo side = placed.testCollision(glm::vec3(0.5f, 1.0f, 0.0f), 0.01f);
+    const dk::AABB          box  = placed.bounds();
+    t.expect(side.hasCollided && nearlyEqual(side.penetrationDepth, 0.11f, 6e-3f) && side.normal.x > 0.99f
+                 && box.min.y < 1.0f - 2.0f * R && box.max.y > 1.0f + 2.0f * R,
+             "SDF collider applies a rotated, scaled transform at query time");
+
+    // 缓存：第二次直接读盘；参数变了重新构建
+    bool again = false, rebuilt = true;
+    auto sdf2  = dk::loadOrBuildMeshSdf(mesh, raw, params, &again);
+    params.band = 3;
+    auto sdf3   = dk::loadOrBuildMeshSdf(mesh, raw, params, &rebuilt);
+    t.expect(again && sdf2->phi == sdf->phi && sdf2->dims == sdf->dims && !rebuilt && sdf3->band < sdf->band,
+             "SDF is cached next to the raw mesh and rebuilt when stale");
+    std::filesystem::remove(std::filesystem::path(raw).concat(".sdf"));
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testColliderBroadphase(t);
+    testColliderBatchKernels(t);
+    testSdfCollider(t);
+    return t.finish();
+}
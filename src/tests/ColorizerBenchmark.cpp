@@ -0,0 +1,77 @@
+// tests/ColorizerBenchmark.cpp
+// 1M 质点着色的计时：按块并行的着色核（单遍带滞回 / 两遍精确范围）对比同样算术的串行循环，
+// 以及"1M 质点 < 1 ms"的目标。只打印数字，不做断言（挂钟时间随机器和负载变化，不适合放进测试）。
+// 用法：DeckerColorizerBenchmark [质点数] [重复次数]
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "physics/Parallel.h"
+#include "physics/color/UniformColorizer.h"
+
+namespace {
+constexpr double kTargetMs = 1.0; // 1M 质点的目标
+
+// 重复 runs 次取最快的一次（毫秒）
+template <class Fn>
+double fastest(int runs, Fn&& fn)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int k = 0; k < runs; ++k)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+void report(const char* name, double ms, size_t count, double serial_ms)
+{
+    const double target = kTargetMs * static_cast<double>(count) / static_cast<double>(1 << 20);
+    fmt::print("{:<28} {:8.3f} ms  {:6.2f}x serial  {:6.2f}x target ({:.3f} ms)\n", name, ms, ms / serial_ms, ms / target, target);
+}
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 20;
+    const int    runs  = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    dk::ParticleData data;
+    data.addParticles(count, 1.0f);
+    for (size_t i = 0; i < data.size(); ++i) data.velocity[i] = glm::vec3(0.0f, static_cast<float>(i % 1000) * 1e-3f, 0.0f);
+
+    dk::VelocityColorizer fused(glm::vec4(0, 0, 1, 1), glm::vec4(1, 0, 0, 1), 0.1f);
+    dk::VelocityColorizer exact;
+    fused.colorize(data); // 第一遍先归约出范围，之后才是单遍
+    exact.colorize(data);
+
+    const double fused_ms = fastest(runs, [&] { fused.colorize(data); });
+    const double exact_ms = fastest(runs, [&] { exact.colorize(data); });
+
+    volatile float sink      = 0.0f; // 让串行循环的归约不被优化掉
+    const double   serial_ms = fastest(runs, [&]
+    {
+        const float lo = fused.rangeMin(), inv = 1.0f / (fused.rangeMax() - fused.rangeMin());
+        float       mn = std::numeric_limits<float>::max(), mx = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            const float s = glm::length(data.velocity[i]);
+            mn            = std::min(mn, s);
+            mx            = std::max(mx, s);
+            data.color[i] = glm::mix(glm::vec4(0, 0, 1, 1), glm::vec4(1, 0, 0, 1), std::clamp((s - lo) * inv, 0.0f, 1.0f));
+        }
+        sink = mn + mx;
+    });
+
+    fmt::print("{} particles, {} threads, fastest of {} runs\n", count, dk::SlabPool::instance().threadCount(), runs);
+    report("serial loop", serial_ms, count, serial_ms);
+    report("fused (hysteresis 0.1)", fused_ms, count, serial_ms);
+    report("two-pass (exact range)", exact_ms, count, serial_ms);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// tests/ColorizerTests.cpp
+// 按块并行的着色器
+#include <algorithm>
+#include <vector>
+
+#include "physics/color/FixedColorizer.h"
+#include "physics/color/UniformColorizer.h"
+#include "tests/TestCommon.h"
+
+namespace {
+void testFusedColorizer(TestContext& t)
+{
+    dk::ParticleData data;
+    for (int i = 0; i < 5000; ++i)
+    {
+        data.addParticle(glm::vec3(static_cast<float>(i), 0.0f, 0.0f), 1.0f);
+        data.velocity.back() = glm::vec3(0.0f, 0.01f * static_cast<float>(i % 97), 0.0f);
+        data.density.back()  = static_cast<float>(i);
+    }
+
+    // 精确范围：两端正好落在梯度两端；按步长直接写进渲染点的颜色与 colorize 写回的一致
+    dk::VelocityColorizer exact(glm::vec4(0, 0, 1, 1), glm::vec4(1, 0, 0, 1), 0.0f);
+    std::vector<dk::PointData> points(data.size());
+    exact.run(data, data.size(), {&points[0].color, sizeof(dk::PointData) / sizeof(glm::vec4)});
+    exact.colorize(data);
+    bool strided = true;
+    for (size_t i = 0; i < data.size(); ++i) strided = strided && points[i].color == data.color[i];
+    t.expect(strided && data.color[0] == glm::vec4(0, 0, 1, 1) && data.color[96] == glm::vec4(1, 0, 0, 1),
+             "velocity colorizer spans the gradient and strided run() matches colorize()");
+
+    // 滞回：范围只在越界时扩张，小幅收缩保持不变，大幅收缩才跟上
+    dk::VelocityColorizer smooth(glm::vec4(0, 0, 1, 1), glm::vec4(1, 0, 0, 1), 0.1f);
+    smooth.colorize(data);
+    const float hi0 = smooth.rangeMax();
+    for (auto& v : data.velocity) v *= 0.95f;
+    smooth.colorize(data);
+    const bool kept = smooth.rangeMax() == hi0;
+    for (auto& v : data.velocity) v *= 2.0f;
+    smooth.colorize(data);
+    const bool grew = smooth.rangeMax() > hi0;
+    for (auto& v : data.velocity) v *= 0.1f;
+    smooth.colorize(data);
+    const bool shrank = smooth.rangeMax() < 0.2f * hi0;
+    t.expect(kept && grew && shrank, "velocity colorizer range follows with hysteresis");
+
+    dk::DensityColorizer density;
+    density.colorize(data);
+    dk::FixedMaskColorizer mask(glm::vec4(0, 1, 0, 1), glm::vec4(1, 0, 0, 1));
+    data.is_fixed[7] = true;
+    std::vector<glm::vec4> masked(data.size());
+    mask.run(data, data.size(), {masked.data()});
+    t.expect(data.color.front() == glm::vec4(0, 0, 1, 1) && data.color.back() == glm::vec4(1, 0, 0, 1) && masked[7] == glm::vec4(1, 0, 0, 1)
+             && masked[8] == glm::vec4(0, 1, 0, 1), "density and fixed-mask colorizers share the scalar kernel");
+
+    dk::FixedColorizer fixed(glm::vec4(0.5f));
+    fixed.colorize(data);
+    t.expect(std::all_of(data.color.begin(), data.color.end(), [](const glm::vec4& c) { return c == glm::vec4(0.5f); }),
+             "fixed colorizer fills every particle");
+
+    // 1M 质点：带滞回的单遍着色与同样算术的串行循环逐位一致（计时见 ColorizerBenchmark）
+    dk::ParticleData big;
+    big.addParticles(1 << 20, 1.0f);
+    for (size_t i = 0; i < big.size(); ++i) big.velocity[i] = glm::vec3(0.0f, static_cast<float>(i % 1000) * 1e-3f, 0.0f);
+    dk::VelocityColorizer speed(glm::vec4(0, 0, 1, 1), glm::vec4(1, 0, 0, 1), 0.1f);
+    speed.colorize(big);
+    const float lo = speed.rangeMin(), inv = 1.0f / (speed.rangeMax() - speed.rangeMin());
+    speed.colorize(big);
+    bool same = true;
+    for (size_t i = 0; i < big.size(); ++i)
+    {
+        const float s = glm::length(big.velocity[i]);
+        same = same && big.color[i] == glm::mix(glm::vec4(0, 0, 1, 1), glm::vec4(1, 0, 0, 1), std::clamp((s - lo) * inv, 0.0f, 1.0f));
+    }
+    t.expect(same, "block-parallel fused colorizer matches a serial loop bit for bit");
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testFusedColorizer(t);
+    return t.finish();
+}
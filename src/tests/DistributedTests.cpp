@@ -0,0 +1,216 @@
+// tests/DistributedTests.cpp
+// MacGrid 分块与 halo 交换：进程内多 rank 和两个进程经 LocalSocketTransport 的结果都要与单进程逐位相同
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "physics/data/MacGrid.h"
+#include "physics/distributed/HaloExchange.h"
+#include "physics/solver/StableFliuidsSolver.h"
+#include "tests/TestCommon.h"
+
+namespace {
+// 填一份确定性的初始场（按全局下标，分块与整块得到同样的值）
+void seedGrid(dk::MacGrid& g)
+{
+    for (size_t n = 0; n < g.u().size(); ++n) g.u()[n] = 0.8f * std::sin(0.37f * static_cast<float>(n));
+    for (size_t n = 0; n < g.v().size(); ++n) g.v()[n] = 0.5f * std::cos(0.21f * static_cast<float>(n));
+    for (size_t n = 0; n < g.w().size(); ++n) g.w()[n] = g.nz() > 1 ? 0.3f * std::sin(0.13f * static_cast<float>(n)) : 0.0f;
+    for (size_t n = 0; n < g.dye().size(); ++n)
+    {
+        g.dye()[n]       = static_cast<float>(n % 7) / 7.0f;
+        g.scalar(0)[n] = static_cast<float>(n % 3);
+    }
+}
+
+// 分块测试共用的求解参数
+dk::StableFluidSolver::Params decomposedParams()
+{
+    dk::StableFluidSolver::Params params;
+    params.velocity_advection = dk::StableFluidSolver::AdvectionScheme::MacCormack;
+    params.dye_advection      = dk::StableFluidSolver::AdvectionScheme::BFECC;
+    params.viscosity          = 0.01f;
+    params.jacobi_iters       = 20;
+    return params;
+}
+
+constexpr float kDecomposedH     = 0.1f;
+constexpr float kDecomposedDt    = 0.02f;
+constexpr int   kDecomposedSteps = 3;
+
+dk::MacGrid seededGrid(int nx, int ny, int nz)
+{
+    dk::MacGrid g(nx, ny, nz, kDecomposedH);
+    g.addScalarChannel("temperature");
+    seedGrid(g);
+    return g;
+}
+
+dk::SlabDecomposition makeDecomposition(int nx, int ny, int nz, int ranks)
+{
+    dk::SlabDecomposition decomp;
+    decomp.global_dims = glm::ivec3(nx, ny, nz);
+    decomp.ranks       = ranks;
+    decomp.halo        = 4;
+    return decomp;
+}
+
+// 一个 rank 的完整流程：rank 0 提供初值并收集结果，其它 rank 两者都传 nullptr
+void runDecomposedRank(const dk::SlabDecomposition& decomp, dk::IHaloTransport& transport, const dk::MacGrid* initial,
+                       dk::MacGrid* gathered)
+{
+    dk::HaloExchange halo(decomp, transport);
+    dk::MacGrid      local = decomp.makeLocalGrid(transport.rank(), kDecomposedH);
+    local.addScalarChannel("temperature");
+    halo.scatter(initial, local);
+
+    dk::StableFluidSolver solver(decomposedParams());
+    solver.setHaloExchange(&halo);
+    for (int s = 0; s < kDecomposedSteps; ++s) solver.solve(local, kDecomposedDt);
+    halo.gather(local, gathered);
+}
+
+bool sameFields(const dk::MacGrid& a, const dk::MacGrid& b)
+{
+    return bitwiseEqual(a.u(), b.u()) && bitwiseEqual(a.v(), b.v()) && (a.nz() == 1 || bitwiseEqual(a.w(), b.w()))
+           && bitwiseEqual(a.p(), b.p()) && bitwiseEqual(a.dye(), b.dye()) && bitwiseEqual(a.scalar(0), b.scalar(0));
+}
+
+dk::MacGrid singleProcessResult(int nx, int ny, int nz)
+{
+    dk::MacGrid           single = seededGrid(nx, ny, nz);
+    dk::StableFluidSolver solver(decomposedParams());
+    for (int s = 0; s < kDecomposedSteps; ++s) solver.solve(single, kDecomposedDt);
+    return single;
+}
+
+// 整块跑一遍，再按 ranks 切块、每块一个线程跑一遍，汇总后逐位比较
+bool decomposedMatchesSingle(int nx, int ny, int nz, int ranks)
+{
+    const dk::MacGrid           single  = singleProcessResult(nx, ny, nz);
+    const dk::MacGrid           initial = seededGrid(nx, ny, nz);
+    const dk::SlabDecomposition decomp  = makeDecomposition(nx, ny, nz, ranks);
+
+    dk::InProcessHaloHub     hub(ranks);
+    dk::MacGrid              gathered = seededGrid(nx, ny, nz);
+    std::vector<std::thread> workers;
+    for (int r = 0; r < ranks; ++r)
+    {
+        workers.emplace_back([&, r]
+        {
+            auto transport = hub.transport(r);
+            runDecomposedRank(decomp, *transport, r == 0 ? &initial : nullptr, r == 0 ? &gathered : nullptr);
+        });
+    }
+    for (auto& w : workers) w.join();
+    return sameFields(single, gathered);
+}
+
+void testDomainDecompositionMatchesSingleProcess(TestContext& t)
+{
+    t.expect(decomposedMatchesSingle(10, 8, 18, 3), "Slab-decomposed 3D run is bit-identical to single process");
+    t.expect(decomposedMatchesSingle(12, 20, 1, 2), "Slab-decomposed 2D run is bit-identical to single process");
+
+    // 切分轴上的速度让回溯超出 halo - 2 个 cell 时，两块都拒绝对流
+    const dk::SlabDecomposition decomp = makeDecomposition(8, 8, 16, 2);
+    dk::InProcessHaloHub        hub(2);
+    int                         rejected = 0, fallbacks = 0;
+    std::mutex                  mutex;
+    std::vector<std::thread>    workers;
+    for (int r = 0; r < 2; ++r)
+    {
+        workers.emplace_back([&, r]
+        {
+            auto             transport = hub.transport(r);
+            dk::HaloExchange halo(decomp, *transport);
+            dk::MacGrid      local = decomp.makeLocalGrid(r, kDecomposedH);
+            for (float& w : local.w()) w = 20.0f; // 20 m/s * 0.02 s / 0.1 m = 4 cell > halo - 2
+            dk::StableFluidSolver::Params params;
+            params.gravity            = dk::vec3(0.0f);
+            params.track_active_tiles = true;
+            dk::StableFluidSolver solver(params);
+            solver.setHaloExchange(&halo);
+            try
+            {
+                solver.solve(local, kDecomposedDt);
+            }
+            catch (const std::runtime_error&)
+            {
+                std::lock_guard lock(mutex);
+                ++rejected;
+            }
+            std::lock_guard lock(mutex);
+            fallbacks += solver.stats().tracking_fallback ? 1 : 0;
+        });
+    }
+    for (auto& w : workers) w.join();
+    t.expect(rejected == 2, "Decomposed StableFluidSolver rejects backtraces beyond the halo");
+    t.expect(fallbacks == 2, "Decomposed StableFluidSolver reports that active-tile tracking fell back");
+}
+
+// 两个 rank 分别在两个进程里，经 LocalSocketTransport 交换：测试程序以
+// --halo-worker <endpoint> 再启动一份自己当 rank 1，本进程是 rank 0
+constexpr int kSocketDims[3] = {10, 8, 18};
+
+int runHaloWorker(const std::string& endpoint)
+{
+    try
+    {
+        dk::LocalSocketTransport transport(1, 2, endpoint);
+        runDecomposedRank(makeDecomposition(kSocketDims[0], kSocketDims[1], kSocketDims[2], 2), transport, nullptr, nullptr);
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "halo worker: " << e.what() << "\n";
+        return 1;
+    }
+}
+
+void testLocalSocketTransportTwoProcesses(TestContext& t, const std::string& self)
+{
+    const auto        stamp    = std::chrono::steady_clock::now().time_since_epoch().count();
+    const std::string endpoint = (std::filesystem::temp_directory_path() / ("decker_halo_" + std::to_string(stamp))).string();
+    std::string       command  = "\"" + self + "\" --halo-worker \"" + endpoint + "\"";
+#if defined(_WIN32)
+    command = "\"" + command + "\""; // cmd /c 会去掉最外层引号
+#endif
+    int         worker_status = -1;
+    std::thread worker([&] { worker_status = std::system(command.c_str()); });
+
+    const int         nx = kSocketDims[0], ny = kSocketDims[1], nz = kSocketDims[2];
+    const dk::MacGrid single   = singleProcessResult(nx, ny, nz);
+    const dk::MacGrid initial  = seededGrid(nx, ny, nz);
+    dk::MacGrid       gathered = seededGrid(nx, ny, nz);
+    bool              ok       = true;
+    try
+    {
+        dk::LocalSocketTransport transport(0, 2, endpoint);
+        runDecomposedRank(makeDecomposition(nx, ny, nz, 2), transport, &initial, &gathered);
+    }
+    catch (const std::exception&)
+    {
+        ok = false;
+    }
+    worker.join();
+
+    t.expect(ok && worker_status == 0, "LocalSocketTransport connects two worker processes");
+    t.expect(ok && sameFields(single, gathered), "Two-process socket run is bit-identical to single process");
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && std::string(argv[1]) == "--halo-worker") return runHaloWorker(argv[2]);
+
+    TestContext t;
+    testDomainDecompositionMatchesSingleProcess(t);
+    testLocalSocketTransportTwoProcesses(t, argv[0]);
+    return t.finish();
+}
@@ -0,0 +1,281 @@
+// tests/FlipLbmTests.cpp
+// FLIP/APIC 液体与 D3Q19 格子 Boltzmann 系统
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "physics/data/MacGrid.h"
+#include "physics/fluid/FlipSystem.h"
+#include "physics/fluid/LbmSystem.h"
+#include "tests/TestCommon.h"
+
+namespace {
+double particleKineticEnergy(const dk::FlipParticles& p)
+{
+    double e = 0.0;
+    for (const auto& v : p.v) e += 0.5 * glm::dot(v, v);
+    return e;
+}
+
+// 无重力的圆形液滴做刚体旋转，返回 40 步后的动能比
+double rotatingDropEnergyRatio(dk::FlipFluidSystem::Transfer transfer)
+{
+    dk::FlipFluidSystem::Config cfg;
+    cfg.nx = cfg.ny = 32;
+    cfg.nz          = 1;
+    cfg.h           = 1.0f / 32;
+    cfg.gravity     = glm::vec3(0.0f);
+    cfg.transfer    = transfer;
+    dk::FlipFluidSystem sys(cfg);
+    sys.seedBox(glm::vec3(0.2f, 0.2f, 0.0f), glm::vec3(0.8f, 0.8f, 0.0f));
+
+    auto&           p = sys.particles();
+    const glm::vec3 c(0.5f, 0.5f, 0.0f);
+    size_t          kept = 0;
+    for (size_t n = 0; n < p.size(); ++n)
+    {
+        glm::vec3 d = p.x[n] - c;
+        d.z         = 0.0f;
+        if (glm::length(d) >= 0.3f) continue;
+        p.x[kept] = p.x[n];
+        p.v[kept] = 3.0f * glm::vec3(-d.y, d.x, 0.0f);
+        ++kept;
+    }
+    p.resize(kept);
+
+    const double e0 = particleKineticEnergy(p);
+    for (int s = 0; s < 40; ++s) sys.step(0.01f);
+    return particleKineticEnergy(sys.particles()) / e0;
+}
+
+void testFlipFluidSystem(TestContext& t)
+{
+    using Transfer  = dk::FlipFluidSystem::Transfer;
+    const double pic  = rotatingDropEnergyRatio(Transfer::PIC);
+    const double flip = rotatingDropEnergyRatio(Transfer::FLIP);
+    const double apic = rotatingDropEnergyRatio(Transfer::APIC);
+    t.expect(apic > 0.9 && flip > 0.9 && pic < 0.8, "FLIP/APIC keep a rotating drop's energy that PIC dissipates");
+
+    // 静水：底部半箱液体保持静止，液面不动
+    {
+        dk::FlipFluidSystem::Config cfg;
+        cfg.nx = cfg.ny = 24;
+        cfg.nz          = 1;
+        cfg.h           = 1.0f / 24;
+        cfg.fill_min    = glm::vec3(0.0f);
+        cfg.fill_max    = glm::vec3(1.0f, 0.5f, 1.0f);
+        dk::FlipFluidSystem sys(cfg);
+        for (int s = 0; s < 100; ++s) sys.step(0.005f);
+        float max_speed = 0.0f, top = 0.0f;
+        for (size_t n = 0; n < sys.particleCount(); ++n)
+        {
+            max_speed = std::max(max_speed, glm::length(sys.particles().v[n]));
+            top       = std::max(top, sys.particles().x[n].y);
+        }
+        t.expect(max_speed < 1e-2f && top < 0.5f + cfg.h, "FLIP liquid at rest stays at rest");
+    }
+
+    // 3D 溃坝：粒子数守恒、始终在域内、按 cell 排序，水头冲到对面墙
+    {
+        dk::FlipFluidSystem::Config cfg;
+        cfg.nx = cfg.ny = cfg.nz = 16;
+        cfg.h                    = 1.0f / 16;
+        cfg.fill_min             = glm::vec3(0.0f);
+        cfg.fill_max             = glm::vec3(0.4f, 0.8f, 1.0f);
+        dk::FlipFluidSystem sys(cfg);
+        const size_t        count = sys.particleCount();
+
+        for (int s = 0; s < 30; ++s) sys.step(0.01f);
+        const auto& start  = sys.cellStart();
+        bool        sorted = start.front() == 0 && start.back() == count;
+        for (size_t c = 0; sorted && c + 1 < start.size(); ++c) sorted = start[c] <= start[c + 1];
+
+        bool  inside = true;
+        float front  = 0.0f;
+        for (const auto& x : sys.particles().x)
+        {
+            inside = inside && glm::all(glm::greaterThanEqual(x, glm::vec3(0.0f))) && glm::all(glm::lessThanEqual(x, glm::vec3(1.0f)));
+            front  = std::max(front, x.x);
+        }
+        t.expect(sys.particleCount() == count && sorted && inside, "FLIP keeps particles sorted by cell and inside the domain");
+        t.expect(front > 0.9f, "FLIP dam break reaches the far wall");
+
+        std::vector<dk::PointData> points;
+        sys.getRenderData(points);
+        t.expect(points.size() == count, "FLIP exports one render point per particle");
+
+        // 直接写进调用方的缓冲（比需要的大），结果与 getRenderData 相同
+        std::vector<dk::PointData> mapped(count + 16);
+        const size_t               written = sys.writeRenderData(mapped);
+        bool                       same    = written == count && sys.renderPointCount() == count;
+        for (size_t i = 0; same && i < count; ++i)
+            same = points[i].position == mapped[i].position && points[i].color == mapped[i].color;
+        t.expect(same, "FLIP writes render points straight into a caller-provided span");
+    }
+}
+
+// 双缓冲、先碰撞后推送的 D3Q19 参考实现（半程反弹，入口/出口与 LatticeBoltzmannSystem 相同），用来核对 AA 就地布局
+struct ReferenceLbm
+{
+    static constexpr int kC[19][3] = {{0, 0, 0},  {1, 0, 0},   {-1, 0, 0}, {0, 1, 0},  {0, -1, 0}, {0, 0, 1},  {0, 0, -1},
+                                      {1, 1, 0},  {-1, -1, 0}, {1, -1, 0}, {-1, 1, 0}, {1, 0, 1},  {-1, 0, -1}, {1, 0, -1},
+                                      {-1, 0, 1}, {0, 1, 1},   {0, -1, -1}, {0, 1, -1}, {0, -1, 1}};
+    static float weight(int q) { return q == 0 ? 1.0f / 3.0f : q <= 6 ? 1.0f / 18.0f : 1.0f / 36.0f; }
+    static int   opposite(int q) { return q == 0 ? 0 : (q % 2 ? q + 1 : q - 1); }
+
+    glm::ivec3                       n;
+    dk::LatticeBoltzmannSystem::Config cfg;
+    std::vector<int>                 type; // 0 流体 1 固壁 2 入口 3 出口
+    std::vector<float>               cur, next;
+
+    size_t at(int i, int j, int k) const { return (static_cast<size_t>(k) * n.y + j) * n.x + i; }
+    bool   solid(int i, int j, int k) const
+    {
+        return i < 0 || j < 0 || k < 0 || i >= n.x || j >= n.y || k >= n.z || type[at(i, j, k)] == 1;
+    }
+    static float feq(int q, float rho, const glm::vec3& u)
+    {
+        const float cu = kC[q][0] * u.x + kC[q][1] * u.y + kC[q][2] * u.z;
+        return weight(q) * rho * (1.0f + 3.0f * cu + 4.5f * cu * cu - 1.5f * glm::dot(u, u));
+    }
+
+    void moments(size_t c, float& rho, glm::vec3& u) const
+    {
+        rho = 0.0f;
+        u   = glm::vec3(0.0f);
+        for (int q = 0; q < 19; ++q)
+        {
+            const float f = cur[q * type.size() + c];
+            rho += f;
+            u += f * glm::vec3(kC[q][0], kC[q][1], kC[q][2]);
+        }
+        u /= rho;
+    }
+
+    void step()
+    {
+        const size_t N = type.size();
+        for (int k = 0; k < n.z; ++k)
+            for (int j = 0; j < n.y; ++j)
+                for (int i = 0; i < n.x; ++i)
+                {
+                    const size_t c = at(i, j, k);
+                    if (type[c] == 1) continue;
+                    float     rho;
+                    glm::vec3 u;
+                    moments(c, rho, u);
+                    if (type[c] == 2) u = cfg.inflow;
+                    if (type[c] != 0) rho = 1.0f;
+                    for (int q = 0; q < 19; ++q)
+                    {
+                        const float f   = cur[q * N + c];
+                        const float out = type[c] == 0 ? f + (feq(q, rho, u) - f) / cfg.tau : feq(q, rho, u);
+                        const int   ii = i + kC[q][0], jj = j + kC[q][1], kk = k + kC[q][2];
+                        if (solid(ii, jj, kk)) next[opposite(q) * N + c] = out;
+                        else next[q * N + at(ii, jj, kk)] = out;
+                    }
+                }
+        cur.swap(next);
+    }
+};
+
+void testLatticeBoltzmannSystem(TestContext& t)
+{
+    // AA 就地布局与双缓冲参考实现逐步一致（奇数步和偶数步之后都比较）
+    {
+        dk::LatticeBoltzmannSystem::Config cfg;
+        cfg.nx = 12;
+        cfg.ny = cfg.nz = 8;
+        cfg.h          = 0.1f;
+        cfg.lattice_dt = 1.0f;
+        cfg.tau        = 0.6f;
+        cfg.inflow     = glm::vec3(0.05f, 0.01f, 0.0f);
+        dk::LatticeBoltzmannSystem lbm(cfg);
+        lbm.addSphere(glm::vec3(0.45f, 0.4f, 0.4f), 0.15f);
+
+        ReferenceLbm ref;
+        ref.n   = glm::ivec3(cfg.nx, cfg.ny, cfg.nz);
+        ref.cfg = cfg;
+        ref.type.resize(static_cast<size_t>(cfg.nx) * cfg.ny * cfg.nz);
+        for (int k = 0; k < cfg.nz; ++k)
+            for (int j = 0; j < cfg.ny; ++j)
+                for (int i = 0; i < cfg.nx; ++i)
+                    ref.type[ref.at(i, j, k)] = lbm.isSolid(i, j, k) ? 1 : i == 0 ? 2 : i == cfg.nx - 1 ? 3 : 0;
+        ref.cur.assign(19 * ref.type.size(), 0.0f);
+        for (size_t c = 0; c < ref.type.size(); ++c)
+            for (int q = 0; q < 19 && ref.type[c] != 1; ++q) ref.cur[q * ref.type.size() + c] = ReferenceLbm::feq(q, 1.0f, cfg.inflow);
+        ref.next = ref.cur;
+
+        float diff = 0.0f;
+        for (int s = 1; s <= 8; ++s)
+        {
+            lbm.step(1.0f);
+            ref.step();
+            for (int k = 0; k < cfg.nz; ++k)
+                for (int j = 0; j < cfg.ny; ++j)
+                    for (int i = 0; i < cfg.nx; ++i)
+                    {
+                        if (lbm.isSolid(i, j, k)) continue;
+                        float     rho;
+                        glm::vec3 u;
+                        ref.moments(ref.at(i, j, k), rho, u);
+                        diff = std::max({diff, std::fabs(lbm.density(i, j, k) - rho), glm::length(lbm.velocity(i, j, k) - u)});
+                    }
+        }
+        t.expect(lbm.latticeSteps() == 8 && diff < 1e-5f, "LBM AA-pattern update matches a two-lattice reference");
+    }
+
+    // 封闭箱：带初速度晃动、有障碍物时质量守恒，流体被壁面刹住
+    {
+        dk::LatticeBoltzmannSystem::Config cfg;
+        cfg.nx = cfg.ny = cfg.nz = 10;
+        cfg.h                    = 0.1f;
+        cfg.lattice_dt           = 1.0f;
+        cfg.wind_tunnel          = false;
+        cfg.inflow               = glm::vec3(0.05f, 0.02f, 0.0f);
+        dk::LatticeBoltzmannSystem lbm(cfg);
+        lbm.addSphere(glm::vec3(0.5f), 0.2f);
+        auto mass = [&]
+        {
+            double m = 0.0;
+            for (int k = 0; k < 10; ++k)
+                for (int j = 0; j < 10; ++j)
+                    for (int i = 0; i < 10; ++i) m += lbm.isSolid(i, j, k) ? 0.0 : lbm.density(i, j, k);
+            return m;
+        };
+        const double m0 = mass();
+        for (int s = 0; s < 25; ++s) lbm.step(1.0f);
+        t.expect(std::fabs(mass() / m0 - 1.0) < 1e-5 && glm::length(lbm.velocity(2, 2, 2)) < 0.05f,
+                 "LBM conserves mass in a closed box");
+    }
+
+    // 风洞：球后方有尾流，导出的 MacGrid 速度是物理单位
+    {
+        dk::LatticeBoltzmannSystem::Config cfg;
+        cfg.nx = 48;
+        cfg.ny = cfg.nz = 16;
+        cfg.h           = 0.01f;
+        cfg.lattice_dt  = 0.001f;
+        cfg.tau         = 0.6f;
+        dk::LatticeBoltzmannSystem lbm(cfg);
+        lbm.addSphere(glm::vec3(0.125f, 0.08f, 0.08f), 0.03f);
+        for (int s = 0; s < 300; ++s) lbm.step(cfg.lattice_dt);
+
+        const float    wake = lbm.velocity(20, 8, 8).x, side = lbm.velocity(20, 3, 8).x;
+        const dk::MacGrid& g  = lbm.grid();
+        const float    scale = cfg.h / cfg.lattice_dt;
+        t.expect(lbm.latticeSteps() == 300 && wake < side && side > 0.0f, "LBM wind tunnel forms a wake behind an obstacle");
+        t.expect(nearlyEqual(g.sampleVelocity(g.cellCenter(30, 8, 8)).x, lbm.velocity(30, 8, 8).x * scale, 1e-3f * scale)
+                     && g.Dye(12, 8, 8) == 1.0f,
+                 "LBM exports velocity to a MacGrid in physical units");
+    }
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testFlipFluidSystem(t);
+    testLatticeBoltzmannSystem(t);
+    return t.finish();
+}
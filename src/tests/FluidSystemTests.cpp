@@ -1,38 +1,20 @@
+// tests/FluidSystemTests.cpp
+// StableFluidSolver 与 MacGrid：平流、标量通道、2D 路径、活动 tile 和等值面提取
 #include <algorithm>
 #include <cmath>
-#include <iostream>
+#include <cstdint>
+#include <map>
 #include <string>
+#include <vector>
 
+#include "physics/Parallel.h"
 #include "physics/data/MacGrid.h"
 #include "physics/fluid/FluidSystem.h"
+#include "physics/fluid/IsoSurface.h"
 #include "physics/solver/StableFliuidsSolver.h"
+#include "tests/TestCommon.h"
 
 namespace {
-struct TestContext
-{
-    int total  = 0;
-    int failed = 0;
-
-    void expect(bool ok, const std::string& name)
-    {
-        ++total;
-        if (!ok)
-        {
-            ++failed;
-            std::cout << "[FAIL] " << name << "\n";
-        }
-        else
-        {
-            std::cout << "[PASS] " << name << "\n";
-        }
-    }
-};
-
-bool nearlyEqual(float a, float b, float eps = 1e-5f)
-{
-    return std::fabs(a - b) <= eps;
-}
-
 void testFluidSystemInitialState(TestContext& t)
 {
     dk::FluidSystem::Config cfg;
@@ -162,6 +144,329 @@ void testStableFluidSolverClampSides(TestContext& t)
 
     t.expect(boundaries_zero, "StableFluidSolver clamps boundary velocities");
 }
+// 在均匀 +x 流场中平移一个染料球，返回 n 步后的染料峰值与最小值
+struct DyeTransportResult
+{
+    float peak = 0.0f;
+    float min  = 0.0f;
+};
+
+DyeTransportResult translateDyeBlob(dk::StableFluidSolver::AdvectionScheme scheme, bool limiter, int steps)
+{
+    dk::MacGrid grid(40, 12, 12, 1.0f);
+    std::fill(grid.u().begin(), grid.u().end(), 1.0f);
+    for (int k = 0; k < grid.nz(); ++k)
+        for (int j = 0; j < grid.ny(); ++j)
+            for (int i = 0; i < grid.nx(); ++i)
+            {
+                const dk::vec3 d = grid.cellCenter(i, j, k) - dk::vec3(10.0f, 6.0f, 6.0f);
+                if (dot(d, d) <= 9.0f) grid.Dye(i, j, k) = 1.0f;
+            }
+
+    dk::StableFluidSolver::Params params;
+    params.gravity            = dk::vec3(0.0f);
+    params.viscosity          = 0.0f;
+    params.clamp_sides        = false;
+    params.jacobi_iters       = 4;
+    params.velocity_advection = scheme;
+    params.dye_advection      = scheme;
+    params.advection_limiter  = limiter;
+
+    dk::StableFluidSolver solver(params);
+    for (int s = 0; s < steps; ++s) solver.solve(grid, 0.5f);
+
+    DyeTransportResult r;
+    r.peak = *std::max_element(grid.dye().begin(), grid.dye().end());
+    r.min  = *std::min_element(grid.dye().begin(), grid.dye().end());
+    return r;
+}
+
+void testHighOrderAdvectionPreservesDetail(TestContext& t)
+{
+    using Scheme = dk::StableFluidSolver::AdvectionScheme;
+    const auto sl  = translateDyeBlob(Scheme::SemiLagrangian, true, 20);
+    const auto mc  = translateDyeBlob(Scheme::MacCormack, true, 20);
+    const auto bf  = translateDyeBlob(Scheme::BFECC, true, 20);
+
+    t.expect(mc.peak > sl.peak + 0.05f, "MacCormack advection keeps dye peak sharper than semi-Lagrangian");
+    t.expect(bf.peak > sl.peak + 0.05f, "BFECC advection keeps dye peak sharper than semi-Lagrangian");
+    t.expect(mc.peak <= 1.0f + 1e-5f && mc.min >= -1e-5f, "MacCormack limiter keeps dye within initial range");
+    t.expect(bf.peak <= 1.0f + 1e-5f && bf.min >= -1e-5f, "BFECC limiter keeps dye within initial range");
+}
+void testScalarChannelRegistry(TestContext& t)
+{
+    dk::MacGrid grid(4, 4, 4, 1.0f);
+    const int temp    = grid.addScalarChannel("temperature", 300.0f);
+    const int density = grid.addScalarChannel("density");
+
+    t.expect(temp == 0 && density == 1 && grid.scalarChannelCount() == 2,
+             "MacGrid registers scalar channels in order");
+    t.expect(grid.addScalarChannel("temperature") == temp && grid.scalarChannelId("tracer") == -1,
+             "MacGrid scalar channel lookup by name");
+    t.expect(grid.scalar(temp).size() == grid.dye().size() && nearlyEqual(grid.Scalar(temp, 1, 2, 3), 300.0f),
+             "MacGrid scalar channel matches dye layout and initial value");
+}
+
+void testFusedScalarAdvectionMatchesDye(TestContext& t)
+{
+    using Scheme = dk::StableFluidSolver::AdvectionScheme;
+    bool identical = true;
+    for (Scheme scheme : {Scheme::SemiLagrangian, Scheme::MacCormack, Scheme::BFECC})
+    {
+        dk::MacGrid grid(12, 10, 8, 1.0f);
+        for (int k = 0; k < grid.nz(); ++k)
+            for (int j = 0; j < grid.ny(); ++j)
+                for (int i = 0; i < grid.nx() + 1; ++i) grid.U(i, j, k) = 0.3f + 0.05f * j;
+        for (int k = 2; k < 5; ++k)
+            for (int j = 3; j < 6; ++j)
+                for (int i = 2; i < 6; ++i) grid.Dye(i, j, k) = 1.0f;
+
+        const int tracer   = grid.addScalarChannel("tracer");
+        grid.scalar(tracer) = grid.dye();
+
+        dk::StableFluidSolver::Params params;
+        params.gravity       = dk::vec3(0.0f);
+        params.viscosity     = 0.0f;
+        params.jacobi_iters  = 4;
+        params.dye_advection = scheme;
+
+        dk::StableFluidSolver solver(params);
+        for (int s = 0; s < 5; ++s) solver.solve(grid, 0.7f);
+
+        identical = identical && grid.scalar(tracer) == grid.dye();
+    }
+    t.expect(identical, "Fused scalar advection gives each channel the same result as dye");
+}
+
+void testStableFluidSolver2DPath(TestContext& t)
+{
+    dk::MacGrid grid(16, 16, 1, 1.0f);
+    for (int j = 4; j < 12; ++j)
+        for (int i = 4; i < 12; ++i) grid.U(i, j, 0) = 1.0f;
+
+    dk::StableFluidSolver::Params params;
+    params.gravity      = dk::vec3(0.0f);
+    params.viscosity    = 0.0f;
+    params.advect_dye   = false;
+    params.jacobi_iters = 400;
+
+    const float before = maxInteriorDivergence2D(grid);
+    dk::StableFluidSolver solver(params);
+    solver.solve(grid, 0.0f);
+    const float after = maxInteriorDivergence2D(grid);
+
+    bool w_zero = true;
+    for (float w : grid.w()) w_zero = w_zero && w == 0.0f;
+
+    t.expect(after < 0.1f * before, "StableFluidSolver 2D path (nz == 1) projects out divergence");
+    t.expect(w_zero, "StableFluidSolver 2D path leaves W untouched");
+}
+
+void testSlabPoolAndFieldLayout(TestContext& t)
+{
+    // 显式开 4 个线程，单核机器上也能覆盖分段逻辑
+    dk::SlabPool     pool(4);
+    std::vector<int> hits(1003, 0);
+    for (int rep = 0; rep < 3; ++rep)
+    {
+        pool.run(0, static_cast<dk::i64>(hits.size()), [&](dk::i64 b, dk::i64 e)
+        {
+            for (dk::i64 n = b; n < e; ++n) ++hits[n];
+        });
+    }
+    t.expect(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 3; }),
+             "SlabPool visits every index exactly once per run");
+
+    // 大字段从 2MB 边界开始，方便内核使用大页
+    dk::Field big(600 * 1024);
+    t.expect(reinterpret_cast<std::uintptr_t>(big.data()) % (2u << 20) == 0,
+             "Field allocator aligns large fields to 2MB");
+
+    dk::MacGrid grid(5, 4, 3, 1.0f);
+    bool        layout_ok = grid.idxP(4, 3, 2) + 1 == grid.dye().size();
+    layout_ok = layout_ok && grid.fieldSize(dk::MacGrid::FieldKind::U) == grid.u().size();
+    layout_ok = layout_ok && grid.fieldIdx(dk::MacGrid::FieldKind::W, 4, 3, 3) + 1 == grid.w().size();
+    t.expect(layout_ok, "MacGrid 64-bit indices match field sizes");
+}
+
+// 角落里一团向 +x 运动的染料，其余是静止空气
+struct ActiveTileRun
+{
+    dk::MacGrid                  grid;
+    dk::StableFluidSolver::Stats stats;
+};
+
+ActiveTileRun runCornerBlob(int nz, bool track, float velocity_eps, float gravity = 0.0f, int steps = 4)
+{
+    const int   n = nz == 1 ? 64 : 32; // 2D 的 tile 只有一层，给大一点的域
+    dk::MacGrid g(n, n, nz, 0.1f);
+    for (int k = 0; k < std::min(nz, 6); ++k)
+        for (int j = 2; j < 6; ++j)
+            for (int i = 2; i < 6; ++i)
+            {
+                g.Dye(i, j, k) = 1.0f;
+                g.U(i, j, k)   = 1.0f;
+            }
+
+    dk::StableFluidSolver::Params params;
+    params.gravity             = dk::vec3(0.0f, gravity, 0.0f);
+    params.viscosity           = 0.001f;
+    params.jacobi_iters        = 30;
+    params.velocity_advection  = dk::StableFluidSolver::AdvectionScheme::MacCormack;
+    params.dye_advection       = dk::StableFluidSolver::AdvectionScheme::BFECC;
+    params.track_active_tiles  = track;
+    params.active_velocity_eps = velocity_eps;
+
+    dk::StableFluidSolver solver(params);
+    for (int s = 0; s < steps; ++s) solver.solve(g, 0.02f);
+    return {std::move(g), solver.stats()};
+}
+
+float maxAbsDiff(const dk::Field& a, const dk::Field& b)
+{
+    float m = 0.0f;
+    for (size_t n = 0; n < a.size(); ++n) m = std::max(m, std::fabs(a[n] - b[n]));
+    return m;
+}
+
+void testActiveTilesSkipQuiescentCells(TestContext& t)
+{
+    for (int nz : {32, 1})
+    {
+        const std::string dim  = nz == 1 ? " (2D)" : " (3D)";
+        const auto        full = runCornerBlob(nz, false, 0.05f);
+        const auto        trk  = runCornerBlob(nz, true, 0.05f);
+        // 阈值为负时每个 tile 都是种子，走整场路径
+        const auto all = runCornerBlob(nz, true, -1.0f);
+
+        t.expect(trk.stats.active_fraction > 0.0f && trk.stats.active_fraction < 0.5f,
+                 "Active-tile tracking skips most of a quiet domain" + dim);
+        t.expect(maxAbsDiff(trk.grid.dye(), full.grid.dye()) < 1e-2f,
+                 "Active-tile tracking keeps dye close to the full solve" + dim);
+        // 远角是静止空气：跟踪时保持原值
+        const int far = trk.grid.nx() - 2, fk = nz - 1;
+        t.expect(trk.grid.Dye(far, far, fk) == 0.0f && trk.grid.U(far, far, fk) == 0.0f && trk.grid.P(far, far, fk) == 0.0f,
+                 "Active-tile tracking leaves quiescent cells constant" + dim);
+        t.expect(all.stats.active_fraction == 1.0f && bitwiseEqual(all.grid.u(), full.grid.u())
+                 && bitwiseEqual(all.grid.p(), full.grid.p()) && bitwiseEqual(all.grid.dye(), full.grid.dye()),
+                 "Fully active tracking is bit-identical to the untracked solve" + dim);
+    }
+}
+
+// 有重力时跟踪模式把静止空气当作静水平衡，整场模式让它下落；记录这一差异和活跃区的扩张
+void testActiveTilesUnderGravity(TestContext& t)
+{
+    const auto full = runCornerBlob(32, false, 0.05f, -9.8f, 1);
+    const auto trk  = runCornerBlob(32, true, 0.05f, -9.8f, 1);
+    const int  far  = full.grid.nx() - 2;
+    t.expect(trk.grid.V(far, far, 31) == 0.0f && full.grid.V(far, far, 31) < 0.0f,
+             "Active-tile tracking treats quiet air under gravity as hydrostatic");
+
+    const auto later = runCornerBlob(32, true, 0.05f, -9.8f, 12);
+    t.expect(later.stats.active_fraction > 0.5f, "Under gravity the active set spreads through a closed box");
+}
+
+// 与 MeshData 字段一致，测试不依赖 runtime 的头文件
+struct TestMesh
+{
+    uint32_t                vertex_count = 0;
+    uint32_t                index_count  = 0;
+    std::vector<uint32_t>   indices;
+    std::vector<glm::vec3>  positions;
+    std::vector<glm::vec3>  normals;
+};
+
+// 每条有向边恰好出现一次且反向边也出现一次：封闭、流形、朝向一致
+bool closedAndOriented(const TestMesh& m)
+{
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t n = 0; n < m.indices.size(); n += 3)
+        for (int e = 0; e < 3; ++e) ++edges[{m.indices[n + e], m.indices[n + (e + 1) % 3]}];
+    for (const auto& [e, count] : edges)
+    {
+        auto it = edges.find({e.second, e.first});
+        if (count != 1 || it == edges.end() || it->second != 1) return false;
+    }
+    return !edges.empty();
+}
+
+float signedVolume(const TestMesh& m)
+{
+    double v = 0.0;
+    for (size_t n = 0; n < m.indices.size(); n += 3)
+    {
+        const glm::vec3 a = m.positions[m.indices[n]], b = m.positions[m.indices[n + 1]], c = m.positions[m.indices[n + 2]];
+        v += glm::dot(a, glm::cross(b, c)) / 6.0;
+    }
+    return static_cast<float>(v);
+}
+
+void testIsoSurfaceExtraction(TestContext& t)
+{
+    // dye = max(0, 1 - |x - c| / R)，iso 0.5 是半径 R / 2 的球
+    const int       n = 48;
+    dk::MacGrid     g(n, n, n, 1.0f / n);
+    const glm::vec3 c(0.5f);
+    const float     R = 0.4f, r = 0.2f;
+    auto            fill = [&](const glm::vec3& center)
+    {
+        for (int k = 0; k < n; ++k)
+            for (int j = 0; j < n; ++j)
+                for (int i = 0; i < n; ++i) g.Dye(i, j, k) = std::max(0.0f, 1.0f - glm::length(g.cellCenter(i, j, k) - center) / R);
+    };
+    fill(c);
+
+    dk::IsoSurfaceExtractor ex;
+    TestMesh                m;
+    ex.extract(g, g.dye(), 0.5f, m);
+
+    const float pi = 3.14159265f;
+    float       radius_err = 0.0f;
+    bool        outward    = true;
+    for (size_t v = 0; v < m.positions.size(); ++v)
+    {
+        radius_err = std::max(radius_err, std::fabs(glm::length(m.positions[v] - c) - r));
+        outward    = outward && glm::dot(m.normals[v], m.positions[v] - c) > 0.0f;
+    }
+    const auto& st = ex.stats();
+    t.expect(m.vertex_count == m.positions.size() && m.index_count == m.indices.size() && m.index_count % 3 == 0
+             && st.triangles * 3 == m.index_count && st.vertices == m.vertex_count,
+             "Isosurface fills an indexed triangle mesh");
+    t.expect(closedAndOriented(m), "Isosurface of a sphere is closed and consistently oriented");
+    t.expect(radius_err < 0.25f / n && outward, "Isosurface vertices lie on the sphere with outward normals");
+    t.expect(std::fabs(signedVolume(m) / (4.0f / 3.0f * pi * r * r * r) - 1.0f) < 0.03f,
+             "Isosurface encloses the sphere volume with outward winding");
+    t.expect(st.active_bricks > 0 && st.active_bricks < st.bricks / 2, "Min/max bricks skip empty blocks");
+
+    // 贴墙的部分由补的一圈 0 封口；复用同一层级换 iso
+    fill(glm::vec3(0.05f, 0.5f, 0.5f));
+    ex.extract(g, g.dye(), 0.5f, m);
+    const bool wall_closed = closedAndOriented(m) && signedVolume(m) > 0.0f;
+    TestMesh   inner;
+    ex.extract(0.8f, inner);
+    t.expect(wall_closed && closedAndOriented(inner) && signedVolume(inner) < signedVolume(m),
+             "Isosurface closes against walls and reuses the brick hierarchy across iso values");
+
+    std::fill(g.dye().begin(), g.dye().end(), 0.0f);
+    ex.extract(g, g.dye(), 0.5f, m);
+    t.expect(m.vertex_count == 0 && m.index_count == 0 && ex.stats().active_bricks == 0, "Empty field yields an empty mesh");
+
+    // 粒子密度：CIC 摊到格点保持总质量，按平均密度的一半提取得到闭合表面
+    std::vector<glm::vec3> particles;
+    for (float z = 0.3f; z < 0.7f; z += 0.01f)
+        for (float y = 0.3f; y < 0.7f; y += 0.01f)
+            for (float x = 0.3f; x < 0.7f; x += 0.01f)
+                if (glm::length(glm::vec3(x, y, z) - c) < 0.18f) particles.push_back(glm::vec3(x, y, z));
+    const float mass = 1e-6f;
+    dk::Field   rho;
+    dk::splatDensity(g, particles, [](const glm::vec3& p) { return p; }, mass, rho);
+    double total = 0.0;
+    for (float v : rho) total += v;
+    const float cell = g.h() * g.h() * g.h();
+    t.expect(std::fabs(total * cell / (particles.size() * mass) - 1.0) < 1e-4, "Density splat conserves particle mass");
+    ex.extract(g, rho, 0.5f * mass / (0.01f * 0.01f * 0.01f), m);
+    t.expect(closedAndOriented(m) && signedVolume(m) > 0.0f, "Particle density extracts a closed surface");
+}
 } // namespace
 
 int main()
@@ -170,7 +475,13 @@ int main()
     testFluidSystemInitialState(t);
     testStableFluidSolverGravity(t);
     testStableFluidSolverClampSides(t);
-
-    std::cout << "\nTotal: " << t.total << ", Failed: " << t.failed << "\n";
-    return t.failed == 0 ? 0 : 1;
+    testHighOrderAdvectionPreservesDetail(t);
+    testScalarChannelRegistry(t);
+    testFusedScalarAdvectionMatchesDye(t);
+    testStableFluidSolver2DPath(t);
+    testSlabPoolAndFieldLayout(t);
+    testActiveTilesSkipQuiescentCells(t);
+    testActiveTilesUnderGravity(t);
+    testIsoSurfaceExtraction(t);
+    return t.finish();
 }
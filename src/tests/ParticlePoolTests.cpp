@@ -0,0 +1,135 @@
+// tests/ParticlePoolTests.cpp
+// 批量插入与质点池：复用槽位、压缩、发射器与杀死器
+#include <random>
+#include <vector>
+
+#include "physics/Parallel.h"
+#include "physics/data/ParticlePool.h"
+#include "physics/emit/Emitter.h"
+#include "physics/emit/Killer.h"
+#include "tests/TestCommon.h"
+
+namespace {
+void testBulkParticleInsertion(TestContext& t)
+{
+    // 同一块带弹簧的网格分别逐个添加和批量并行添加，结果应逐项相同；两边都先放一个已有质点检查下标偏移
+    const int gw = 33, gh = 17;
+    auto      gridPos = [](int x, int y) { return glm::vec3(0.1f * x, 0.0f, -0.2f * y); };
+
+    dk::ParticleData one, bulk;
+    dk::Spring       one_springs, bulk_springs;
+    one.addParticle(glm::vec3(5.0f), 2.0f, true);
+    bulk.addParticle(glm::vec3(5.0f), 2.0f, true);
+
+    for (int y = 0; y < gh; ++y)
+        for (int x = 0; x < gw; ++x) one.addParticle(gridPos(x, y), 0.5f);
+    for (int y = 0; y < gh; ++y)
+        for (int x = 0; x + 1 < gw; ++x) one_springs.addSpring(1 + y * gw + x, 2 + y * gw + x, 10.0f, 0.1f);
+
+    const dk::ParticleBuilder batch = bulk.addParticles(static_cast<size_t>(gw) * gh, 0.5f);
+    const dk::SpringBuilder   springs = bulk_springs.addSprings(static_cast<size_t>(gw - 1) * gh);
+    dk::parallelForSlabs(0, gh, [&](dk::i64 y0, dk::i64 y1)
+    {
+        for (int y = static_cast<int>(y0); y < static_cast<int>(y1); ++y)
+        {
+            for (int x = 0; x < gw; ++x) batch.place(y * gw + x, gridPos(x, y));
+            for (int x = 0; x + 1 < gw; ++x)
+                springs.set(y * (gw - 1) + x, batch.index(y * gw + x), batch.index(y * gw + x + 1), 10.0f, 0.1f);
+        }
+    });
+
+    const bool same_particles = one.position == bulk.position && one.previous_position == bulk.previous_position
+                                && one.velocity == bulk.velocity && one.acceleration == bulk.acceleration && one.force == bulk.force
+                                && one.mass == bulk.mass && one.inv_mass == bulk.inv_mass && one.color == bulk.color
+                                && one.is_fixed == bulk.is_fixed && one.is_sleeping == bulk.is_sleeping && one.is_dead == bulk.is_dead
+                                && one.density == bulk.density
+                                && one.pressure == bulk.pressure && one.neighbors.size() == bulk.neighbors.size();
+    const bool same_springs = one_springs.index_a == bulk_springs.index_a && one_springs.index_b == bulk_springs.index_b
+                              && one_springs.stiffness == bulk_springs.stiffness && one_springs.rest_length == bulk_springs.rest_length;
+    t.expect(batch.base == 1 && same_particles, "bulk particle insertion matches per-particle addParticle");
+    t.expect(same_springs, "bulk spring insertion matches per-spring addSpring");
+}
+
+void testParticlePool(TestContext& t)
+{
+    dk::ParticleData data;
+    dk::Spring       springs;
+    dk::ParticlePool pool;
+    pool.reserve(data, 4096);
+
+    // 池外先建一段三个质点的绳，池会自动登记它们
+    for (int i = 0; i < 3; ++i) data.addParticle(glm::vec3(-1.0f - i, 0.0f, 0.0f), 1.0f);
+    springs.addSpring(0, 1, 10.0f, 1.0f);
+    springs.addSpring(1, 2, 10.0f, 1.0f);
+
+    // 再生成 1000 个，相邻的用弹簧连起来
+    std::vector<dk::ParticleHandle> handles;
+    for (int i = 0; i < 1000; ++i)
+    {
+        handles.push_back(pool.spawn(data, glm::vec3(static_cast<float>(i), 0.0f, 0.0f), glm::vec3(0.0f), 1.0f));
+        if (i > 0) springs.addSpring(pool.slot(handles[i - 1]), pool.slot(handles[i]), 10.0f, 1.0f);
+    }
+    const size_t capacity = data.position.capacity();
+
+    // 每三个杀一个，再杀掉绳子中间的质点
+    for (int i = 0; i < 1000; i += 3) pool.kill(data, handles[i]);
+    pool.killSlot(data, 1);
+    const bool stale = pool.slot(handles[0]) == dk::ParticlePool::kNone && !pool.kill(data, handles[3]);
+    pool.maintain(data, &springs);
+
+    bool positions_kept = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (i % 3 == 0) continue;
+        const size_t s = pool.slot(handles[i]);
+        positions_kept = positions_kept && s < data.size() && data.position[s].x == static_cast<float>(i);
+    }
+    bool springs_ok = springs.size() == 333; // 999 根里两端都活着的只剩 (1,2) (4,5) ... 共 333 根，绳上的两根都被删掉
+    for (size_t k = 0; k < springs.size(); ++k)
+        springs_ok = springs_ok && springs.index_a[k] < data.size() && springs.index_b[k] < data.size()
+                     && data.position[springs.index_b[k]].x - data.position[springs.index_a[k]].x == 1.0f;
+    t.expect(stale && pool.compactions() == 1 && data.size() == 668 && pool.aliveCount() == 668,
+             "particle pool compacts dead slots and invalidates their handles");
+    t.expect(positions_kept && springs_ok, "particle pool compaction remaps handles and springs");
+
+    // 反复生灭不会让数组重新分配
+    std::mt19937 rng(7);
+    for (int cycle = 0; cycle < 50; ++cycle)
+    {
+        for (int k = 0; k < 300; ++k) pool.spawn(data, glm::vec3(0.0f), glm::vec3(0.0f), 1.0f);
+        for (int k = 0; k < 300; ++k)
+        {
+            const size_t s = std::uniform_int_distribution<size_t>(0, pool.slotCount() - 1)(rng);
+            pool.killSlot(data, s);
+        }
+        pool.maintain(data, &springs);
+    }
+    t.expect(data.position.capacity() == capacity && data.size() == pool.slotCount(), "particle pool reuses slots without reallocating");
+
+    // 发射器 + 寿命回收：稳态存活数 = 速率 × 寿命
+    dk::ParticleData         spray;
+    dk::ParticlePool         spray_pool;
+    dk::PointEmitter::Params ep;
+    ep.rate     = 1000.0f;
+    ep.lifetime = 0.5f;
+    dk::PointEmitter   emitter(ep);
+    dk::LifetimeKiller killer;
+    const float        dt = 0.01f;
+    for (int step = 0; step < 200; ++step)
+    {
+        emitter.emit(spray_pool, spray, dt);
+        spray_pool.advanceAges(dt);
+        killer.kill(spray_pool, spray, dt);
+        spray_pool.maintain(spray);
+    }
+    t.expect(spray_pool.aliveCount() >= 495 && spray_pool.aliveCount() <= 505, "emitter and lifetime killer reach steady state");
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testBulkParticleInsertion(t);
+    testParticlePool(t);
+    return t.finish();
+}
@@ -0,0 +1,106 @@
+// tests/PhysicsStatsTests.cpp
+// 每个系统的物理统计通道
+#include <string>
+#include <vector>
+
+#include "physics/PhysicsStats.h"
+#include "physics/data/MacGrid.h"
+#include "physics/solver/StableFliuidsSolver.h"
+#include "tests/TestCommon.h"
+
+namespace {
+void testPhysicsStats(TestContext& t)
+{
+    dk::PhysicsStats& stats = dk::PhysicsStats::instance();
+    stats.reset();
+
+    // 同一帧内计数累加、数值取最后一次；前缀随 SystemScope 嵌套与恢复
+    stats.beginFrame();
+    {
+        dk::PhysicsStats::SystemScope scope("cloth");
+        stats.addCount("iterations", 10);
+        stats.addCount("iterations", 5);
+        stats.setValue("residual", 0.5);
+        stats.setValue("residual", 0.25);
+        {
+            dk::PhysicsStats::SystemScope inner("self collision");
+            stats.addCount("pairs", 3);
+        }
+        stats.addCount("grid rebuilds", 1);
+    }
+    stats.addCount("orphan", 1);
+    stats.endFrame();
+
+    t.expect(stats.find("cloth/iterations") && stats.latest("cloth/iterations") == 15.0f,
+             "PhysicsStats accumulates counts within a frame");
+    t.expect(stats.latest("cloth/residual") == 0.25f, "PhysicsStats keeps the last value within a frame");
+    t.expect(stats.find("cloth/self collision/pairs") && stats.find("cloth/grid rebuilds") && stats.find("orphan"),
+             "PhysicsStats SystemScope nests and restores the channel prefix");
+
+    // 一帧没有记录：计数为 0，数值沿用上一帧
+    stats.beginFrame();
+    stats.endFrame();
+    t.expect(stats.latest("cloth/iterations") == 0.0f && stats.latest("cloth/residual") == 0.25f,
+             "PhysicsStats fills untouched frames");
+
+    // 环形缓冲写满后保留最近 kHistory 帧，history 从旧到新
+    const size_t frames = dk::PhysicsStats::kHistory + 17;
+    for (size_t f = 0; f < frames; ++f)
+    {
+        stats.beginFrame();
+        {
+            dk::PhysicsStats::SystemScope scope("cloth");
+            stats.addCount("iterations", static_cast<double>(f));
+        }
+        stats.endFrame();
+    }
+    std::vector<float> history;
+    stats.history("cloth/iterations", history);
+    bool ordered = history.size() == dk::PhysicsStats::kHistory;
+    for (size_t k = 0; ordered && k < history.size(); ++k)
+        ordered = history[k] == static_cast<float>(frames - dk::PhysicsStats::kHistory + k);
+    t.expect(ordered, "PhysicsStats ring buffer wraps and returns history oldest first");
+    t.expect(nearlyEqual(stats.average("cloth/iterations", 4), static_cast<float>(frames) - 2.5f),
+             "PhysicsStats averages the most recent frames");
+    t.expect(stats.frameCount() == frames + 2, "PhysicsStats counts frames");
+
+    // 驻留的名字在 reset 之后仍然有效，同名通道重建后拿到同一个指针
+    const char* plot_name = stats.find("cloth/residual")->plot_name;
+    stats.reset();
+    stats.setValue("cloth/residual", 1.0);
+    t.expect(std::string_view(plot_name) == "cloth/residual" && stats.find("cloth/residual")->plot_name == plot_name,
+             "PhysicsStats channel names stay valid across reset");
+
+    // 求解器把阶段计时与迭代次数记到当前系统下
+    stats.reset();
+    dk::MacGrid grid(16, 16, 1, 1.0f);
+    dk::StableFluidSolver::Params params;
+    params.jacobi_iters = 20;
+    dk::StableFluidSolver solver(params);
+    stats.beginFrame();
+    {
+        dk::PhysicsStats::SystemScope scope("smoke");
+        solver.solve(grid, 0.01f);
+        solver.solve(grid, 0.01f);
+    }
+    stats.endFrame();
+    const dk::PhysicsStats::Channel* projection = stats.find("smoke/projection");
+    t.expect(projection && projection->kind == dk::PhysicsStats::Kind::Time && projection->latest() >= 0.0f,
+             "StableFluidSolver records stage timings");
+    t.expect(stats.latest("smoke/pressure iterations") == 40.0f, "StableFluidSolver records pressure iterations per frame");
+
+    // 关闭后不再建通道
+    stats.setEnabled(false);
+    stats.addCount("disabled", 1);
+    stats.setEnabled(true);
+    t.expect(stats.find("disabled") == nullptr, "PhysicsStats ignores records while disabled");
+    stats.reset();
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testPhysicsStats(t);
+    return t.finish();
+}
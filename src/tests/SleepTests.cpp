@@ -0,0 +1,155 @@
+// tests/SleepTests.cpp
+// 弹簧岛休眠：静止后入睡、外力与锚点移动唤醒，与发射器共存
+#include <algorithm>
+#include <vector>
+
+#include "physics/data/ParticlePool.h"
+#include "physics/data/SleepIslands.h"
+#include "physics/emit/Emitter.h"
+#include "physics/emit/Killer.h"
+#include "physics/force/DampingForce.h"
+#include "physics/force/GravityForce.h"
+#include "physics/solver/PBDSolver.h"
+#include "tests/TestCommon.h"
+
+namespace {
+void testSleepIslands(TestContext& t)
+{
+    // 两根各自钉住的绳子：同一个钉子不把它们连成一个岛
+    dk::ParticleData data;
+    dk::Spring       springs;
+    const size_t     pin = data.addParticle(glm::vec3(0.0f), 0.1f, true);
+    size_t           rope_b = 0;
+    for (int r = 0; r < 2; ++r)
+    {
+        size_t prev = pin;
+        for (int i = 1; i <= 10; ++i)
+        {
+            // 间距大于点-点碰撞的厚度 0.1
+            const size_t p = data.addParticle(glm::vec3(0.3f * r, -0.15f * i, 0.0f), 0.1f);
+            springs.addSpring(prev, p, 500.0f, glm::length(data.position[p] - data.position[prev]));
+            prev = p;
+            if (r == 1 && i == 10) rope_b = p;
+        }
+    }
+
+    dk::GravityForce        gravity(glm::vec3(0.0f, -9.8f, 0.0f));
+    dk::DampingForce        damping(0.5f);
+    dk::SleepIslands        islands;
+    dk::PBDSolver           solver(10, 0.01f);
+    dk::ParticleSystemState state(data, springs);
+    auto step = [&](const glm::vec3& poke)
+    {
+        std::fill(data.force.begin(), data.force.end(), glm::vec3(0.0f));
+        gravity.applyForce(data);
+        damping.applyForce(data);
+        data.force[rope_b] += poke;
+        islands.wakeDisturbed(data, springs);
+        solver.solve(state, 1.0f / 600.0f);
+        islands.update(data);
+    };
+
+    int steps = 0;
+    while (islands.sleepingIslandCount() < 2 && steps < 6000)
+    {
+        step(glm::vec3(0.0f));
+        ++steps;
+    }
+    const std::vector<glm::vec3> rest = data.position;
+    for (int i = 0; i < 100; ++i) step(glm::vec3(0.0f));
+    const bool frozen = data.position == rest;
+
+    // 推一下 b 绳：只有它的岛醒来
+    step(glm::vec3(1.0f, 0.0f, 0.0f));
+    const bool woke = islands.sleepingIslandCount() == 1 && !data.is_sleeping[rope_b] && data.is_sleeping[1]
+                      && data.position[rope_b] != rest[rope_b];
+
+    // 拖动钉子：仍在睡的 a 绳跟着醒来
+    data.position[pin] += glm::vec3(0.05f, 0.0f, 0.0f);
+    step(glm::vec3(0.0f));
+    const bool anchor_woke = !data.is_sleeping[1] && islands.sleepingIslandCount() == 0;
+
+    t.expect(islands.islandCount() == 2 && steps < 6000 && frozen, "settled spring islands fall asleep and stay frozen");
+    t.expect(woke, "an external force wakes only its own island");
+    t.expect(anchor_woke, "moving a pinned anchor wakes the islands hanging from it");
+}
+
+void testSleepWithEmitters(TestContext& t)
+{
+    // 两根各自钉住的绳子，旁边一个发射器不停地生成、回收喷溅粒子
+    dk::ParticleData data;
+    dk::Spring       springs;
+    std::vector<size_t> ends;
+    for (int r = 0; r < 2; ++r)
+    {
+        size_t prev = data.addParticle(glm::vec3(0.3f * r, 0.0f, 0.0f), 0.1f, true);
+        for (int i = 1; i <= 10; ++i)
+        {
+            const size_t p = data.addParticle(glm::vec3(0.3f * r, -0.15f * i, 0.0f), 0.1f);
+            springs.addSpring(prev, p, 500.0f, 0.15f);
+            prev = p;
+        }
+        ends.push_back(prev);
+    }
+
+    dk::ParticlePool         pool;
+    dk::PointEmitter::Params ep;
+    ep.position = glm::vec3(5.0f, 0.0f, 0.0f);
+    ep.rate     = 1200.0f;
+    ep.lifetime = 0.05f;
+    dk::PointEmitter        emitter(ep);
+    dk::LifetimeKiller      killer;
+    dk::GravityForce        gravity(glm::vec3(0.0f, -9.8f, 0.0f));
+    dk::DampingForce        damping(0.5f);
+    dk::SleepIslands        islands;
+    dk::PBDSolver           solver(10, 0.01f);
+    dk::ParticleSystemState state(data, springs);
+    const float             dt = 1.0f / 600.0f;
+    // 与 SpringMassSystem::step 的顺序一致
+    auto step = [&]
+    {
+        emitter.emit(pool, data, dt);
+        std::fill(data.force.begin(), data.force.end(), glm::vec3(0.0f));
+        gravity.applyForce(data);
+        damping.applyForce(data);
+        islands.wakeDisturbed(data, springs, pool.changes());
+        pool.clearChanges();
+        solver.solve(state, dt);
+        islands.update(data);
+        pool.advanceAges(dt);
+        killer.kill(pool, data, dt);
+        pool.maintain(data, &springs);
+    };
+    auto ropeAsleep = [&](size_t end) { return data.is_sleeping[end] && data.is_sleeping[end - 9]; };
+
+    int steps = 0;
+    while (!(ropeAsleep(ends[0]) && ropeAsleep(ends[1])) && steps < 6000)
+    {
+        step();
+        ++steps;
+    }
+    const std::vector<glm::vec3> rest(data.position.begin(), data.position.begin() + 22);
+    for (int i = 0; i < 100; ++i) step();
+    pool.compact(data, &springs); // 压实搬动喷溅粒子的下标，绳子的岛仍然认得出来
+    for (int i = 0; i < 100; ++i) step();
+    const bool frozen = ropeAsleep(ends[0]) && ropeAsleep(ends[1])
+                        && std::equal(rest.begin(), rest.end(), data.position.begin());
+
+    // 回收 b 绳末端的质点：删掉的弹簧只唤醒 b 绳
+    pool.killSlot(data, ends[1]);
+    pool.maintain(data, &springs);
+    step();
+    const bool only_b = ropeAsleep(ends[0]) && !data.is_sleeping[ends[1] - 1] && !data.is_sleeping[ends[1]];
+
+    t.expect(steps < 6000 && pool.compactions() > 0 && frozen, "spring islands fall asleep and stay asleep next to an emitter");
+    t.expect(only_b, "killing a rope particle wakes only the rope that lost it");
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testSleepIslands(t);
+    testSleepWithEmitters(t);
+    return t.finish();
+}
@@ -0,0 +1,226 @@
+// tests/SolverTests.cpp
+// 质点弹簧求解器：隐式欧拉、Projective Dynamics，以及压力/扩散/PBD 的 Chebyshev 加速
+#include <algorithm>
+#include <cmath>
+
+#include "physics/data/MacGrid.h"
+#include "physics/solver/ImplicitEulerSolver.h"
+#include "physics/solver/PBDSolver.h"
+#include "physics/solver/ProjectiveDynamicsSolver.h"
+#include "physics/solver/StableFliuidsSolver.h"
+#include "tests/TestCommon.h"
+
+namespace {
+void testImplicitEulerSolver(TestContext& t)
+{
+    const glm::vec3 g(0.0f, -9.8f, 0.0f);
+
+    // 单根弹簧挂一个质点：大步长下稳定，并收敛到静平衡伸长 mg/k
+    {
+        dk::ParticleData data;
+        dk::Spring       springs;
+        data.addParticle(glm::vec3(0.0f), 1.0f, true);
+        data.addParticle(glm::vec3(0.0f, -1.0f, 0.0f), 0.5f);
+        springs.addSpring(0, 1, 500.0f, 1.0f);
+
+        dk::ParticleSystemState state(data, springs);
+        dk::ImplicitEulerSolver solver;
+        bool                    converged = true;
+        for (int step = 0; step < 600; ++step)
+        {
+            data.force[1] = data.mass[1] * g;
+            solver.solve(state, 1.0f / 60.0f);
+            converged = converged && solver.lastResidual() <= solver.params().tolerance;
+        }
+        const float expected = -1.0f - 0.5f * 9.8f / 500.0f;
+        t.expect(converged && nearlyEqual(data.position[1].y, expected, 1e-4f) && std::fabs(data.position[1].x) < 1e-6f
+                     && data.position[0] == glm::vec3(0.0f),
+                 "implicit Euler spring settles at the static extension");
+    }
+
+    // 刚性绳子一帧一步：显式积分在这个步长下发散，隐式积分保持有界且不伸长
+    {
+        dk::ParticleData data;
+        dk::Spring       springs;
+        const int        segments = 40;
+        const float      seg      = 0.05f;
+        for (int i = 0; i <= segments; ++i) data.addParticle(glm::vec3(i * seg, 0.0f, 0.0f), 0.02f, i == 0);
+        for (int i = 0; i < segments; ++i) springs.addSpring(i, i + 1, 5000.0f, seg);
+        for (int i = 0; i + 2 <= segments; ++i) springs.addSpring(i, i + 2, 500.0f, 2.0f * seg);
+
+        dk::ParticleSystemState state(data, springs);
+        dk::ImplicitEulerSolver solver;
+        bool                    bounded = true;
+        for (int step = 0; step < 240; ++step)
+        {
+            for (size_t i = 1; i < data.size(); ++i) data.force[i] = data.mass[i] * g;
+            solver.solve(state, 1.0f / 60.0f);
+            for (size_t i = 0; i < data.size(); ++i) bounded = bounded && std::isfinite(data.position[i].y);
+        }
+        float stretch = 0.0f;
+        for (int i = 0; i < segments; ++i) stretch = std::max(stretch, glm::length(data.position[i + 1] - data.position[i]) / seg);
+        t.expect(bounded && stretch < 1.1f && data.position[segments].y < -1.0f, "implicit Euler keeps a stiff rope stable at 60 Hz");
+    }
+}
+
+void testProjectiveDynamicsSolver(TestContext& t)
+{
+    const glm::vec3 g(0.0f, -9.8f, 0.0f);
+
+    // 单根弹簧：局部/全局迭代的不动点就是静平衡
+    {
+        dk::ParticleData data;
+        dk::Spring       springs;
+        data.addParticle(glm::vec3(0.0f), 1.0f, true);
+        data.addParticle(glm::vec3(0.0f, -1.0f, 0.0f), 0.5f);
+        springs.addSpring(0, 1, 500.0f, 1.0f);
+
+        dk::ParticleSystemState      state(data, springs);
+        dk::ProjectiveDynamicsSolver solver;
+        for (int step = 0; step < 600; ++step)
+        {
+            data.force[1] = data.mass[1] * g;
+            solver.solve(state, 1.0f / 60.0f);
+        }
+        t.expect(nearlyEqual(data.position[1].y, -1.0f - 0.5f * 9.8f / 500.0f, 1e-4f) && solver.factorizations() == 1,
+                 "projective dynamics spring settles at the static extension");
+    }
+
+    // 挂起的刚性布料一帧一步：只分解一次，十次迭代就把结构弹簧的伸长压在几个百分点内
+    {
+        dk::ParticleData data;
+        dk::Spring       springs;
+        const int        n    = 20;
+        const float      cell = 0.05f;
+        for (int z = 0; z <= n; ++z)
+            for (int x = 0; x <= n; ++x) data.addParticle(glm::vec3(x * cell, 0.0f, z * cell), 0.01f, z == 0);
+        const auto id = [&](int x, int z) { return static_cast<size_t>(z * (n + 1) + x); };
+        for (int z = 0; z <= n; ++z)
+            for (int x = 0; x <= n; ++x)
+            {
+                if (x < n) springs.addSpring(id(x, z), id(x + 1, z), 5000.0f, cell);
+                if (z < n) springs.addSpring(id(x, z), id(x, z + 1), 5000.0f, cell);
+                if (x < n && z < n)
+                {
+                    springs.addSpring(id(x, z), id(x + 1, z + 1), 1000.0f, cell * std::sqrt(2.0f));
+                    springs.addSpring(id(x + 1, z), id(x, z + 1), 1000.0f, cell * std::sqrt(2.0f));
+                }
+            }
+
+        dk::ParticleSystemState      state(data, springs);
+        dk::ProjectiveDynamicsSolver solver;
+        for (int step = 0; step < 120; ++step)
+        {
+            for (size_t i = 0; i < data.size(); ++i) data.force[i] = data.is_fixed[i] ? glm::vec3(0.0f) : data.mass[i] * g;
+            solver.solve(state, 1.0f / 60.0f);
+        }
+        float stretch = 0.0f;
+        for (size_t s = 0; s < springs.size(); ++s)
+        {
+            if (springs.stiffness[s] < 5000.0f) continue;
+            stretch = std::max(stretch, glm::length(data.position[springs.index_a[s]] - data.position[springs.index_b[s]]) / cell);
+        }
+        t.expect(stretch < 1.05f && solver.factorizations() == 1 && data.position[id(n / 2, n)].y < -0.5f,
+                 "projective dynamics holds a stiff hanging cloth with one factorization");
+    }
+
+    // 休眠集合不进分解的键：休眠的一根弹簧留在原地，醒着的照常下落；改了刚度并 markChanged 才重新分解
+    {
+        dk::ParticleData data;
+        dk::Spring       springs;
+        data.addParticle(glm::vec3(0.0f), 1.0f, true);
+        data.addParticle(glm::vec3(0.0f, -1.0f, 0.0f), 1.0f);
+        data.addParticle(glm::vec3(2.0f, 0.0f, 0.0f), 1.0f, true);
+        data.addParticle(glm::vec3(2.0f, -1.0f, 0.0f), 1.0f);
+        springs.addSpring(0, 1, 500.0f, 1.0f);
+        springs.addSpring(2, 3, 500.0f, 1.0f);
+
+        dk::ParticleSystemState      state(data, springs);
+        dk::ProjectiveDynamicsSolver solver;
+        bool                         still = true;
+        for (int step = 0; step < 20; ++step)
+        {
+            data.is_sleeping[3] = step % 2 == 0;
+            data.markSleepChanged();
+            data.force[1] = data.mass[1] * g;
+            data.force[3] = data.is_sleeping[3] ? glm::vec3(0.0f) : data.mass[3] * g;
+            const glm::vec3 before = data.position[3];
+            solver.solve(state, 1.0f / 60.0f);
+            still = still && (!data.is_sleeping[3] || data.position[3] == before);
+        }
+        const int before = solver.factorizations();
+        springs.stiffness[1] = 1000.0f;
+        springs.markChanged();
+        solver.solve(state, 1.0f / 60.0f);
+        t.expect(still && before == 1 && data.position[1].y < -1.0f && solver.factorizations() == 2,
+                 "projective dynamics keeps sleeping out of the factorization key and refactors on a version change");
+    }
+}
+
+void testChebyshevAcceleration(TestContext& t)
+{
+    // 压力与扩散：同一个初始散度场，加速的迭代次数只用四分之一
+    {
+        auto run = [](bool chebyshev, int iters)
+        {
+            dk::MacGrid grid(48, 48, 1, 1.0f);
+            for (int j = 10; j < 38; ++j)
+                for (int i = 10; i < 38; ++i) grid.U(i, j, 0) = 1.0f;
+            dk::StableFluidSolver::Params params;
+            params.gravity      = dk::vec3(0.0f);
+            params.viscosity    = 0.5f;
+            params.advect_dye   = false;
+            params.jacobi_iters = iters;
+            params.chebyshev    = chebyshev;
+            dk::StableFluidSolver solver(params);
+            solver.solve(grid, 1.0f);
+            return maxInteriorDivergence2D(grid);
+        };
+        const float plain = run(false, 160), accelerated = run(true, 40), before = run(false, 40);
+        t.expect(accelerated <= plain && accelerated < before,
+                 "Chebyshev Jacobi pressure/diffusion reaches the plain residual in 4x fewer iterations");
+    }
+
+    // PBD Jacobi：拉长的链条一次求解后的约束残差
+    {
+        const int   n    = 30;
+        const float rest = 0.2f;
+        auto        run  = [&](dk::PBDSolver& solver)
+        {
+            dk::ParticleData data;
+            dk::Spring       springs;
+            for (int i = 0; i < n; ++i) data.addParticle(glm::vec3(1.5f * rest * i, 0.0f, 0.0f), 0.1f, i == 0);
+            for (int i = 0; i + 1 < n; ++i) springs.addSpring(i, i + 1, 1.0f, rest);
+            dk::ParticleSystemState state(data, springs);
+            solver.solve(state, 1.0f / 60.0f);
+            float residual = 0.0f;
+            for (int i = 0; i + 1 < n; ++i)
+                residual = std::max(residual, std::fabs(glm::length(data.position[i + 1] - data.position[i]) - rest));
+            return residual;
+        };
+
+        dk::PBDSolver::Params params;
+        params.mode = dk::PBDSolver::ConstraintMode::Jacobi;
+        dk::PBDSolver plain_solver(200);
+        plain_solver.setParams(params);
+        const float plain = run(plain_solver);
+
+        params.chebyshev = true;
+        dk::PBDSolver accelerated_solver(50);
+        accelerated_solver.setParams(params);
+        run(accelerated_solver); // 第一次求解估计谱半径
+        const float rho         = accelerated_solver.spectralRadius();
+        const float accelerated = run(accelerated_solver);
+        t.expect(rho > 0.5f && rho < 1.0f && accelerated <= plain, "Chebyshev PBD Jacobi reaches the plain residual in 4x fewer iterations");
+    }
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testImplicitEulerSolver(t);
+    testProjectiveDynamicsSolver(t);
+    testChebyshevAcceleration(t);
+    return t.finish();
+}
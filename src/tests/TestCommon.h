@@ -0,0 +1,60 @@
+// tests/TestCommon.h
+// 各测试程序共用的计数器和比较函数。每个领域一个可执行文件，main 依次调用各个 testXxx(t)，最后 return t.finish()
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "physics/data/MacGrid.h"
+
+struct TestContext
+{
+    int total  = 0;
+    int failed = 0;
+
+    void expect(bool ok, const std::string& name)
+    {
+        ++total;
+        if (!ok)
+        {
+            ++failed;
+            std::cout << "[FAIL] " << name << "\n";
+        }
+        else
+        {
+            std::cout << "[PASS] " << name << "\n";
+        }
+    }
+
+    // 打印汇总，返回进程退出码
+    int finish() const
+    {
+        std::cout << "\nTotal: " << total << ", Failed: " << failed << "\n";
+        return failed == 0 ? 0 : 1;
+    }
+};
+
+inline bool nearlyEqual(float a, float b, float eps = 1e-5f)
+{
+    return std::fabs(a - b) <= eps;
+}
+
+inline bool bitwiseEqual(const dk::Field& a, const dk::Field& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+// 2D 网格（nz == 1）内部格子的最大散度
+inline float maxInteriorDivergence2D(const dk::MacGrid& g)
+{
+    float m = 0.0f;
+    for (int j = 1; j < g.ny() - 1; ++j)
+        for (int i = 1; i < g.nx() - 1; ++i)
+        {
+            const float div = (g.U(i + 1, j, 0) - g.U(i, j, 0) + g.V(i, j + 1, 0) - g.V(i, j, 0)) / g.h();
+            m = std::max(m, std::fabs(div));
+        }
+    return m;
+}
@@ -0,0 +1,49 @@
+// tests/TimelineTests.cpp
+// 多速率时间线
+#include <cmath>
+
+#include "physics/Timeline.h"
+#include "tests/TestCommon.h"
+
+namespace {
+void testMultiRateTimeline(TestContext& t)
+{
+    // 刚性系统 100 Hz、烟雾 30 Hz，每 0.1 s 同步一次；按 60 Hz 的帧推进 1 s
+    dk::Timeline timeline;
+    const int    fast = timeline.addClock(0.01), slow = timeline.addClock(1.0 / 30.0);
+    timeline.addSync(0.1);
+
+    int    steps[2] = {0, 0}, syncs = 0;
+    double last_end = 0.0;
+    bool   ordered = true, aligned = true;
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        timeline.advance(1.0 / 60.0,
+                         [&](int clock)
+                         {
+                             const double end = timeline.clockTime(clock) + timeline.clockDt(clock);
+                             ordered          = ordered && end >= last_end - 1e-9;
+                             last_end         = end;
+                             ++steps[clock];
+                         },
+                         [&](int, double time)
+                         {
+                             // 同步时两个系统都正好停在同步时刻
+                             aligned = aligned && std::fabs(timeline.clockTime(fast) - time) < 1e-9
+                                       && std::fabs(timeline.clockTime(slow) - time) < 1e-9;
+                             ordered  = ordered && time >= last_end - 1e-9;
+                             last_end = time;
+                             ++syncs;
+                         });
+    }
+    t.expect(steps[fast] == 100 && steps[slow] == 30 && syncs == 10, "multi-rate timeline runs each clock at its own rate");
+    t.expect(ordered && aligned, "multi-rate timeline interleaves steps in time order and aligns sync points");
+}
+} // namespace
+
+int main()
+{
+    TestContext t;
+    testMultiRateTimeline(t);
+    return t.finish();
+}
@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# decker_physics 模块的冒烟测试：能导入、World 能推进，网格字段和质点数组是 C++ 内存的视图。
+# 用法：python_module_smoke.py <decker_physics 所在目录>；没有 NumPy 时返回 77，CTest 记为跳过。
+import sys
+
+sys.path.insert(0, sys.argv[1])
+try:
+    import numpy  # noqa: F401  模块返回的视图需要它
+except ImportError:
+    print("[SKIP] numpy not available")
+    sys.exit(77)
+
+import decker_physics as dp
+
+failed = 0
+
+def check(cond, name):
+    global failed
+    print(("[PASS] " if cond else "[FAIL] ") + name)
+    if not cond: failed += 1
+
+
+world = dp.World(dp.WorldSettings(fixed_dt=0.01, substeps=1))
+
+cfg = dp.FluidConfig()
+cfg.nx, cfg.ny, cfg.nz = 16, 12, 8
+cfg.h = 0.05
+fluid = world.add_fluid("smoke", cfg)
+
+rope = world.add_spring_mass("rope", "pbd", 10)
+props = dp.RopeProperties()
+props.end_position = (1.0, 0.0, 0.0)
+dp.create_rope(rope, props)
+rope.add_gravity()
+
+# 网格：视图不拥有数据，按 [k, j, i] 排列；C++ 写入的值从之前取的视图里就能读到
+dye = fluid.grid.dye
+check(not dye.flags.owndata and dye.shape == (8, 12, 16), "grid.dye is a non-owning [k, j, i] view")
+dye[4, 6, 8] = 3.0
+check(fluid.grid.dye[4, 6, 8] == 3.0, "writes through grid.dye reach the C++ field")
+dp.gridinit.clear_all(fluid.grid)
+check(dye[4, 6, 8] == 0.0, "C++ writes to the grid show up in an existing view")
+
+# 质点：fixed 同时维护 inv_mass；钉住末端并从视图挪走，求解器从写入的位置出发
+particles = rope.particles
+pos = particles.position
+check(not pos.flags.owndata and pos.shape == (len(particles), 3), "particles.position is a non-owning (n, 3) view")
+mask = particles.fixed
+mask[-1] = True
+particles.fixed = mask
+check(particles.fixed[-1] and particles.inv_mass[-1] == 0.0, "fixing a particle zeroes its inverse mass")
+pos[-1] = (1.0, 0.5, 0.0)
+
+world.tick(0.05)
+check(world.time > 0.0, "World.tick advances the simulation")
+pos = rope.particles.position  # 步进之后重新取视图
+check(tuple(pos[-1]) == (1.0, 0.5, 0.0) and pos[-2, 1] > 0.0, "the solver steps from positions written through the view")
+
+mask[-1] = False
+particles.fixed = mask
+check(abs(particles.inv_mass[-1] * particles.mass[-1] - 1.0) < 1e-6, "unfixing a particle restores its inverse mass")
+
+print(f"\nFailed: {failed}")
+sys.exit(1 if failed else 0)
@@ -0,0 +1,69 @@
+#include "PhysicsStatsPanel.h"
+
+#include <algorithm>
+#include <imgui.h>
+#include <implot.h>
+
+namespace dk {
+void PhysicsStatsPanel::onGui(const PhysicsStats& stats, const std::string& title)
+{
+    const bool panel_open = ImGui::Begin(title.c_str());
+    if (panel_open)
+    {
+        bool enabled = stats.enabled();
+        if (ImGui::Checkbox("Record", &enabled)) PhysicsStats::instance().setEnabled(enabled);
+        ImGui::SameLine();
+        ImGui::SetNextItemWidth(120.0f);
+        ImGui::SliderInt("Average frames", &_average_frames, 1, static_cast<int>(PhysicsStats::kHistory));
+        ImGui::Text("frames %zu, channels %zu", stats.frameCount(), stats.channels().size());
+
+        const ImPlotAxisFlags axis_flags = ImPlotAxisFlags_AutoFit;
+        if (ImPlot::BeginPlot("##stage times", ImVec2(-1, 240)))
+        {
+            ImPlot::SetupAxes("frame", "ms", axis_flags, axis_flags);
+            ImPlot::SetupLegend(ImPlotLocation_NorthWest, ImPlotLegendFlags_Outside);
+            for (const PhysicsStats::Channel& c : stats.channels())
+            {
+                if (c.kind != PhysicsStats::Kind::Time || c.size == 0) continue;
+                // 环形缓冲未写满时从 0 开始，写满后最旧的一帧在 head
+                const int offset = c.size == PhysicsStats::kHistory ? static_cast<int>(c.head) : 0;
+                ImPlot::PlotLine(c.name.c_str(), c.history.data(), static_cast<int>(c.size), 1.0, 0.0, 0, offset);
+            }
+            ImPlot::EndPlot();
+        }
+
+        const ImGuiTableFlags table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable;
+        if (ImGui::BeginTable("##channels", 4, table_flags))
+        {
+            ImGui::TableSetupColumn("channel");
+            ImGui::TableSetupColumn("latest");
+            ImGui::TableSetupColumn("average");
+            ImGui::TableSetupColumn("max");
+            ImGui::TableHeadersRow();
+            for (const PhysicsStats::Channel& c : stats.channels())
+            {
+                const size_t frames = std::min(c.size, static_cast<size_t>(_average_frames));
+                double       total  = 0.0;
+                float        peak   = 0.0f;
+                for (size_t k = 0; k < frames; ++k)
+                {
+                    total += c.at(k);
+                    peak = std::max(peak, c.at(k));
+                }
+                const char* format = c.kind == PhysicsStats::Kind::Time ? "%.3f ms" : (c.kind == PhysicsStats::Kind::Count ? "%.0f" : "%.3g");
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(c.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text(format, c.latest());
+                ImGui::TableNextColumn();
+                ImGui::Text(format, frames ? total / static_cast<double>(frames) : 0.0);
+                ImGui::TableNextColumn();
+                ImGui::Text(format, peak);
+            }
+            ImGui::EndTable();
+        }
+    }
+    ImGui::End();
+}
+}
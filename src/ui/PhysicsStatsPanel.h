@@ -0,0 +1,17 @@
+// src/ui/PhysicsStatsPanel.h
+#pragma once
+#include <string>
+
+#include "PhysicsStats.h"
+
+namespace dk {
+// 物理统计面板：计时通道画成曲线，所有通道列出最新值、平均值与峰值
+class PhysicsStatsPanel
+{
+public:
+    void onGui(const PhysicsStats& stats, const std::string& title = "Physics Stats");
+
+private:
+    int _average_frames{60};
+};
+}